@@ -0,0 +1,131 @@
+#include "BenchClient.h"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+BenchClient::BenchClient(const string& host, int port) {
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* address = nullptr;
+    if (getaddrinfo(host.c_str(), to_string(port).c_str(), &hints, &address) != 0) {
+        throw exception();
+    }
+    sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock == -1 || connect(sock, address->ai_addr, address->ai_addrlen) == -1) {
+        freeaddrinfo(address);
+        if (sock != -1) {
+            close(sock);
+        }
+        throw exception();
+    }
+    freeaddrinfo(address);
+    // the client side sends each request in one write, it should not wait for acks
+    int on = 1;
+    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+}
+
+BenchClient::BenchClient(const string& unixSocketPath) {
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (unixSocketPath.size() >= sizeof(address.sun_path)) {
+        throw exception();
+    }
+    unixSocketPath.copy(address.sun_path, unixSocketPath.size());
+    sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock == -1 || connect(sock, (sockaddr*)&address, sizeof(address)) == -1) {
+        if (sock != -1) {
+            close(sock);
+        }
+        throw exception();
+    }
+}
+
+BenchClient::~BenchClient() {
+    close(sock);
+}
+
+void BenchClient::sendAll(const string& data) {
+    size_t totalSent = 0;
+    while (totalSent < data.size()) {
+        ssize_t sent = ::send(sock, data.data() + totalSent, data.size() - totalSent, MSG_NOSIGNAL);
+        if (sent == -1) {
+            throw exception();
+        }
+        totalSent += sent;
+    }
+}
+
+string BenchClient::receive(size_t length) {
+    string data(length, '\0');
+    size_t totalReceived = 0;
+    while (totalReceived < length) {
+        ssize_t received = ::recv(sock, &data[totalReceived], length - totalReceived, 0);
+        if (received <= 0) {
+            throw exception();
+        }
+        totalReceived += received;
+    }
+    return data;
+}
+
+void BenchClient::sendRaw(const string& data) {
+    sendAll(data);
+}
+
+string BenchClient::readFrame() {
+    return receive(stoul(receive(8)));
+}
+
+pair<ProtocolV2::FrameHeader, string> BenchClient::readFrameV2() {
+    ProtocolV2::FrameHeader header;
+    ProtocolV2::parseHeader(receive(ProtocolV2::HEADER_SIZE), header);
+    return {header, receive(header.bodyLength)};
+}
+
+string BenchClient::request(const string& command) {
+    sendAll(command + "\n");
+    // a streamed response sends data frames (no space in their first line) before the status line
+    string data;
+    while (true) {
+        string frame = readFrame();
+        if (frame.substr(0, frame.find('\n')).find(' ') != string::npos) {
+            return frame + data;
+        }
+        data += frame;
+    }
+}
+
+pair<int, string> BenchClient::requestV2(uint8_t opcode, const string& body, uint8_t flags, uint32_t requestId) {
+    ProtocolV2::FrameHeader header;
+    header.opcode = opcode;
+    header.flags = flags;
+    header.requestId = requestId;
+    header.bodyLength = body.size();
+    sendAll(ProtocolV2::encodeHeader(header) + body);
+    string data;
+    while (true) {
+        pair<ProtocolV2::FrameHeader, string> frame = readFrameV2();
+        data += frame.second;
+        if (!(frame.first.flags & ProtocolV2::FLAG_MORE)) {
+            return {frame.first.status, data};
+        }
+    }
+}
+
+double BenchClient::percentile(vector<double> samples, double p) {
+    if (samples.empty()) {
+        return 0;
+    }
+    size_t index = min(samples.size() - 1, static_cast<size_t>(p / 100.0 * samples.size()));
+    nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
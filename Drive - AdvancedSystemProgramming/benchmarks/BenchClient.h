@@ -0,0 +1,49 @@
+// Minimal blocking client of the drive server, shared by the benchmarks
+#ifndef BENCH_CLIENT_H
+#define BENCH_CLIENT_H
+
+#include "ProtocolV2.h"
+#include <string>
+#include <vector>
+#include <utility>
+
+using namespace std;
+
+class BenchClient {
+private:
+    int sock;
+
+    void sendAll(const string& data);
+    string receive(size_t length);
+
+public:
+    // connects to the server, throws exception if it can not
+    BenchClient(const string& host, int port);
+
+    // connects to the unix domain socket of the server
+    explicit BenchClient(const string& unixSocketPath);
+    ~BenchClient();
+
+    BenchClient(const BenchClient&) = delete;
+    BenchClient& operator=(const BenchClient&) = delete;
+
+    // sends a text command (newline added) and returns the legacy response (status line and data)
+    string request(const string& command);
+
+    // sends a v2 request and returns the status and body of its response (data frames are joined)
+    pair<int, string> requestV2(uint8_t opcode, const string& body, uint8_t flags = 0, uint32_t requestId = 0);
+
+    // sends bytes as they are (e.g. many pipelined requests)
+    void sendRaw(const string& data);
+
+    // reads one legacy frame
+    string readFrame();
+
+    // reads one v2 frame
+    pair<ProtocolV2::FrameHeader, string> readFrameV2();
+
+    // the p-th percentile (0-100) of the samples
+    static double percentile(vector<double> samples, double p);
+};
+
+#endif // BENCH_CLIENT_H
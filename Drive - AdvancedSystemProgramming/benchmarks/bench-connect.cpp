@@ -0,0 +1,106 @@
+/*
+* connection rate of a single accept loop against SO_REUSEPORT acceptor threads.
+* starts the server in this process (storage in a temporary folder), then client threads open connections
+* as fast as they can - each one sends a single GET, reads the response and closes (like reconnecting mobile clients).
+* prints the connections per second and the p50/p99 time from connect to response in microseconds.
+* usage: ./benchConnect [connections per mode] [client threads] [acceptor threads]
+*/
+#include "BenchClient.h"
+#include "Server.h"
+#include "FolderManager.h"
+#include "ThreadPoolExecutor.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// runs a server on the port in the background (it never returns, the process exit ends it)
+static void startServer(int port, int acceptorThreads, IdataBaseHandler* database) {
+    // connections are short, a few workers are enough to keep up with them
+    IExecutor* executor = new ThreadPoolExecutor(8);
+    thread([port, acceptorThreads, database, executor]() {
+        Server server(port, database, executor, chrono::milliseconds(0), nullptr, TcpPolicy::NO_DELAY, acceptorThreads);
+        server.run();
+    }).detach();
+}
+
+static void waitUntilListening(int port) {
+    for (int attempt = 0; attempt < 100; attempt++) {
+        try {
+            BenchClient client("127.0.0.1", port);
+            return;
+        } catch (...) {
+            this_thread::sleep_for(chrono::milliseconds(10));
+        }
+    }
+    throw exception();
+}
+
+int main(int argc, char* argv[]) {
+    size_t connections = argc > 1 ? stoul(argv[1]) : 4000;
+    size_t clientThreads = argc > 2 ? stoul(argv[2]) : 8;
+    int acceptors = argc > 3 ? stoi(argv[3]) : max(2u, thread::hardware_concurrency());
+
+    filesystem::path storage = filesystem::temp_directory_path() / ("benchConnect-" + to_string(getpid()));
+    filesystem::create_directories(storage / "names");
+    setenv("DRIVE_STORAGE", storage.c_str(), 1);
+    FolderManager database(storage, storage / "names");
+
+    const pair<string, int> modes[] = {{"single accept loop", 1}, {to_string(acceptors) + " reuseport acceptors", acceptors}};
+    int port = 9900 + getpid() % 500;
+    for (const auto& mode : modes) {
+        startServer(port, mode.second, &database);
+        waitUntilListening(port);
+        {
+            BenchClient client("127.0.0.1", port);
+            client.request("post connect.txt hello");
+        }
+
+        atomic<size_t> next(0);
+        atomic<size_t> failed(0);
+        mutex samplesLock;
+        vector<double> samples;
+        auto start = chrono::steady_clock::now();
+        vector<thread> clients;
+        for (size_t t = 0; t < clientThreads; t++) {
+            clients.emplace_back([&]() {
+                vector<double> mine;
+                while (next++ < connections) {
+                    auto connectStart = chrono::steady_clock::now();
+                    try {
+                        BenchClient client("127.0.0.1", port);
+                        client.request("get connect.txt");
+                    } catch (...) {
+                        failed++;
+                        continue;
+                    }
+                    mine.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - connectStart).count());
+                }
+                lock_guard<mutex> lock(samplesLock);
+                samples.insert(samples.end(), mine.begin(), mine.end());
+            });
+        }
+        for (thread& client : clients) {
+            client.join();
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        cout << mode.first << " (" << connections << " connections from " << clientThreads << " threads)" << endl;
+        cout << "  " << (size_t)(samples.size() / seconds) << " connections/s, p50 " << BenchClient::percentile(samples, 50)
+             << "us, p99 " << BenchClient::percentile(samples, 99) << "us";
+        if (failed > 0) {
+            cout << ", " << failed << " failed";
+        }
+        cout << endl;
+        port++;
+    }
+    filesystem::remove_all(storage);
+    return 0;
+}
@@ -0,0 +1,73 @@
+/*
+* cost of setting up and tearing down what a connection is served with, without the sockets themselves:
+* a new CSIO and an App with its own commands and compressors for every connection (the old way) against
+* a context taken from a ConnectionContextPool that shares one CommandRegistry.
+* client threads "connect" and "disconnect" as fast as they can, so the allocator contention of many
+* short connections shows up too. prints the connections per second of each mode.
+* for the whole connection (accept, request, close) see benchConnect.
+* usage: ./benchContext [connections per thread] [threads]
+*/
+#include "App.h"
+#include "CSIO.h"
+#include "CommandWrapper.h"
+#include "CommandRegistry.h"
+#include "ConnectionContextPool.h"
+#include "FolderManager.h"
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+static double connectionsPerSecond(size_t perThread, size_t threads, const function<void()>& connection) {
+    auto start = chrono::steady_clock::now();
+    vector<thread> clients;
+    for (size_t t = 0; t < threads; t++) {
+        clients.emplace_back([perThread, &connection]() {
+            for (size_t i = 0; i < perThread; i++) {
+                connection();
+            }
+        });
+    }
+    for (thread& client : clients) {
+        client.join();
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return perThread * threads / seconds;
+}
+
+int main(int argc, char* argv[]) {
+    size_t perThread = argc > 1 ? stoul(argv[1]) : 100000;
+    size_t threads = argc > 2 ? stoul(argv[2]) : 8;
+
+    filesystem::path storage = filesystem::temp_directory_path() / ("benchContext-" + to_string(getpid()));
+    filesystem::create_directories(storage / "names");
+    FolderManager database(storage, storage / "names");
+    CommandWrapper commandWrapper;
+    CommandRegistry registry(&database);
+    ConnectionContextPool pool(&registry, &commandWrapper, chrono::milliseconds(0), nullptr, nullptr);
+
+    // no socket: the csio of the connection is never read, only made and reset
+    double perConnection = connectionsPerSecond(perThread, threads, [&database, &commandWrapper]() {
+        CSIO* csio = new CSIO(-1, &commandWrapper);
+        App* app = new App(&database, csio, csio, chrono::milliseconds(0));
+        delete app;
+        delete csio;
+    });
+    double pooled = connectionsPerSecond(perThread, threads, [&pool]() {
+        ConnectionContextPool::Context context = pool.acquire(-1);
+    });
+
+    cout << perThread * threads << " connections from " << threads << " threads" << endl;
+    cout << "  new App and commands per connection: " << (size_t)perConnection << " connections/s" << endl;
+    cout << "  pooled contexts, shared registry:    " << (size_t)pooled << " connections/s" << endl;
+    cout << "  " << pool.createdCount() << " contexts made for the pooled run" << endl;
+    filesystem::remove_all(storage);
+    return 0;
+}
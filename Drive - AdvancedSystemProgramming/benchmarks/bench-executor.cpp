@@ -0,0 +1,104 @@
+/*
+* tasks/s and queueing latency of the request executors: the single queue ThreadPoolExecutor against the
+* WorkStealingExecutor, for several worker counts.
+* producer threads (like the connections of the server) add short tasks as fast as they can. every task
+* does a little work (like a small GET) and records how long it waited from execute() until it started.
+* prints tasks/s and the p50/p99/p99.9 wait in microseconds.
+* usage: ./benchExecutor [tasks per run] [producers] [work per task in ns]
+*/
+#include "ThreadPoolExecutor.h"
+#include "WorkStealingExecutor.h"
+#include "IRunnable.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// a short task, it spins for the work time (sleeping would hide the cost of the queue)
+class BenchTask : public IRunnable {
+public:
+    chrono::steady_clock::time_point submitted;
+    double waitedMicros = 0;
+    chrono::nanoseconds work{0};
+    atomic<size_t>* remaining = nullptr;
+
+    void run() override {
+        auto start = chrono::steady_clock::now();
+        waitedMicros = chrono::duration<double, micro>(start - submitted).count();
+        while (chrono::steady_clock::now() - start < work) {
+        }
+        remaining->fetch_sub(1, memory_order_release);
+    }
+};
+
+static double percentile(vector<double>& samples, double p) {
+    size_t index = min(samples.size() - 1, static_cast<size_t>(p / 100.0 * samples.size()));
+    nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+static void runOnce(const string& name, IExecutor& executor, size_t taskCount, size_t producers, chrono::nanoseconds work) {
+    vector<BenchTask> tasks(taskCount);
+    atomic<size_t> remaining(taskCount);
+    for (BenchTask& task : tasks) {
+        task.work = work;
+        task.remaining = &remaining;
+    }
+
+    auto start = chrono::steady_clock::now();
+    vector<thread> threads;
+    for (size_t p = 0; p < producers; p++) {
+        threads.emplace_back([&tasks, &executor, p, producers]() {
+            for (size_t i = p; i < tasks.size(); i += producers) {
+                tasks[i].submitted = chrono::steady_clock::now();
+                executor.execute(tasks[i]);
+            }
+        });
+    }
+    for (thread& producer : threads) {
+        producer.join();
+    }
+    while (remaining.load(memory_order_acquire) > 0) {
+        this_thread::yield();
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    vector<double> waits;
+    waits.reserve(taskCount);
+    for (BenchTask& task : tasks) {
+        waits.push_back(task.waitedMicros);
+    }
+    cout << "  " << name << ": " << (size_t)(taskCount / seconds) << " tasks/s, wait p50 " << percentile(waits, 50)
+         << "us, p99 " << percentile(waits, 99) << "us, p99.9 " << percentile(waits, 99.9) << "us" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    size_t taskCount = argc > 1 ? stoul(argv[1]) : 200000;
+    size_t producers = argc > 2 ? stoul(argv[2]) : 4;
+    chrono::nanoseconds work(argc > 3 ? stol(argv[3]) : 500);
+
+    size_t hardware = max(1u, thread::hardware_concurrency());
+    vector<size_t> threadCounts = {1, 2, 4};
+    for (size_t count = 8; count <= hardware * 2; count *= 2) {
+        threadCounts.push_back(count);
+    }
+    for (size_t threads : threadCounts) {
+        cout << threads << " workers (" << taskCount << " tasks of " << work.count() << "ns from " << producers
+             << " producers)" << endl;
+        {
+            ThreadPoolExecutor executor(threads);
+            runOnce("single queue ", executor, taskCount, producers, work);
+        }
+        {
+            WorkStealingExecutor executor(threads);
+            runOnce("work stealing", executor, taskCount, producers, work);
+        }
+    }
+    return 0;
+}
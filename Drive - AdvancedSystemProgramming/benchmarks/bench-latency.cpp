@@ -0,0 +1,93 @@
+/*
+* latency of small GET requests, for every TcpPolicy.
+* starts the server in this process (storage in a temporary folder) and sends one request at a time
+* from a single connection, so every sample is a full round trip. prints p50/p99 in microseconds.
+* usage: ./benchLatency [requests per policy] [content size]
+*/
+#include "BenchClient.h"
+#include "Server.h"
+#include "FolderManager.h"
+#include "ThreadPoolExecutor.h"
+#include "TcpPolicy.h"
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// runs a server on the port in the background (it never returns, the process exit ends it)
+static void startServer(int port, int tcpPolicy, IdataBaseHandler* database) {
+    IExecutor* executor = new ThreadPoolExecutor(2);
+    thread([port, tcpPolicy, database, executor]() {
+        Server server(port, database, executor, chrono::milliseconds(0), nullptr, tcpPolicy);
+        server.run();
+    }).detach();
+}
+
+// connects once the server listens
+static BenchClient* connectWhenReady(int port) {
+    for (int attempt = 0; attempt < 100; attempt++) {
+        try {
+            return new BenchClient("127.0.0.1", port);
+        } catch (...) {
+            this_thread::sleep_for(chrono::milliseconds(10));
+        }
+    }
+    throw exception();
+}
+
+static void report(const string& name, const vector<double>& samples) {
+    cout << "  " << name << ": p50 " << BenchClient::percentile(samples, 50)
+         << "us, p99 " << BenchClient::percentile(samples, 99) << "us" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    size_t requests = argc > 1 ? stoul(argv[1]) : 20000;
+    size_t contentSize = argc > 2 ? stoul(argv[2]) : 64;
+
+    filesystem::path storage = filesystem::temp_directory_path() / ("benchLatency-" + to_string(getpid()));
+    filesystem::create_directories(storage / "names");
+    setenv("DRIVE_STORAGE", storage.c_str(), 1);
+    FolderManager database(storage, storage / "names");
+
+    string content;
+    for (size_t i = 0; i < contentSize; i++) {
+        content += (char)('a' + i % 26);
+    }
+
+    const pair<string, int> policies[] = {{"nagle", TcpPolicy::NAGLE}, {"nodelay", TcpPolicy::NO_DELAY}, {"cork", TcpPolicy::CORK}};
+    int port = 9400 + getpid() % 500;
+    for (const auto& policy : policies) {
+        startServer(port, policy.second, &database);
+        // the protocol of a connection is set by its first request, so each protocol gets its own connection
+        BenchClient* client = connectWhenReady(port);
+        BenchClient* clientV2 = connectWhenReady(port);
+        client->request("post latency.txt " + content);
+
+        vector<double> legacy;
+        vector<double> v2;
+        for (size_t i = 0; i < requests + requests / 10; i++) {
+            auto start = chrono::steady_clock::now();
+            client->request("get latency.txt");
+            auto middle = chrono::steady_clock::now();
+            clientV2->requestV2(ProtocolV2::OPCODE_GET, "latency.txt");
+            auto end = chrono::steady_clock::now();
+            if (i >= requests / 10) { // the first requests are a warm up
+                legacy.push_back(chrono::duration<double, micro>(middle - start).count());
+                v2.push_back(chrono::duration<double, micro>(end - middle).count());
+            }
+        }
+        cout << policy.first << " (" << requests << " GETs of " << contentSize << " bytes)" << endl;
+        report("legacy", legacy);
+        report("v2", v2);
+        delete client;
+        delete clientV2;
+        port++;
+    }
+    filesystem::remove_all(storage);
+    return 0;
+}
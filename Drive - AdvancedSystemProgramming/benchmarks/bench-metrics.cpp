@@ -0,0 +1,93 @@
+/*
+* the cost of TaskMetrics: GET commands (on a FolderManager in a temporary folder, no sockets) run on a
+* ThreadPoolExecutor with and without measureTasks, in turns, several rounds each.
+* prints the median GETs/s of each and the overhead of measuring, then the histograms the metrics kept.
+* on a machine with few cores the rounds are noisy, use many of them.
+* usage: ./benchMetrics [GETs per round] [rounds] [workers] [content size]
+*/
+#include "ThreadPoolExecutor.h"
+#include "FolderManager.h"
+#include "RLEcompressor.h"
+#include "AddCommand.h"
+#include "GetCommand.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+// GETs/s of one round, the producer is the calling thread (like a connection posting its requests)
+static double runRound(ThreadPoolExecutor& executor, const GetCommand& get, size_t requests) {
+    atomic<size_t> remaining(requests);
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < requests; i++) {
+        executor.post(Task([&get, &remaining]() {
+            get.execute("metrics.txt");
+            remaining.fetch_sub(1, memory_order_release);
+        }));
+    }
+    while (remaining.load(memory_order_acquire) > 0) {
+        this_thread::yield();
+    }
+    return requests / chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+static double median(vector<double> samples) {
+    nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+    return samples[samples.size() / 2];
+}
+
+static void printHistogram(const string& name, const HistogramSnapshot& histogram) {
+    cout << "  " << name << ": p50 " << histogram.percentile(50) / 1000.0 << "us, p99 "
+         << histogram.percentile(99) / 1000.0 << "us, p99.9 " << histogram.percentile(99.9) / 1000.0
+         << "us, max " << histogram.max / 1000.0 << "us" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    size_t requests = argc > 1 ? stoul(argv[1]) : 20000;
+    size_t rounds = argc > 2 ? stoul(argv[2]) : 15;
+    size_t workers = argc > 3 ? stoul(argv[3]) : 2;
+    size_t contentSize = argc > 4 ? stoul(argv[4]) : 64;
+
+    filesystem::path storage = filesystem::temp_directory_path() / ("benchMetrics-" + to_string(getpid()));
+    filesystem::create_directories(storage / "names");
+    setenv("DRIVE_STORAGE", storage.c_str(), 1);
+    FolderManager database(storage, storage / "names");
+    RLEcompressor compressor;
+    string content;
+    for (size_t i = 0; i < contentSize; i++) {
+        content += (char)('a' + i % 26);
+    }
+    AddCommand(&database, &compressor).execute("metrics.txt " + content);
+    GetCommand get(&database, &compressor);
+
+    ThreadPoolExecutor plain(workers);
+    ThreadPoolExecutor measured(workers, nullptr, nullptr, true);
+    runRound(plain, get, requests / 10); // warm up the file cache
+    vector<double> plainRounds;
+    vector<double> measuredRounds;
+    for (size_t round = 0; round < rounds; round++) {
+        plainRounds.push_back(runRound(plain, get, requests));
+        measuredRounds.push_back(runRound(measured, get, requests));
+    }
+    double medianPlain = median(plainRounds);
+    double medianMeasured = median(measuredRounds);
+
+    cout << requests << " GETs of " << contentSize << " bytes on " << workers << " workers, median of " << rounds
+         << " rounds" << endl;
+    cout << "  without metrics: " << (size_t)medianPlain << " GETs/s" << endl;
+    cout << "  with metrics:    " << (size_t)medianMeasured << " GETs/s" << endl;
+    cout << "  overhead: " << (medianPlain - medianMeasured) / medianPlain * 100 << "%" << endl;
+    printHistogram("queue wait", measured.metrics()->queueWait());
+    printHistogram("run time  ", measured.metrics()->runTime());
+
+    filesystem::remove_all(storage);
+    return 0;
+}
@@ -0,0 +1,73 @@
+/*
+* the cost of reading memory of another NUMA node, and what pinning saves.
+* a buffer is first touched (so placed) by a thread pinned to node 0, then read over and over by:
+* - a reader pinned to node 0 (local), and to each other node (remote)
+* - an unpinned reader that the kernel may move anywhere (what unpinned workers get)
+* prints GB/s of each. on a machine with one node only the local and unpinned rows are printed.
+* usage: ./benchNuma [buffer size in MB] [rounds]
+*/
+#include "ThreadPlacement.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+// reads the whole buffer rounds times (a sum, so the reads are not optimized away), returns GB/s
+static double readBandwidth(const uint64_t* buffer, size_t words, size_t rounds) {
+    volatile uint64_t sink = 0;
+    auto start = chrono::steady_clock::now();
+    for (size_t round = 0; round < rounds; round++) {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < words; i++) {
+            sum += buffer[i];
+        }
+        sink = sink + sum;
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return words * sizeof(uint64_t) * rounds / seconds / 1e9;
+}
+
+// runs the reader on a thread pinned to the node (-1 - not pinned)
+static double readFrom(const ThreadPlacement& placement, int node, const uint64_t* buffer, size_t words, size_t rounds) {
+    double bandwidth = 0;
+    thread reader([&]() {
+        if (node >= 0) {
+            placement.placeOnNode(node);
+        }
+        bandwidth = readBandwidth(buffer, words, rounds);
+    });
+    reader.join();
+    return bandwidth;
+}
+
+int main(int argc, char* argv[]) {
+    size_t megabytes = argc > 1 ? stoul(argv[1]) : 256;
+    size_t rounds = argc > 2 ? stoul(argv[2]) : 10;
+    size_t words = megabytes * 1024 * 1024 / sizeof(uint64_t);
+
+    ThreadPlacement placement(ThreadPlacement::NODES);
+    const CpuTopology& topology = placement.getTopology();
+    cout << "nodes: " << topology.nodeCount() << ", CPUs: " << topology.allCpus().size() << endl;
+
+    // the pages are placed on the node of the thread that touches them first
+    unique_ptr<uint64_t[]> buffer(new uint64_t[words]);
+    thread toucher([&]() {
+        placement.placeOnNode(0);
+        for (size_t i = 0; i < words; i++) {
+            buffer[i] = i;
+        }
+    });
+    toucher.join();
+
+    cout << "reader              GB/s" << endl;
+    cout << "pinned node 0 (local)  " << readFrom(placement, 0, buffer.get(), words, rounds) << endl;
+    for (size_t node = 1; node < topology.nodeCount(); node++) {
+        cout << "pinned node " << node << " (remote) " << readFrom(placement, node, buffer.get(), words, rounds) << endl;
+    }
+    cout << "unpinned               " << readFrom(placement, -1, buffer.get(), words, rounds) << endl;
+    return 0;
+}
@@ -0,0 +1,56 @@
+/*
+* items/s through the task queues alone: the mutex SafeQueue against the lock free MPMCQueue,
+* for 1/1, 2/2, 4/4 and 8/8 producers/consumers (or the counts given on the command line).
+* the items are not run - this measures only the contention on the queue itself.
+* usage: ./benchQueue [items per run] [capacity of the MPMCQueue]
+*/
+#include "SafeQueue.h"
+#include "MPMCQueue.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+static double itemsPerSecond(ITaskQueue& queue, size_t itemCount, size_t threads) {
+    size_t perThread = itemCount / threads;
+
+    auto start = chrono::steady_clock::now();
+    vector<thread> workers;
+    for (size_t t = 0; t < threads; t++) {
+        workers.emplace_back([&queue, perThread]() {
+            for (size_t i = 0; i < perThread; i++) {
+                queue.enqueue(Task([]() {})); // a small task, stored inside the Task (no allocation)
+            }
+        });
+        workers.emplace_back([&queue, perThread]() {
+            Task task;
+            for (size_t i = 0; i < perThread; i++) {
+                queue.dequeue(task);
+            }
+        });
+    }
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return perThread * threads / seconds;
+}
+
+int main(int argc, char* argv[]) {
+    size_t itemCount = argc > 1 ? stoul(argv[1]) : 2000000;
+    size_t capacity = argc > 2 ? stoul(argv[2]) : MPMCQueue::DEFAULT_CAPACITY;
+
+    cout << "producers/consumers  SafeQueue items/s  MPMCQueue items/s" << endl;
+    for (size_t threads : {1, 2, 4, 8}) {
+        SafeQueue safeQueue;
+        MPMCQueue lockFreeQueue(capacity);
+        double safe = itemsPerSecond(safeQueue, itemCount, threads);
+        double lockFree = itemsPerSecond(lockFreeQueue, itemCount, threads);
+        cout << threads << "/" << threads << "  " << static_cast<size_t>(safe) << "  "
+             << static_cast<size_t>(lockFree) << endl;
+    }
+    return 0;
+}
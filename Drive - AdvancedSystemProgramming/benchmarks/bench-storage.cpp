@@ -0,0 +1,96 @@
+/*
+* the storage of the coroutines with blocking calls (AsyncStorage - on a pool of a few threads) and through an
+* io_uring (UringStorage): many coroutines at once each insert a file, read it back and delete it, over a
+* FolderManager in a folder of the disk to measure. prints the operations/s of each.
+* UringStorage also flushes every file it writes to the disk (fsync) and FolderManager does not, so on a real disk
+* the blocking storage gets the easier work - and is still capped by its threads while the ring is not.
+* usage: ./benchStorage [folder] [files per round] [coroutines at once] [blocking threads] [content size]
+*/
+#include "ThreadPoolExecutor.h"
+#include "FolderManager.h"
+#include "AsyncStorage.h"
+#include "UringStorage.h"
+#include "IoUring.h"
+#include "CoroutineScheduler.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+using namespace std;
+
+// one coroutine: insert, read back and delete files first, first + step, ... below count
+static AsyncTask<void> cycleFiles(AsyncStorage& storage, filesystem::path folder, size_t first, size_t step,
+                                  size_t count, string content, atomic<size_t>& failures, atomic<size_t>& finished) {
+    for (size_t i = first; i < count; i += step) {
+        string name = "bench-" + to_string(i);
+        bool ok = co_await storage.insertFile(name, content, folder);
+        ok = ok && (co_await storage.getContent(name)) == content;
+        ok = ok && co_await storage.deleteFile(name);
+        if (!ok) {
+            failures++;
+        }
+    }
+    finished++;
+}
+
+// operations/s of one round (3 for every file)
+static double runRound(AsyncStorage& storage, IExecutor& requests, const filesystem::path& folder, size_t files,
+                       size_t coroutines, const string& content) {
+    atomic<size_t> failures(0);
+    atomic<size_t> finished(0);
+    CoroutineScheduler scheduler(&requests);
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < coroutines; i++) {
+        scheduler.spawn(cycleFiles(storage, folder, i, coroutines, files, content, failures, finished));
+    }
+    while (finished < coroutines) {
+        this_thread::sleep_for(chrono::microseconds(100));
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    if (failures > 0) {
+        cout << "  " << failures << " files failed" << endl;
+    }
+    return files * 3 / seconds;
+}
+
+int main(int argc, char* argv[]) {
+    filesystem::path root = argc > 1 ? filesystem::path(argv[1]) : filesystem::temp_directory_path();
+    size_t files = argc > 2 ? stoul(argv[2]) : 2000;
+    size_t coroutines = argc > 3 ? stoul(argv[3]) : 64;
+    size_t blockingThreads = argc > 4 ? stoul(argv[4]) : 2;
+    size_t contentSize = argc > 5 ? stoul(argv[5]) : 4096;
+
+    filesystem::path folder = root / ("benchStorage-" + to_string(getpid()));
+    filesystem::create_directories(folder / "names");
+    FolderManager database(folder, folder / "names");
+    string content(contentSize, 'x');
+
+    ThreadPoolExecutor requests(2);
+    ThreadPoolExecutor blocking(blockingThreads);
+    AsyncStorage blockingStorage(&database, &blocking, &requests);
+    cout << files << " files, " << coroutines << " coroutines at once, " << contentSize << " bytes each" << endl;
+    cout << "blocking (" << blockingThreads << " threads): "
+         << runRound(blockingStorage, requests, folder, files, coroutines, content) << " operations/s" << endl;
+
+    unique_ptr<IoUring> ring;
+    try {
+        ring = make_unique<IoUring>(&requests);
+    } catch (...) {
+        cout << "io_uring is not available" << endl;
+    }
+    if (ring) {
+        UringStorage uringStorage(&database, ring.get(), &blocking, &requests);
+        cout << "io_uring: " << runRound(uringStorage, requests, folder, files, coroutines, content)
+             << " operations/s (" << ring->operationCount() << " operations in " << ring->submitCount()
+             << " submissions)" << endl;
+    }
+    ring.reset();
+    filesystem::remove_all(folder);
+    return 0;
+}
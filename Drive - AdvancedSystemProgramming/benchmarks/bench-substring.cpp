@@ -0,0 +1,92 @@
+/*
+* microbenchmark for the content search kernel.
+* compares SubstringSearch against std::string::find and std::search with Boyer-Moore-Horspool.
+* usage: ./benchSubstring [corpus files...]
+* without files a synthetic text corpus is generated.
+*/
+#include "SubstringSearch.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// builds ~32MB of lowercase words separated by spaces
+static string syntheticCorpus() {
+    mt19937 random(7);
+    uniform_int_distribution<int> letter('a', 'z');
+    uniform_int_distribution<int> wordLength(2, 10);
+    string corpus;
+    corpus.reserve(32 << 20);
+    while (corpus.size() < (32u << 20)) {
+        int length = wordLength(random);
+        for (int i = 0; i < length; i++) corpus += (char)letter(random);
+        corpus += ' ';
+    }
+    return corpus;
+}
+
+static string readFile(const string& path) {
+    ifstream in(path, ios::binary);
+    stringstream buffer;
+    buffer << in.rdbuf();
+    return buffer.str();
+}
+
+// runs the search until at least 200ms passed and returns the throughput in MB/s
+static double measure(const function<size_t()>& search, size_t corpusSize, size_t& result) {
+    using clock = chrono::steady_clock;
+    size_t rounds = 0;
+    clock::time_point start = clock::now();
+    clock::duration elapsed;
+    do {
+        result = search();
+        rounds++;
+        elapsed = clock::now() - start;
+    } while (elapsed < chrono::milliseconds(200));
+    double seconds = chrono::duration<double>(elapsed).count();
+    return (double)corpusSize * rounds / seconds / (1 << 20);
+}
+
+int main(int argc, char* argv[]) {
+    vector<pair<string, string>> corpora;
+    for (int i = 1; i < argc; i++) {
+        corpora.push_back({argv[i], readFile(argv[i])});
+    }
+    if (corpora.empty()) {
+        corpora.push_back({"synthetic", syntheticCorpus()});
+    }
+
+    cout << "kernel: " << SubstringSearch::implementationName() << endl;
+    for (const auto& [name, corpus] : corpora) {
+        // needles that are not in the corpus force a full scan, which is the common case for a search
+        for (string needle : vector<string>{"q#", "zzqx#", "notinthecorpus#", string(40, 'e') + "#"}) {
+            size_t expected = corpus.find(needle);
+            boyer_moore_horspool_searcher searcher(needle.begin(), needle.end());
+            vector<pair<string, function<size_t()>>> kernels = {
+                {"std::string::find", [&]() { return corpus.find(needle); }},
+                {"std::search BMH", [&]() {
+                    auto found = search(corpus.begin(), corpus.end(), searcher);
+                    return found == corpus.end() ? string::npos : (size_t)(found - corpus.begin());
+                }},
+                {"SubstringSearch", [&]() { return SubstringSearch::find(corpus, needle); }},
+                {"SubstringSearch scalar", [&]() { return SubstringSearch::findScalar(corpus, needle); }},
+            };
+            cout << name << " (" << corpus.size() / (1 << 20) << "MB), needle length " << needle.size() << endl;
+            for (const auto& [kernelName, kernel] : kernels) {
+                size_t result;
+                double throughput = measure(kernel, corpus.size(), result);
+                cout << "  " << kernelName << ": " << (size_t)throughput << " MB/s"
+                     << (result == expected ? "" : "  (WRONG RESULT)") << endl;
+            }
+        }
+    }
+    return 0;
+}
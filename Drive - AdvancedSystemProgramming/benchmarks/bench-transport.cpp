@@ -0,0 +1,93 @@
+/*
+* throughput of GET requests over loopback TCP against a unix domain socket.
+* starts the server in this process (storage in a temporary folder) listening on both, then a single connection
+* per transport sends GETs back to back, for a small and a large file. prints requests/s and MB/s.
+* usage: ./benchTransport [seconds per run] [large file size]
+*/
+#include "BenchClient.h"
+#include "Server.h"
+#include "FolderManager.h"
+#include "ThreadPoolExecutor.h"
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+// runs a server on the port and the unix socket in the background (it never returns, the process exit ends it)
+static void startServer(int port, const string& unixSocketPath, IdataBaseHandler* database) {
+    IExecutor* executor = new ThreadPoolExecutor(4);
+    thread([port, unixSocketPath, database, executor]() {
+        Server server(port, database, executor);
+        server.listenOnUnixSocket(unixSocketPath);
+        server.run();
+    }).detach();
+}
+
+// connects to the port (unixSocketPath empty) or to the unix socket, once the server listens
+static BenchClient* connectWhenReady(int port, const string& unixSocketPath) {
+    for (int attempt = 0; attempt < 100; attempt++) {
+        try {
+            return unixSocketPath.empty() ? new BenchClient("127.0.0.1", port) : new BenchClient(unixSocketPath);
+        } catch (...) {
+            this_thread::sleep_for(chrono::milliseconds(10));
+        }
+    }
+    throw exception();
+}
+
+// GETs the file for the given time, returns requests/s and the bytes of one response
+static pair<double, size_t> measure(BenchClient& client, const string& fileName, double seconds) {
+    size_t responseSize = client.request("get " + fileName).size(); // warm up
+    size_t requests = 0;
+    auto start = chrono::steady_clock::now();
+    chrono::duration<double> elapsed(0);
+    while (elapsed.count() < seconds) {
+        client.request("get " + fileName);
+        requests++;
+        elapsed = chrono::steady_clock::now() - start;
+    }
+    return {requests / elapsed.count(), responseSize};
+}
+
+int main(int argc, char* argv[]) {
+    double seconds = argc > 1 ? stod(argv[1]) : 2;
+    size_t largeSize = argc > 2 ? stoul(argv[2]) : 1 << 20;
+
+    filesystem::path storage = filesystem::temp_directory_path() / ("benchTransport-" + to_string(getpid()));
+    filesystem::create_directories(storage / "names");
+    setenv("DRIVE_STORAGE", storage.c_str(), 1);
+    FolderManager database(storage, storage / "names");
+
+    int port = 10400 + getpid() % 500;
+    string unixSocketPath = (storage / "drive.sock").string();
+    startServer(port, unixSocketPath, &database);
+
+    // files without runs, so their compressed size is about the same as the content
+    string large;
+    for (size_t i = 0; i < largeSize; i++) {
+        large += (char)('a' + i % 26);
+    }
+    string small = large.substr(0, 64);
+    BenchClient* setup = connectWhenReady(port, "");
+    setup->request("post small.txt " + small);
+    setup->request("post large.txt " + large);
+    delete setup;
+
+    const pair<string, string> transports[] = {{"tcp loopback", ""}, {"unix socket", unixSocketPath}};
+    const pair<string, string> files[] = {{"small", "small.txt"}, {"large", "large.txt"}};
+    for (const auto& file : files) {
+        for (const auto& transport : transports) {
+            BenchClient* client = connectWhenReady(port, transport.second);
+            pair<double, size_t> result = measure(*client, file.second, seconds);
+            cout << file.first << " GET (" << result.second << " bytes) over " << transport.first << ": "
+                 << (size_t)result.first << " requests/s, " << result.first * result.second / (1 << 20) << " MB/s" << endl;
+            delete client;
+        }
+    }
+    filesystem::remove_all(storage);
+    return 0;
+}
@@ -1,20 +1,24 @@
 #include "App.h"
 
-
-App::App(IdataBaseHandler* dbHandler, Ioutput* outputHandler, IInput* inputHandler)
-: database(dbHandler), output(outputHandler), input(inputHandler)
+App::App(IdataBaseHandler* dbHandler, Ioutput* outputHandler, IInput* inputHandler, chrono::milliseconds requestTimeBudget,
+         IExecutor* requestExecutor, AdmissionController* admission)
+: App(static_cast<const CommandRegistry*>(nullptr), outputHandler, inputHandler, requestTimeBudget, requestExecutor, admission)
 {
-    // Initialize compressors map
-    compressors["RLE"] = new RLEcompressor();
+    ownRegistry.reset(new CommandRegistry(dbHandler, requestExecutor, admission));
+    registry = ownRegistry.get();
+}
 
-    // Initialize commands map
-    commands["post"] = new AddCommand(database, compressors["RLE"]);
-    commands["get"] = new GetCommand(database, compressors["RLE"]);
-    commands["search"] = new SearchCommand(database, compressors["RLE"]);
-    commands["delete"] = new DeleteCommand(database);
+App::App(const CommandRegistry* registry, Ioutput* outputHandler, IInput* inputHandler, chrono::milliseconds requestTimeBudget,
+         IExecutor* requestExecutor, AdmissionController* admission)
+: registry(registry), input(inputHandler), output(outputHandler), requestTimeBudget(requestTimeBudget),
+  requestExecutor(requestExecutor), admission(admission), requestsInFlight(0)
+{
+}
 
-    // Initialize command wrapper
-    commandWrapper = new CommandWrapper();
+ICommands* App::findCommand(string commandName) const {
+    // not case sensitive - convert to lower case
+    std::transform(commandName.begin(), commandName.end(), commandName.begin(), [](unsigned char c){ return std::tolower(c); });
+    return registry->findCommand(commandName);
 }
 
 
@@ -32,48 +36,191 @@ void App::run() {
             }
         catch (...) { 
             // Catching exception from input (e.g. connection closed or bad input)
+            if (input->isClosed()) {
+                break; // the client is gone, nobody to answer
+            }
             try {
                 // Try to send error message
-                output->displayOutput(commandWrapper->formatOutput(CommandWrapper::STATUS_BAD_REQUEST, ""));
+                output->displayResponse(CommandWrapper::STATUS_BAD_REQUEST, "");
             } catch (...) {
                 // If sending fails, the connection is likely closed. Stop the loop.
                 break;
             }
             continue;
         }
-        // first element is the command name. not case sensitive - convert to lower case
-        string commandName = commandAndArgs[0];
-        std::transform(commandName.begin(), commandName.end(), commandName.begin(), [](unsigned char c){ return std::tolower(c); });
-        
         if (commandAndArgs.size() <= 1) {
-            output->displayOutput(commandWrapper->formatOutput(CommandWrapper::STATUS_BAD_REQUEST, ""));
+            try {
+                output->displayResponse(CommandWrapper::STATUS_BAD_REQUEST, "");
+            } catch (...) {
+                break;
+            }
             continue; // invalid command entered, go back to start of loop
         }
         string args = commandAndArgs[1];  // extract arguments
-        // try to find the command in the map and execute it
-        string response;
-        if (commands.find(commandName) != commands.end()) {
-            response = commandWrapper->executeCommand(commands[commandName], args);
-        } else {
+        RequestContext request = input->lastRequest();
+        // try to find the command (the first element) in the registry and execute it
+        ICommands* command = findCommand(commandAndArgs[0]);
+        if (command == nullptr) {
             // Got a non-existing command. Bad request - 400
-            response = commandWrapper->formatOutput(CommandWrapper::STATUS_BAD_REQUEST, "");
+            releaseAdmittedBytes(request);
+            try {
+                output->displayResponseFor(request, CommandWrapper::STATUS_BAD_REQUEST, "");
+            } catch (...) {
+                break;
+            }
+            continue;
+        }
+        bool concurrent = request.concurrent && requestExecutor != nullptr;
+        // the input may have admitted the body already, before it received it
+        if (admission != nullptr && !admission->admitRequest(args.size() - request.admittedBytes, concurrent)) {
+            // the server is overloaded - say so at once instead of queueing the request
+            releaseAdmittedBytes(request);
+            try {
+                output->displayResponseFor(request, CommandWrapper::STATUS_SERVICE_UNAVAILABLE, "");
+            } catch (...) {
+                break;
+            }
+            continue;
+        }
+        if (concurrent) {
+            // answered when it is done, meanwhile the next requests of the connection are read
+            {
+                lock_guard<mutex> lock(requestsLock);
+                requestsInFlight++;
+            }
+            // in the lane of its command, so slow requests do not hold up fast ones (see TaskLane)
+            requestExecutor->post([this, command, args, request]() {
+                runConcurrentRequest(command, args, request);
+            }, command->lane(args));
+            continue;
         }
-        // send the output to the client
-        output->displayOutput(response);
+        bool answered = runRequest(command, args, request);
+        if (admission != nullptr) {
+            admission->finishRequest(args.size());
+        }
+        if (!answered) {
+            break; // the client is gone, nobody to answer
+        }
+    }
+    // the commands must outlive the concurrent requests that use them
+    unique_lock<mutex> lock(requestsLock);
+    requestsDone.wait(lock, [this]() { return requestsInFlight == 0; });
+    if (admission != nullptr) {
+        if (input->wasReaped()) {
+            admission->connectionReaped();
+        }
+        admission->releaseConnection();
     }
 }
 
-App::~App() {
-    // Clean up dynamically allocated commands
-    for (auto& pair : commands) {
-        delete pair.second;
+bool App::runRequest(ICommands* command, const string& args, const RequestContext& request) {
+    // the request stops when its time budget runs out or the client disconnects
+    CancellationToken token(requestTimeBudget, [this]() { return input->isClosed(); });
+    pair<int, string> response;
+    if (command->isStreamed(args)) {
+        // the items are sent while the command runs, response is only the closing status
+        response = {commandWrapper.runStreamedCommand(command, args, output, token, request), ""};
+    } else {
+        response = commandWrapper.runCommand(command, args, token);
+    }
+    // send the output to the client, the output frames it in the protocol of the client. a client that is gone
+    // makes this fail, no need to probe it first
+    try {
+        output->displayResponseFor(request, response.first, response.second);
+    } catch (...) {
+        return false; // sending failed, the connection is closed
+    }
+    return true;
+}
+
+void App::releaseAdmittedBytes(const RequestContext& request) {
+    if (admission != nullptr && request.admittedBytes > 0) {
+        admission->finishRequest(request.admittedBytes);
+    }
+}
+
+void App::runConcurrentRequest(ICommands* command, const string& args, const RequestContext& request) {
+    if (admission != nullptr) {
+        admission->startRequest();
+    }
+    runRequest(command, args, request);
+    finishConcurrentRequest(args.size());
+}
+
+void App::finishConcurrentRequest(size_t requestBytes) {
+    if (admission != nullptr) {
+        admission->finishRequest(requestBytes);
+    }
+    // notify under the lock - the app may be destroyed as soon as the last request is done
+    lock_guard<mutex> lock(requestsLock);
+    requestsInFlight--;
+    requestsDone.notify_all();
+}
+
+AsyncTask<void> App::runAsync(AsyncCSIO& connection, AsyncStorage& storage) {
+    while (true) {
+        vector<string> commandAndArgs;
+        bool received = true;
+        try {
+            commandAndArgs = co_await connection.getCommandAndArgs();
+        } catch (...) {
+            received = false;
+        }
+        if (!received && connection.isClosed()) {
+            break; // the client is gone, nobody to answer
+        }
+        RequestContext request = connection.lastRequest();
+
+        // a request that is not run is answered with its status at once
+        int refusal = 0;
+        ICommands* command = nullptr;
+        string args;
+        if (!received || commandAndArgs.size() <= 1) {
+            refusal = CommandWrapper::STATUS_BAD_REQUEST;
+        } else {
+            // first element is the command name
+            ICommands* found = findCommand(commandAndArgs[0]);
+            args = commandAndArgs[1];
+            if (found == nullptr) {
+                refusal = CommandWrapper::STATUS_BAD_REQUEST;
+            } else if (admission != nullptr && !admission->admitRequest(args.size() - request.admittedBytes, false)) {
+                refusal = CommandWrapper::STATUS_SERVICE_UNAVAILABLE; // the server is overloaded
+            } else {
+                command = found;
+            }
+            if (command == nullptr) {
+                releaseAdmittedBytes(request);
+            }
+        }
+
+        pair<int, string> response(refusal, "");
+        if (command != nullptr) {
+            try {
+                response = co_await command->executeAsync(args, storage);
+            } catch (...) {
+                response = {CommandWrapper::STATUS_INTERNAL_SERVER_ERROR, ""};
+            }
+            if (admission != nullptr) {
+                admission->finishRequest(args.size());
+            }
+        }
+        bool sent = true;
+        try {
+            co_await connection.respond(request, response.first, response.second);
+        } catch (...) {
+            sent = false;
+        }
+        if (!sent) {
+            break; // sending failed, the connection is closed
+        }
     }
-    // Clean up dynamically allocated compressors
-    for (auto& pair : compressors) {
-        delete pair.second;
+    if (admission != nullptr) {
+        admission->releaseConnection();
     }
-    // Clean up command wrapper
-    delete commandWrapper;
+}
+
+App::~App() {
+    // the commands belong to the registry (ownRegistry frees the app's own)
 }
 
 // int main() {
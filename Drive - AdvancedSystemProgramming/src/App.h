@@ -2,45 +2,98 @@
 #define APP_H
 
 #include <map>
+#include <memory>
 #include <algorithm> // for std::transform
 #include <cctype>    // for std::tolower
 #include <string>    // for std::string
 #include <vector>
 #include <cstdlib> // for getenv
 #include <iostream>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
 
 #include "CLIManager.h"
 #include "AddCommand.h"
 #include "GetCommand.h"
 #include "SearchCommand.h"
 #include "DeleteCommand.h"
+#include "ListCommand.h"
+#include "ExistsCommand.h"
+#include "BatchCommand.h"
+#include "StatsCommand.h"
 #include "RLEcompressor.h"
 #include "FolderManager.h"
 #include "CommandWrapper.h"
+#include "CommandRegistry.h"
+#include "CancellationToken.h"
 #include "IRunnable.h"
+#include "IExecutor.h"
+#include "AdmissionController.h"
+#include "AsyncCSIO.h"
+#include "AsyncStorage.h"
+#include "AsyncTask.h"
 
 using namespace std;
 
 class App : public IRunnable {
 private:
-    // a map of all possible commands
-    map<string, ICommands*> commands; 
+    // the commands and compressors, shared with the other connections (see CommandRegistry)
+    const CommandRegistry* registry;
+
+    // the registry of an app that was given a database instead of a registry (nullptr - a shared one)
+    unique_ptr<CommandRegistry> ownRegistry;
 
-    // a map of all compressors
-    map<string, Icompressor*> compressors;
     // input handler
     IInput* input;
     // output handler
     Ioutput* output; 
-    // Data Base handler
-    IdataBaseHandler* database;
 
-    // command wrapper to parse and execute commands
-    CommandWrapper* commandWrapper;
+    // command wrapper to parse and execute commands (it has no state, nothing to share)
+    CommandWrapper commandWrapper;
+
+    // how long a single request may run before it returns partial results (0 - no limit)
+    chrono::milliseconds requestTimeBudget;
+
+    // runs the concurrent requests of the connection (nullptr - every request runs in order, in the app loop)
+    IExecutor* requestExecutor;
+
+    // limits of the server (nullptr - no limits). the connection of the app holds one of its connection slots
+    AdmissionController* admission;
+
+    // number of concurrent requests that did not finish yet. the app does not end before they do
+    size_t requestsInFlight;
+    mutex requestsLock;
+    condition_variable requestsDone;
+
+    /*
+    * Runs a command and sends its response to the request.
+    * @return false if the client is gone (nobody to answer anymore).
+    */
+    bool runRequest(ICommands* command, const string& args, const RequestContext& request);
+
+    // runs a concurrent request, on the request executor
+    void runConcurrentRequest(ICommands* command, const string& args, const RequestContext& request);
+
+    // called by a concurrent request when it is done
+    void finishConcurrentRequest(size_t requestBytes);
+
+    // gives back the bytes the input admitted for a request that will not run (see RequestContext::admittedBytes)
+    void releaseAdmittedBytes(const RequestContext& request);
+
+    // the command of the request (a lower case name), nullptr if there is none
+    ICommands* findCommand(string commandName) const;
 
 public:
-    // Constructor to initialize maps/listeners
-    App(IdataBaseHandler* dbHandler, Ioutput* output, IInput* inputHandler);
+    // Constructor to initialize maps/listeners - the app builds a registry of its own for the database
+    App(IdataBaseHandler* dbHandler, Ioutput* output, IInput* inputHandler,
+        chrono::milliseconds requestTimeBudget = chrono::milliseconds(0), IExecutor* requestExecutor = nullptr,
+        AdmissionController* admission = nullptr);
+
+    // the same with the shared registry of the server (it must outlive the app), so a connection builds no commands
+    App(const CommandRegistry* registry, Ioutput* output, IInput* inputHandler,
+        chrono::milliseconds requestTimeBudget = chrono::milliseconds(0), IExecutor* requestExecutor = nullptr,
+        AdmissionController* admission = nullptr);
     // Destructor
     ~App();
     // because of the rule of 5
@@ -51,10 +104,21 @@ public:
     /*
     * the run method will start the app loop. it will listen for input from the listeners,
     * execute the corresponding command, and send the output to the output handler.
+    * concurrent requests (see RequestContext) are handed to the request executor and answered when they finish.
+    * a request that the admission controller does not admit is answered with 503 at once.
     * the app will run indefinitely.
     * @return void - no return value.
     */
     void run() override;
+
+    /*
+    * the coroutine form of run (see AsyncTask): the same loop over the requests of the connection, but reading,
+    * running the command (ICommands::executeAsync) and sending suspend instead of blocking, so the connection
+    * holds a thread only while it has work. its requests are answered in order (a concurrent one too).
+    * the app is made without input and output for it, the connection is the AsyncCSIO.
+    * connection and storage must outlive the coroutine.
+    */
+    AsyncTask<void> runAsync(AsyncCSIO& connection, AsyncStorage& storage);
 };
 
 #endif // APP_H
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include "AdmissionController.h"
+
+AdmissionController::AdmissionController(size_t maxConnections, size_t maxQueuedRequests, size_t maxInFlightBytes)
+    : maxConnections(maxConnections), maxQueuedRequests(maxQueuedRequests), maxInFlightBytes(maxInFlightBytes),
+      connections(0), queuedRequests(0), inFlightBytes(0), rejected(0), reaped(0), pool(nullptr), requestTasks(nullptr) {
+}
+
+bool AdmissionController::tryAdd(atomic<size_t>& gauge, size_t amount, size_t limit) {
+    if (limit == 0) {
+        gauge.fetch_add(amount, memory_order_relaxed);
+        return true;
+    }
+    size_t current = gauge.load(memory_order_relaxed);
+    do {
+        if (amount > limit || current > limit - amount) {
+            return false;
+        }
+    } while (!gauge.compare_exchange_weak(current, current + amount, memory_order_relaxed));
+    return true;
+}
+
+bool AdmissionController::admitConnection() {
+    if (!tryAdd(connections, 1, maxConnections)) {
+        rejected.fetch_add(1, memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+void AdmissionController::releaseConnection() {
+    connections.fetch_sub(1, memory_order_relaxed);
+}
+
+void AdmissionController::connectionReaped() {
+    reaped.fetch_add(1, memory_order_relaxed);
+}
+
+bool AdmissionController::admitRequest(size_t bytes, bool queued) {
+    if (!tryAdd(inFlightBytes, bytes, maxInFlightBytes)) {
+        rejected.fetch_add(1, memory_order_relaxed);
+        return false;
+    }
+    if (queued && !tryAdd(queuedRequests, 1, maxQueuedRequests)) {
+        inFlightBytes.fetch_sub(bytes, memory_order_relaxed);
+        rejected.fetch_add(1, memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+bool AdmissionController::admitBytes(size_t bytes) {
+    if (!tryAdd(inFlightBytes, bytes, maxInFlightBytes)) {
+        rejected.fetch_add(1, memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+void AdmissionController::startRequest() {
+    queuedRequests.fetch_sub(1, memory_order_relaxed);
+}
+
+void AdmissionController::finishRequest(size_t bytes) {
+    inFlightBytes.fetch_sub(bytes, memory_order_relaxed);
+}
+
+size_t AdmissionController::connectionCount() const {
+    return connections.load(memory_order_relaxed);
+}
+
+size_t AdmissionController::queuedRequestCount() const {
+    return queuedRequests.load(memory_order_relaxed);
+}
+
+size_t AdmissionController::inFlightByteCount() const {
+    return inFlightBytes.load(memory_order_relaxed);
+}
+
+size_t AdmissionController::rejectedCount() const {
+    return rejected.load(memory_order_relaxed);
+}
+
+size_t AdmissionController::reapedCount() const {
+    return reaped.load(memory_order_relaxed);
+}
+
+void AdmissionController::watchConnectionPool(const ElasticExecutor* connectionPool) {
+    pool = connectionPool;
+}
+
+const ElasticExecutor* AdmissionController::connectionPool() const {
+    return pool;
+}
+
+void AdmissionController::watchRequestMetrics(const TaskMetrics* metrics) {
+    requestTasks = metrics;
+}
+
+const TaskMetrics* AdmissionController::requestMetrics() const {
+    return requestTasks;
+}
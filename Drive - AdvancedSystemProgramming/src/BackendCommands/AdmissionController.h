@@ -0,0 +1,86 @@
+#ifndef ADMISSIONCONTROLLER_H
+#define ADMISSIONCONTROLLER_H
+
+#include <atomic>
+#include <cstddef>
+#include "ElasticExecutor.h"
+#include "TaskMetrics.h"
+
+using namespace std;
+
+/*
+* Decides if the server takes more work, so an overload is answered at once (503 Service Unavailable)
+* instead of queueing until latency and memory have no bound. it keeps gauges of the work in the server:
+* - connections: open connections, including the ones still waiting for a worker of the connection executor
+* - queued requests: concurrent requests waiting for a worker of the request executor
+* - in flight bytes: the size of the requests that were read (or are being read) and not answered yet
+* a new connection or request is admitted only if its gauge stays within the limit (0 - no limit).
+* all methods are thread safe and lock free, they are called from every connection.
+*/
+class AdmissionController {
+private:
+    size_t maxConnections;
+    size_t maxQueuedRequests;
+    size_t maxInFlightBytes;
+
+    atomic<size_t> connections;
+    atomic<size_t> queuedRequests;
+    atomic<size_t> inFlightBytes;
+    atomic<size_t> rejected; // connections and requests that were answered with 503
+    atomic<size_t> reaped;   // connections closed by their timeouts (see ConnectionTimeouts)
+
+    // the pool of the connections, its size and queue wait are reported with the gauges (nullptr - not reported)
+    const ElasticExecutor* pool;
+    // the metrics of the request executor, reported with the gauges (nullptr - not reported)
+    const TaskMetrics* requestTasks;
+
+    // adds the amount to the gauge if it stays within the limit, returns false (and changes nothing) otherwise
+    static bool tryAdd(atomic<size_t>& gauge, size_t amount, size_t limit);
+
+public:
+    AdmissionController(size_t maxConnections = 0, size_t maxQueuedRequests = 0, size_t maxInFlightBytes = 0);
+
+    // a new connection, false if there are too many. an admitted connection calls releaseConnection when it ends
+    bool admitConnection();
+    void releaseConnection();
+
+    // an admitted connection was closed because its client was silent for too long (it still calls releaseConnection)
+    void connectionReaped();
+
+    /*
+    * a new request of the given size. queued - it waits for the request executor (a concurrent request),
+    * otherwise it runs at once on its connection and only its bytes count.
+    * false if it would pass a limit. an admitted request calls finishRequest with the same size when it is answered
+    */
+    bool admitRequest(size_t bytes, bool queued);
+
+    /*
+    * the body of a request that is about to be received (its length came in a v2 header), so the limit bounds
+    * the memory of the requests before it is allocated. false if it would pass the limit. the request is then
+    * admitted with the rest of its bytes (admitRequest), or the bytes are given back with finishRequest
+    */
+    bool admitBytes(size_t bytes);
+
+    // a queued request left the queue and started running
+    void startRequest();
+
+    void finishRequest(size_t bytes);
+
+    // the gauges, e.g. for the STATS command
+    size_t connectionCount() const;
+    size_t queuedRequestCount() const;
+    size_t inFlightByteCount() const;
+    size_t rejectedCount() const;
+    size_t reapedCount() const;
+
+    // report the size of the connection pool with the gauges. call before the server runs
+    void watchConnectionPool(const ElasticExecutor* connectionPool);
+    const ElasticExecutor* connectionPool() const;
+
+    // report the queue wait and run time of the requests with the gauges (nullptr - not reported).
+    // call before the server runs
+    void watchRequestMetrics(const TaskMetrics* metrics);
+    const TaskMetrics* requestMetrics() const;
+};
+
+#endif // ADMISSIONCONTROLLER_H
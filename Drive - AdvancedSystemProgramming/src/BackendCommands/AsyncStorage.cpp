@@ -0,0 +1,23 @@
+#include "AsyncStorage.h"
+
+AsyncStorage::AsyncStorage(IdataBaseHandler* database, IExecutor* blockingExecutor, IExecutor* requestExecutor)
+    : m_database(database), m_blocking(blockingExecutor), m_requests(requestExecutor) {
+}
+
+AsyncTask<bool> AsyncStorage::isExists(std::string fileName) {
+    co_return co_await offload([this, &fileName]() { return m_database->isExists(fileName); });
+}
+
+AsyncTask<std::string> AsyncStorage::getContent(std::string fileName) {
+    co_return co_await offload([this, &fileName]() { return m_database->getContent(fileName); });
+}
+
+AsyncTask<bool> AsyncStorage::insertFile(std::string fileName, std::string content, std::filesystem::path filePath) {
+    co_return co_await offload([this, &fileName, &content, &filePath]() {
+        return m_database->insertFile(fileName, content, filePath);
+    });
+}
+
+AsyncTask<bool> AsyncStorage::deleteFile(std::string fileName) {
+    co_return co_await offload([this, &fileName]() { return m_database->deleteFile(fileName); });
+}
@@ -0,0 +1,60 @@
+#ifndef ASYNCSTORAGE_H
+#define ASYNCSTORAGE_H
+
+#include <exception>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "AsyncTask.h"
+#include "CoroutineScheduler.h"
+#include "IdataBaseHandler.h"
+
+/*
+* The database for coroutines (see AsyncTask): every operation is awaited instead of blocking the caller.
+* the database itself blocks (files), so an operation moves to the blocking executor (a pool that may grow,
+* like the connection pool), runs there, and moves back to the request executor - so the few workers that
+* run the coroutines never wait for a disk.
+*/
+class AsyncStorage {
+private:
+    IdataBaseHandler* m_database;
+    CoroutineScheduler m_blocking; // runs the calls of the database
+    CoroutineScheduler m_requests; // where the coroutines go on after the call
+
+public:
+    AsyncStorage(IdataBaseHandler* database, IExecutor* blockingExecutor, IExecutor* requestExecutor);
+    virtual ~AsyncStorage() = default;
+
+    // storages that can wait for the disk without a thread (see UringStorage) override these
+    virtual AsyncTask<bool> isExists(std::string fileName);
+    virtual AsyncTask<std::string> getContent(std::string fileName);
+    virtual AsyncTask<bool> insertFile(std::string fileName, std::string content, std::filesystem::path filePath);
+    virtual AsyncTask<bool> deleteFile(std::string fileName);
+
+    // runs any blocking work (e.g. a command that has no coroutine form) the same way, its exception is thrown
+    // by the co_await
+    template <typename Callable>
+    AsyncTask<std::invoke_result_t<Callable>> offload(Callable work);
+};
+
+template <typename Callable>
+AsyncTask<std::invoke_result_t<Callable>> AsyncStorage::offload(Callable work) {
+    using Result = std::invoke_result_t<Callable>;
+    co_await m_blocking.schedule();
+    std::optional<Result> result;
+    std::exception_ptr error;
+    try {
+        result.emplace(work());
+    } catch (...) {
+        error = std::current_exception(); // thrown after the coroutine is back on the request executor
+    }
+    co_await m_requests.schedule();
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    co_return std::move(*result);
+}
+
+#endif // ASYNCSTORAGE_H
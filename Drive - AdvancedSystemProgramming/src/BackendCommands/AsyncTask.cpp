@@ -0,0 +1,15 @@
+#include "AsyncTask.h"
+#include <iostream>
+
+void AsyncPromiseBase::reportDetachedError(const std::exception_ptr& error) noexcept {
+    if (!error) {
+        return;
+    }
+    try {
+        std::rethrow_exception(error);
+    } catch (const std::exception& e) {
+        std::cerr << "AsyncTask: exception in a detached coroutine: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "AsyncTask: unknown exception in a detached coroutine." << std::endl;
+    }
+}
@@ -0,0 +1,189 @@
+#ifndef ASYNCTASK_H
+#define ASYNCTASK_H
+
+#include <coroutine>
+#include <exception>
+#include <future>
+#include <optional>
+#include <utility>
+
+template <typename T>
+class AsyncTask;
+
+// what every AsyncTask coroutine keeps, whatever it returns
+class AsyncPromiseBase {
+public:
+    std::coroutine_handle<> continuation; // the coroutine that awaits this one (none - nobody, or detached)
+    std::exception_ptr error;             // what escaped the coroutine, thrown to the one that awaits it
+    bool detached = false;                // nobody awaits it, the coroutine frees itself when it ends
+
+    // a coroutine does nothing until it is awaited (or detached)
+    std::suspend_always initial_suspend() noexcept {
+        return {};
+    }
+
+    // at the end the awaiting coroutine goes on, on this thread, without growing the stack (symmetric transfer)
+    struct FinalAwaiter {
+        bool await_ready() noexcept {
+            return false;
+        }
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> finished) noexcept {
+            AsyncPromiseBase& promise = finished.promise();
+            if (promise.detached) {
+                reportDetachedError(promise.error);
+                finished.destroy();
+                return std::noop_coroutine();
+            }
+            return promise.continuation ? promise.continuation : std::noop_coroutine();
+        }
+        void await_resume() noexcept {
+        }
+    };
+
+    FinalAwaiter final_suspend() noexcept {
+        return {};
+    }
+
+    void unhandled_exception() noexcept {
+        error = std::current_exception();
+    }
+
+    // an exception of a detached coroutine has nobody to go to, it is written to stderr (like Task::runAndReport)
+    static void reportDetachedError(const std::exception_ptr& error) noexcept;
+};
+
+template <typename T>
+class AsyncPromise : public AsyncPromiseBase {
+public:
+    std::optional<T> value;
+
+    AsyncTask<T> get_return_object() noexcept;
+
+    void return_value(T result) {
+        value.emplace(std::move(result));
+    }
+
+    T take() {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return std::move(*value);
+    }
+};
+
+template <>
+class AsyncPromise<void> : public AsyncPromiseBase {
+public:
+    AsyncTask<void> get_return_object() noexcept;
+
+    void return_void() noexcept {
+    }
+
+    void take() {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+};
+
+/*
+* A coroutine that returns a T (a function with co_await / co_return that returns AsyncTask<T>).
+* it starts only when it is awaited: `T result = co_await something();` runs something until it suspends
+* (e.g. on a socket that has no data, see IoReactor, or to move to another executor, see CoroutineScheduler),
+* and the awaiting coroutine goes on when something returns - on whatever thread resumed it. its exception
+* is thrown by the co_await.
+* so request logic reads top to bottom while no thread is held while it waits.
+* move only, the task owns the coroutine: destroying a task that was never awaited destroys the coroutine.
+* reference parameters of a coroutine must outlive it (the caller usually awaits it at once, so they do).
+*/
+template <typename T = void>
+class AsyncTask {
+public:
+    using promise_type = AsyncPromise<T>;
+
+    explicit AsyncTask(std::coroutine_handle<promise_type> handle) noexcept : m_handle(handle) {
+    }
+
+    AsyncTask(AsyncTask&& other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {
+    }
+
+    AsyncTask& operator=(AsyncTask&& other) noexcept {
+        if (this != &other) {
+            if (m_handle) {
+                m_handle.destroy();
+            }
+            m_handle = std::exchange(other.m_handle, nullptr);
+        }
+        return *this;
+    }
+
+    ~AsyncTask() {
+        if (m_handle) {
+            m_handle.destroy();
+        }
+    }
+
+    AsyncTask(const AsyncTask&) = delete;
+    AsyncTask& operator=(const AsyncTask&) = delete;
+
+    // co_await starts the coroutine, the awaiting one goes on when it ends
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        m_handle.promise().continuation = awaiting;
+        return m_handle;
+    }
+
+    T await_resume() {
+        return m_handle.promise().take();
+    }
+
+    /*
+    * starts the coroutine on this thread without anyone awaiting it, it runs until it first suspends.
+    * it frees itself when it ends, its exception is written to stderr
+    */
+    void detach() && {
+        std::coroutine_handle<promise_type> handle = std::exchange(m_handle, nullptr);
+        handle.promise().detached = true;
+        handle.resume();
+    }
+
+    // starts the coroutine and blocks until it ended (on whatever thread), for code that is not a coroutine
+    T get() && {
+        std::promise<T> result;
+        std::future<T> done = result.get_future();
+        deliver(std::move(*this), std::move(result)).detach();
+        return done.get();
+    }
+
+private:
+    std::coroutine_handle<promise_type> m_handle;
+
+    // awaits the task and hands its result (or exception) to the promise
+    static AsyncTask<void> deliver(AsyncTask task, std::promise<T> result) {
+        try {
+            if constexpr (std::is_void_v<T>) {
+                co_await task;
+                result.set_value();
+            } else {
+                result.set_value(co_await task);
+            }
+        } catch (...) {
+            result.set_exception(std::current_exception());
+        }
+    }
+};
+
+template <typename T>
+AsyncTask<T> AsyncPromise<T>::get_return_object() noexcept {
+    return AsyncTask<T>(std::coroutine_handle<AsyncPromise<T>>::from_promise(*this));
+}
+
+inline AsyncTask<void> AsyncPromise<void>::get_return_object() noexcept {
+    return AsyncTask<void>(std::coroutine_handle<AsyncPromise<void>>::from_promise(*this));
+}
+
+#endif // ASYNCTASK_H
@@ -0,0 +1,46 @@
+#include "CancellationToken.h"
+
+constexpr chrono::milliseconds CancellationToken::PROBE_INTERVAL;
+
+CancellationToken::CancellationToken()
+    : cancelled(false), deadline(chrono::steady_clock::time_point::max()), nextProbe(0) {
+}
+
+CancellationToken::CancellationToken(chrono::milliseconds budget, function<bool()> isPeerGone)
+    : cancelled(false), deadline(chrono::steady_clock::time_point::max()), isPeerGone(isPeerGone), nextProbe(0) {
+    if (budget.count() > 0) {
+        deadline = chrono::steady_clock::now() + budget;
+    }
+}
+
+void CancellationToken::cancel() {
+    cancelled = true;
+}
+
+bool CancellationToken::isCancelled() const {
+    if (cancelled.load(memory_order_relaxed)) {
+        return true;
+    }
+    if (!isPeerGone) {
+        return false;
+    }
+    // probe the peer at most once per interval, the probe is a syscall
+    chrono::steady_clock::rep now = chrono::steady_clock::now().time_since_epoch().count();
+    chrono::steady_clock::rep due = nextProbe.load(memory_order_relaxed);
+    if (now < due || !nextProbe.compare_exchange_strong(due, now + chrono::steady_clock::duration(PROBE_INTERVAL).count())) {
+        return false; // probed recently (or another thread is probing right now)
+    }
+    if (isPeerGone()) {
+        cancelled = true; // remember it, the peer does not come back
+        return true;
+    }
+    return false;
+}
+
+bool CancellationToken::isExpired() const {
+    return deadline != chrono::steady_clock::time_point::max() && chrono::steady_clock::now() >= deadline;
+}
+
+bool CancellationToken::shouldStop() const {
+    return isCancelled() || isExpired();
+}
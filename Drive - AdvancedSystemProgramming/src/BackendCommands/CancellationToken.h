@@ -0,0 +1,46 @@
+#ifndef CANCELLATIONTOKEN_H
+#define CANCELLATIONTOKEN_H
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+using namespace std;
+
+/*
+* Tells a long running request when to stop. a request stops when
+* - its time budget ran out (expired), the request should return what it found so far, or
+* - it was cancelled, e.g. the client closed the connection, nobody waits for the result anymore.
+* long operations check shouldStop() between steps (files, chunks). the check is cheap: the peer probe
+* (usually a syscall) runs at most once per PROBE_INTERVAL.
+*/
+class CancellationToken {
+private:
+    static constexpr chrono::milliseconds PROBE_INTERVAL{10};
+
+    mutable atomic<bool> cancelled;               // set by cancel() or when the probe reported the peer is gone
+    chrono::steady_clock::time_point deadline;    // time_point::max() when there is no budget
+    function<bool()> isPeerGone;                  // optional probe, returns true if the client is gone
+    mutable atomic<chrono::steady_clock::rep> nextProbe; // when the probe may run again
+
+public:
+    // a token that never expires and is only cancelled by cancel()
+    CancellationToken();
+
+    // a token that expires after budget (0 means no budget) and is cancelled when isPeerGone returns true
+    CancellationToken(chrono::milliseconds budget, function<bool()> isPeerGone = nullptr);
+
+    // cancel the request
+    void cancel();
+
+    // true if cancel() was called or the peer is gone
+    bool isCancelled() const;
+
+    // true if the time budget ran out
+    bool isExpired() const;
+
+    // true if the request should stop now (cancelled or expired)
+    bool shouldStop() const;
+};
+
+#endif // CANCELLATIONTOKEN_H
@@ -3,12 +3,11 @@
 
 ClientThreadExecutor::ClientThreadExecutor() = default;
 
-void ClientThreadExecutor::execute(IRunnable &clientHandler) {
-    // create a new thread for each client connection and run the client handler
-    std::thread clientThread([&clientHandler]() {
-        clientHandler.run();
-
-        delete &clientHandler; // clean up the client handler after execution
+void ClientThreadExecutor::post(Task clientHandler) {
+    // create a new thread for each client connection and run the client handler.
+    // the handler moves into the thread and is cleaned up when the thread ends
+    std::thread clientThread([handler = std::move(clientHandler)]() mutable {
+        handler.runAndReport();
     });
     
     // detach the thread to allow it to run independently and free resources when done
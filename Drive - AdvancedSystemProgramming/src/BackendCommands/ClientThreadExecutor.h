@@ -17,11 +17,11 @@ public:
     ClientThreadExecutor();
 
     /*
-    * in this server version, the execute method will create a new thread for each client connection.
-    * @param clientHandler - the runnable task to be executed (a client handler - our app).
+    * in this server version, the post method will create a new thread for each client connection.
+    * @param clientHandler - the task to be executed (a client handler - our app), the thread owns it.
     * @return void - no return value.
     */
-    void execute(IRunnable &clientHandler) override;
+    void post(Task clientHandler) override;
 };
 
 
@@ -0,0 +1,37 @@
+#include "CoroutineScheduler.h"
+
+CoroutineScheduler::Schedule::Schedule(IExecutor* executor, int lane) : m_executor(executor), m_lane(lane) {
+}
+
+bool CoroutineScheduler::Schedule::await_ready() const noexcept {
+    return false;
+}
+
+void CoroutineScheduler::Schedule::await_suspend(std::coroutine_handle<> coroutine) {
+    // the coroutine may run on a worker before post returns, nothing of it is used after
+    m_executor->post(Task([coroutine]() { coroutine.resume(); }), m_lane);
+}
+
+void CoroutineScheduler::Schedule::await_resume() const noexcept {
+}
+
+CoroutineScheduler::CoroutineScheduler(IExecutor* executor) : m_executor(executor) {
+}
+
+CoroutineScheduler::Schedule CoroutineScheduler::schedule(int lane) const {
+    return Schedule(m_executor, lane);
+}
+
+// moves to the executor first, then runs the coroutine
+static AsyncTask<void> startOn(CoroutineScheduler::Schedule schedule, AsyncTask<void> coroutine) {
+    co_await schedule;
+    co_await coroutine;
+}
+
+void CoroutineScheduler::spawn(AsyncTask<void> coroutine, int lane) const {
+    startOn(schedule(lane), std::move(coroutine)).detach();
+}
+
+IExecutor* CoroutineScheduler::executor() const {
+    return m_executor;
+}
@@ -0,0 +1,44 @@
+#ifndef COROUTINESCHEDULER_H
+#define COROUTINESCHEDULER_H
+
+#include <coroutine>
+#include "AsyncTask.h"
+#include "IExecutor.h"
+
+/*
+* Runs coroutines (see AsyncTask) on an executor: a coroutine that awaits schedule() suspends, and goes on
+* in a task of the executor. so a few workers run any number of coroutines, one step (from a co_await to the
+* next one that suspends) at a time, and a coroutine may move to another executor on the way, e.g. to a pool
+* for blocking calls and back (see AsyncStorage).
+* if the executor shuts down before the task ran, the coroutine is never resumed (its frame is not freed).
+*/
+class CoroutineScheduler {
+private:
+    IExecutor* m_executor;
+
+public:
+    // the awaitable of schedule()
+    class Schedule {
+    private:
+        IExecutor* m_executor;
+        int m_lane;
+
+    public:
+        Schedule(IExecutor* executor, int lane);
+        bool await_ready() const noexcept;
+        void await_suspend(std::coroutine_handle<> coroutine);
+        void await_resume() const noexcept;
+    };
+
+    explicit CoroutineScheduler(IExecutor* executor);
+
+    // co_await schedule(): the coroutine goes on in a task of the executor, in the lane (see IExecutor::post)
+    Schedule schedule(int lane = TaskLane::SAME_AS_CALLER) const;
+
+    // starts the coroutine in a task of the executor. it frees itself when it ends, its exception goes to stderr
+    void spawn(AsyncTask<void> coroutine, int lane = TaskLane::SAME_AS_CALLER) const;
+
+    IExecutor* executor() const;
+};
+
+#endif // COROUTINESCHEDULER_H
@@ -0,0 +1,122 @@
+#include "CpuTopology.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <sched.h>
+
+CpuTopology::CpuTopology() : nodes(1) {
+}
+
+vector<int> CpuTopology::parseCpuList(const string& list) {
+    vector<int> cpus;
+    stringstream entries(list);
+    string entry;
+    while (getline(entries, entry, ',')) {
+        try {
+            size_t dash = entry.find('-');
+            int first = stoi(entry.substr(0, dash));
+            int last = dash == string::npos ? first : stoi(entry.substr(dash + 1));
+            for (int cpu = first; cpu <= last; cpu++) {
+                cpus.push_back(cpu);
+            }
+        } catch (...) {
+            // not a number (e.g. the newline at the end of the file) - skipped
+        }
+    }
+    return cpus;
+}
+
+CpuTopology CpuTopology::fromSysfs(const string& nodeDirectory) {
+    // the node directories are node0, node1... - sorted by their number, not by name (node10 after node9)
+    vector<pair<int, vector<int>>> found;
+    error_code error;
+    for (const auto& entry : filesystem::directory_iterator(nodeDirectory, error)) {
+        string name = entry.path().filename().string();
+        if (name.rfind("node", 0) != 0 || name.size() == 4 ||
+            !all_of(name.begin() + 4, name.end(), [](char c) { return isdigit(static_cast<unsigned char>(c)); })) {
+            continue;
+        }
+        ifstream cpulist(entry.path() / "cpulist");
+        string list;
+        getline(cpulist, list);
+        vector<int> cpus = parseCpuList(list);
+        if (!cpus.empty()) { // a node with memory only has no CPUs to place threads on
+            found.push_back({stoi(name.substr(4)), cpus});
+        }
+    }
+    sort(found.begin(), found.end());
+
+    CpuTopology topology;
+    if (!found.empty()) {
+        topology.nodes.clear();
+        for (auto& node : found) {
+            topology.nodes.push_back(node.second);
+        }
+    }
+    return topology;
+}
+
+CpuTopology CpuTopology::detect() {
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    bool knowsAllowed = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+
+    CpuTopology topology = fromSysfs("/sys/devices/system/node");
+    if (knowsAllowed) {
+        // only the CPUs of the affinity mask (e.g. a container limited to some cores)
+        vector<vector<int>> nodes;
+        for (const vector<int>& node : topology.nodes) {
+            vector<int> cpus;
+            for (int cpu : node) {
+                if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)) {
+                    cpus.push_back(cpu);
+                }
+            }
+            if (!cpus.empty()) {
+                nodes.push_back(cpus);
+            }
+        }
+        if (nodes.empty()) {
+            // no sysfs nodes - one node with every allowed CPU
+            vector<int> cpus;
+            for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+                if (CPU_ISSET(cpu, &allowed)) {
+                    cpus.push_back(cpu);
+                }
+            }
+            nodes.push_back(cpus);
+        }
+        topology.nodes = nodes;
+    }
+    return topology;
+}
+
+size_t CpuTopology::nodeCount() const {
+    return nodes.size();
+}
+
+const vector<int>& CpuTopology::cpusOf(size_t node) const {
+    return nodes.at(node);
+}
+
+vector<int> CpuTopology::allCpus() const {
+    vector<int> cpus;
+    for (const vector<int>& node : nodes) {
+        cpus.insert(cpus.end(), node.begin(), node.end());
+    }
+    return cpus;
+}
+
+int CpuTopology::nodeOf(int cpu) const {
+    for (size_t node = 0; node < nodes.size(); node++) {
+        if (find(nodes[node].begin(), nodes[node].end(), cpu) != nodes[node].end()) {
+            return static_cast<int>(node);
+        }
+    }
+    return -1;
+}
+
+int CpuTopology::currentCpu() {
+    return sched_getcpu();
+}
@@ -0,0 +1,44 @@
+#ifndef CPUTOPOLOGY_H
+#define CPUTOPOLOGY_H
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/*
+* Which CPUs belong to which NUMA node (a socket, or a part of one, with its own memory).
+* read from sysfs (/sys/devices/system/node/node<N>/cpulist), so it needs no libnuma. a machine without
+* that directory (or a container that hides it) is one node with every CPU the process may run on.
+*/
+class CpuTopology {
+private:
+    vector<vector<int>> nodes; // the CPUs of each node, in order
+
+public:
+    // one node with no CPUs - see detect
+    CpuTopology();
+
+    // the nodes from this sysfs node directory (e.g. a copy of /sys/devices/system/node in a test)
+    static CpuTopology fromSysfs(const string& nodeDirectory);
+
+    // the nodes of this machine, with only the CPUs the process may run on (its affinity mask)
+    static CpuTopology detect();
+
+    // "0-3,8,10-11" -> 0 1 2 3 8 10 11. an entry that is not a number is skipped
+    static vector<int> parseCpuList(const string& list);
+
+    size_t nodeCount() const;
+    const vector<int>& cpusOf(size_t node) const;
+
+    // every CPU, node by node
+    vector<int> allCpus() const;
+
+    // the node of the CPU, -1 if it is not in the topology
+    int nodeOf(int cpu) const;
+
+    // the CPU the calling thread runs on right now, -1 if it is unknown
+    static int currentCpu();
+};
+
+#endif // CPUTOPOLOGY_H
@@ -0,0 +1,22 @@
+#include "ElasticExecutor.h"
+
+ElasticExecutor::ElasticExecutor(size_t minThreads, size_t maxThreads, std::chrono::microseconds growAfterWait,
+                                 std::chrono::milliseconds idleTimeout)
+    : m_pool(minThreads, maxThreads, growAfterWait, idleTimeout) {
+}
+
+ElasticExecutor::~ElasticExecutor() {
+    shutdown();
+}
+
+void ElasticExecutor::post(Task task) {
+    m_pool.addTask(std::move(task));
+}
+
+void ElasticExecutor::shutdown() {
+    m_pool.shutdown();
+}
+
+PoolStats ElasticExecutor::stats() const {
+    return m_pool.stats();
+}
@@ -0,0 +1,28 @@
+#ifndef ELASTICEXECUTOR_H
+#define ELASTICEXECUTOR_H
+
+#include "IExecutor.h"
+#include "ElasticThreadPool.h"
+
+// an executor that grows and shrinks with the load (e.g. the connections of the server), see ElasticThreadPool
+class ElasticExecutor : public IExecutor {
+private:
+    ElasticThreadPool m_pool;
+
+public:
+    ElasticExecutor(size_t minThreads, size_t maxThreads,
+                    std::chrono::microseconds growAfterWait = std::chrono::milliseconds(5),
+                    std::chrono::milliseconds idleTimeout = std::chrono::seconds(30));
+    virtual ~ElasticExecutor();
+
+    // add the task to the pool, the pool owns it
+    void post(Task task) override;
+
+    // stops the workers after their current tasks
+    void shutdown();
+
+    // the size and the queue wait of the pool
+    PoolStats stats() const;
+};
+
+#endif // ELASTICEXECUTOR_H
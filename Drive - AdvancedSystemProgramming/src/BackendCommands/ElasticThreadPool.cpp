@@ -0,0 +1,165 @@
+#include "ElasticThreadPool.h"
+#include <algorithm>
+
+using namespace std;
+
+// Define the static constants
+const int ElasticThreadPool::WAIT_AVERAGE_SHIFT = 3;
+
+ElasticThreadPool::ElasticThreadPool(size_t minThreads, size_t maxThreads, chrono::microseconds growAfterWait,
+                                     chrono::milliseconds idleTimeout)
+    : m_minThreads(max<size_t>(minThreads, 1)), m_maxThreads(max(maxThreads, max<size_t>(minThreads, 1))),
+      m_growAfterWait(growAfterWait), m_idleTimeout(idleTimeout), m_liveThreads(0), m_idleThreads(0),
+      m_stopped(false), m_queueWait(0), m_maxQueueWait(0), m_grown(0), m_shrunk(0) {
+    lock_guard<mutex> lock(m_lock);
+    for (size_t i = 0; i < m_minThreads; i++) {
+        startWorker();
+    }
+    m_supervisor = thread(&ElasticThreadPool::supervisorRoutine, this);
+}
+
+ElasticThreadPool::~ElasticThreadPool() {
+    shutdown();
+}
+
+void ElasticThreadPool::startWorker() {
+    thread worker(&ElasticThreadPool::workerRoutine, this);
+    thread::id id = worker.get_id();
+    m_workers.emplace(id, move(worker));
+    m_liveThreads++;
+}
+
+void ElasticThreadPool::joinRetired() {
+    // a retired worker released the lock for the last time when it ended, so the join does not wait on us
+    for (thread::id id : m_retired) {
+        auto worker = m_workers.find(id);
+        if (worker != m_workers.end()) {
+            worker->second.join();
+            m_workers.erase(worker);
+        }
+    }
+    m_retired.clear();
+}
+
+void ElasticThreadPool::recordWait(chrono::microseconds wait) {
+    m_queueWait += (wait - m_queueWait) / (1 << WAIT_AVERAGE_SHIFT);
+    m_maxQueueWait = max(m_maxQueueWait, wait);
+}
+
+void ElasticThreadPool::growForLateTasks(chrono::steady_clock::time_point now) {
+    // the tasks are in the order they were added, so the late ones are at the front
+    size_t late = 0;
+    for (const QueuedTask& queued : m_tasks) {
+        if (now - queued.queuedAt < m_growAfterWait) {
+            break;
+        }
+        late++;
+    }
+    while (late > m_idleThreads && m_liveThreads < m_maxThreads) {
+        startWorker();
+        m_grown++;
+        late--;
+    }
+}
+
+void ElasticThreadPool::addTask(Task task) {
+    lock_guard<mutex> lock(m_lock);
+    if (m_stopped) {
+        return;
+    }
+    m_tasks.push_back({move(task), chrono::steady_clock::now()});
+    if (m_idleThreads > 0) {
+        m_taskReady.notify_one();
+    }
+    if (m_tasks.size() > m_idleThreads) {
+        // the task will wait - the supervisor times it
+        m_supervisorWake.notify_one();
+    }
+}
+
+void ElasticThreadPool::workerRoutine() {
+    unique_lock<mutex> lock(m_lock);
+    while (true) {
+        m_idleThreads++;
+        bool hasTask = m_taskReady.wait_for(lock, m_idleTimeout, [this]() { return m_stopped || !m_tasks.empty(); });
+        m_idleThreads--;
+        if (m_stopped) {
+            break;
+        }
+        if (!hasTask) {
+            if (m_liveThreads > m_minThreads) {
+                m_shrunk++;
+                break; // idle for too long, the pool does not need this worker
+            }
+            continue;
+        }
+
+        QueuedTask next = move(m_tasks.front());
+        m_tasks.pop_front();
+        recordWait(chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - next.queuedAt));
+
+        lock.unlock();
+        // an exception of the task is reported, the worker goes on. what the task owns is freed before
+        // the lock is taken again
+        next.task.runAndReport();
+        next.task = Task();
+        lock.lock();
+    }
+    m_liveThreads--;
+    if (!m_stopped) {
+        m_retired.push_back(this_thread::get_id());
+        m_supervisorWake.notify_one(); // the supervisor joins it
+    }
+}
+
+void ElasticThreadPool::supervisorRoutine() {
+    unique_lock<mutex> lock(m_lock);
+    while (!m_stopped) {
+        joinRetired();
+        if (m_tasks.size() <= m_idleThreads) {
+            // nothing will wait - sleep until a task does
+            m_supervisorWake.wait(lock);
+            continue;
+        }
+        // sleep until the oldest task becomes late (or something changes), then grow if it still waits
+        auto late = m_tasks.front().queuedAt + m_growAfterWait;
+        m_supervisorWake.wait_until(lock, late);
+        if (!m_stopped) {
+            growForLateTasks(chrono::steady_clock::now());
+        }
+    }
+}
+
+void ElasticThreadPool::shutdown() {
+    map<thread::id, thread> workers;
+    deque<QueuedTask> dropped; // the tasks that never ran, destroyed after the lock is released
+    {
+        lock_guard<mutex> lock(m_lock);
+        if (m_stopped) {
+            return;
+        }
+        m_stopped = true;
+        dropped.swap(m_tasks);
+        workers.swap(m_workers);
+        m_taskReady.notify_all();
+        m_supervisorWake.notify_all();
+    }
+    // no worker starts after m_stopped, and the ones that ended are joined here too
+    m_supervisor.join();
+    for (auto& worker : workers) {
+        worker.second.join();
+    }
+}
+
+PoolStats ElasticThreadPool::stats() const {
+    lock_guard<mutex> lock(m_lock);
+    PoolStats stats;
+    stats.threads = m_liveThreads;
+    stats.idleThreads = m_idleThreads;
+    stats.queuedTasks = m_tasks.size();
+    stats.queueWait = m_queueWait;
+    stats.maxQueueWait = m_maxQueueWait;
+    stats.grown = m_grown;
+    stats.shrunk = m_shrunk;
+    return stats;
+}
@@ -0,0 +1,92 @@
+#ifndef ELASTICTHREADPOOL_H
+#define ELASTICTHREADPOOL_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Task.h"
+
+// a snapshot of the size and the queue of an ElasticThreadPool, e.g. for the STATS command
+struct PoolStats {
+    size_t threads = 0;                           // workers alive now
+    size_t idleThreads = 0;                       // workers waiting for a task
+    size_t queuedTasks = 0;                       // tasks waiting for a worker
+    std::chrono::microseconds queueWait{0};       // recent time from addTask until a worker took the task (moving average)
+    std::chrono::microseconds maxQueueWait{0};    // the longest wait so far
+    size_t grown = 0;                             // workers started beyond the minimum, in total
+    size_t shrunk = 0;                            // workers that ended after their idle timeout, in total
+};
+
+/*
+* A thread pool that changes its size with the load, between a minimum and a maximum number of workers.
+* - it starts with the minimum. when the oldest queued task waited longer than growAfterWait, the pool starts
+*   a worker for every late task (up to the maximum), so tasks that block for long (a connection) do not
+*   keep the others waiting.
+* - a worker that found no task for idleTimeout ends, unless the pool is at its minimum.
+* a supervisor thread sleeps until the oldest task becomes late, so an idle pool does not wake up at all.
+* with minThreads == maxThreads it is a plain fixed pool.
+*/
+class ElasticThreadPool {
+private:
+    struct QueuedTask {
+        Task task;
+        std::chrono::steady_clock::time_point queuedAt;
+    };
+
+    // the weight of a new wait in the moving average of the queue wait (1 / 8)
+    static const int WAIT_AVERAGE_SHIFT;
+
+    size_t m_minThreads;
+    size_t m_maxThreads;
+    std::chrono::microseconds m_growAfterWait;
+    std::chrono::milliseconds m_idleTimeout;
+
+    mutable std::mutex m_lock;                  // guards everything below
+    std::condition_variable m_taskReady;        // workers wait here for tasks
+    std::condition_variable m_supervisorWake;   // the supervisor waits here for the oldest task to be late
+    std::deque<QueuedTask> m_tasks;
+    std::map<std::thread::id, std::thread> m_workers;
+    std::vector<std::thread::id> m_retired;     // workers that ended, to be joined
+    size_t m_liveThreads;
+    size_t m_idleThreads;
+    bool m_stopped;
+    std::thread m_supervisor;
+
+    std::chrono::microseconds m_queueWait;
+    std::chrono::microseconds m_maxQueueWait;
+    size_t m_grown;
+    size_t m_shrunk;
+
+    void workerRoutine();
+    void supervisorRoutine();
+
+    // the lock must be held by the callers of these
+    void startWorker();
+    void joinRetired();
+    void recordWait(std::chrono::microseconds wait);
+    // starts a worker for every task that waited longer than growAfterWait and has no idle worker for it
+    void growForLateTasks(std::chrono::steady_clock::time_point now);
+
+public:
+    ElasticThreadPool(size_t minThreads, size_t maxThreads,
+                      std::chrono::microseconds growAfterWait = std::chrono::milliseconds(5),
+                      std::chrono::milliseconds idleTimeout = std::chrono::seconds(30));
+    ~ElasticThreadPool();
+
+    ElasticThreadPool(const ElasticThreadPool&) = delete;
+    ElasticThreadPool& operator=(const ElasticThreadPool&) = delete;
+
+    // the pool owns the task, a task added after shutdown is dropped
+    void addTask(Task task);
+
+    // stops the workers after their current tasks. tasks still queued are destroyed without running (like ThreadPool)
+    void shutdown();
+
+    PoolStats stats() const;
+};
+
+#endif // ELASTICTHREADPOOL_H
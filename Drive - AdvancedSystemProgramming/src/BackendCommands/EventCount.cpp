@@ -0,0 +1,51 @@
+#include "EventCount.h"
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// the futex word is the epoch itself (a lock free atomic<uint32_t> is a plain 32 bit integer)
+static int* futexWord(std::atomic<uint32_t>& epoch) {
+    return reinterpret_cast<int*>(&epoch);
+}
+
+EventCount::EventCount() : m_epoch(0), m_waiters(0) {
+}
+
+uint32_t EventCount::prepareWait() {
+    // seq_cst: the waiter is counted before it checks its condition again, and a notifier that changed
+    // the condition reads the count after the change - one of them sees the other
+    m_waiters.fetch_add(1);
+    return m_epoch.load();
+}
+
+void EventCount::cancelWait() {
+    m_waiters.fetch_sub(1);
+}
+
+void EventCount::wait(uint32_t key) {
+    // sleeps only while the epoch is still the key, a spurious wakeup is fine (the caller checks again)
+    while (m_epoch.load() == key) {
+        syscall(SYS_futex, futexWord(m_epoch), FUTEX_WAIT_PRIVATE, key, nullptr, nullptr, 0);
+    }
+    m_waiters.fetch_sub(1);
+}
+
+void EventCount::notify(int count) {
+    // the fence orders the caller's change (a plain release store) before the waiters load,
+    // or a waiter that checked before the change could be missed
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_waiters.load() == 0) {
+        return; // nobody sleeps or is about to
+    }
+    m_epoch.fetch_add(1);
+    syscall(SYS_futex, futexWord(m_epoch), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+}
+
+void EventCount::notifyOne() {
+    notify(1);
+}
+
+void EventCount::notifyAll() {
+    notify(INT_MAX);
+}
@@ -0,0 +1,39 @@
+#ifndef EVENTCOUNT_H
+#define EVENTCOUNT_H
+
+#include <atomic>
+#include <cstdint>
+
+/*
+* Lets threads sleep until "something changed" without a mutex, for lock free structures.
+* a waiter announces itself, checks its condition again, and only then sleeps:
+*     uint32_t key = events.prepareWait();
+*     if (condition) { events.cancelWait(); ... } else { events.wait(key); }
+* a notify after prepareWait makes wait return at once, so no wakeup is lost. the sleep is a futex on the
+* epoch counter, and notify does no syscall (only an atomic load) when nobody waits.
+*/
+class EventCount {
+private:
+    std::atomic<uint32_t> m_epoch;   // changes on every notify that has waiters, the futex word
+    std::atomic<uint32_t> m_waiters; // threads between prepareWait and the end of wait / cancelWait
+
+    void notify(int count);
+
+public:
+    EventCount();
+
+    // announces a waiter, returns the key for wait
+    uint32_t prepareWait();
+
+    // the condition came true after prepareWait, no need to sleep
+    void cancelWait();
+
+    // sleeps until a notify after prepareWait (returns at once if there was one already)
+    void wait(uint32_t key);
+
+    // wakes one waiter / all of them
+    void notifyOne();
+    void notifyAll();
+};
+
+#endif // EVENTCOUNT_H
@@ -39,11 +39,10 @@ bool FolderManager::insertFile(const string fileName, const string content, cons
     std::unique_lock<std::shared_mutex> lock(dbMutex); // unique lock because this is a write operation
     
     // dont call isExists here to avoid deadlock of the mutex
-    if (logicToPhysicalName.count(fileName) == 1) { // direct map check since we already own the lock
+    if (logicToPhysicalName.count(fileName) == 1 || busyNames.count(fileName) == 1) { // direct map check since we already own the lock
         return false;
     }
     string physicalName = encodeFilename(fileName);
-    logicToPhysicalName.insert({fileName, physicalName});
     filesystem::path fullFilePath = filePath / physicalName;
     ofstream out1(fullFilePath, ios::binary);
     if (!out1.is_open()) {
@@ -54,6 +53,11 @@ bool FolderManager::insertFile(const string fileName, const string content, cons
     if (!out1) {         
         return false;
     }
+    return registerName(fileName, physicalName, fullFilePath);
+}
+
+bool FolderManager::registerName(const string& fileName, const string& physicalName, const filesystem::path& fullFilePath) {
+    logicToPhysicalName.insert({fileName, physicalName});
     ofstream out(folderForLogicalNames / LOGICAL_NAMES, std::ios::app);
     if (!out.is_open()) { 
         // if we fail to open the logical names file, we need to cleanup the previously created physical file and the map entry.
@@ -62,15 +66,7 @@ bool FolderManager::insertFile(const string fileName, const string content, cons
         // replace with manual cleanup logic
         error_code ec;
         filesystem::remove(fullFilePath, ec); // manually remove file
-        logicToPhysicalName.erase(fileName); // manually remove from map
-        // manually remove from logical names file by rewriting the logical names file
-        ofstream out_rem(folderForLogicalNames / LOGICAL_NAMES);
-            if (!out_rem.is_open()) {
-            return false;
-        }
-        for (const auto& entry : logicToPhysicalName) {
-            out_rem << entry.first << '\n';
-        }
+        unregisterName(fileName); // remove from map and from logical names file
         return false;
     }
     out << fileName << '\n';
@@ -81,7 +77,7 @@ bool FolderManager::deleteFile(const string fileName) {
     std::unique_lock<std::shared_mutex> lock(dbMutex); // unique lock because this is a write operation
 
     // dont call isExists(fileName) here to avoid deadlock of the mutex
-    if (logicToPhysicalName.count(fileName) == 0) { // direct map check since we already own the lock
+    if (logicToPhysicalName.count(fileName) == 0 || busyNames.count(fileName) == 1) { // direct map check since we already own the lock
         return false;
     }
     string physicalName = logicToPhysicalName[fileName];
@@ -92,6 +88,10 @@ bool FolderManager::deleteFile(const string fileName) {
         // error during file deletion
         return false;
     }
+    return unregisterName(fileName);
+}
+
+bool FolderManager::unregisterName(const string& fileName) {
     logicToPhysicalName.erase(fileName);
     // Rewrite the logical names file
     ofstream out(folderForLogicalNames / LOGICAL_NAMES);
@@ -104,6 +104,55 @@ bool FolderManager::deleteFile(const string fileName) {
     return true;
 }
 
+filesystem::path FolderManager::contentPath(const string& fileName) {
+    std::shared_lock<std::shared_mutex> lock(dbMutex); // shared lock because this is a read-only operation
+    if (!logicToPhysicalName.count(fileName)) {
+        printf("File %s does not exist in the database\n", fileName.c_str());
+        throw exception();
+    }
+    return mainStorage / logicToPhysicalName.at(fileName);
+}
+
+bool FolderManager::beginInsert(const string& fileName, const filesystem::path& filePath, filesystem::path& fullFilePath) {
+    std::unique_lock<std::shared_mutex> lock(dbMutex); // unique lock because this is a write operation
+    if (logicToPhysicalName.count(fileName) == 1 || !busyNames.insert(fileName).second) {
+        return false;
+    }
+    // no one else writes this file until finishInsert, and no one reads it before
+    fullFilePath = filePath / encodeFilename(fileName);
+    return true;
+}
+
+bool FolderManager::finishInsert(const string& fileName, const filesystem::path& fullFilePath, bool written) {
+    std::unique_lock<std::shared_mutex> lock(dbMutex); // unique lock because this is a write operation
+    busyNames.erase(fileName);
+    if (!written) {
+        error_code ec;
+        filesystem::remove(fullFilePath, ec); // a part of the content may have been written
+        return false;
+    }
+    return registerName(fileName, encodeFilename(fileName), fullFilePath);
+}
+
+bool FolderManager::beginDelete(const string& fileName, filesystem::path& fullPath) {
+    std::unique_lock<std::shared_mutex> lock(dbMutex); // unique lock because this is a write operation
+    if (logicToPhysicalName.count(fileName) == 0 || !busyNames.insert(fileName).second) {
+        return false;
+    }
+    // the name stays readable until finishDelete, a reader that opens the file after it was removed fails
+    fullPath = mainStorage / logicToPhysicalName.at(fileName);
+    return true;
+}
+
+bool FolderManager::finishDelete(const string& fileName, bool removed) {
+    std::unique_lock<std::shared_mutex> lock(dbMutex); // unique lock because this is a write operation
+    busyNames.erase(fileName);
+    if (!removed) {
+        return false;
+    }
+    return unregisterName(fileName);
+}
+
 vector<string> FolderManager::getAllFileNames() {
     std::shared_lock<std::shared_mutex> lock(dbMutex); // shared lock because this is a read-only operation
     vector<string> result;
@@ -113,6 +162,22 @@ vector<string> FolderManager::getAllFileNames() {
     return result;
 }
 
+vector<string> FolderManager::getFileNames(const string& prefix, const string& startAfter, size_t limit) {
+    std::shared_lock<std::shared_mutex> lock(dbMutex); // shared lock because this is a read-only operation
+    vector<string> result;
+    // jump to the first name that can be on the page: the first one with the prefix, or the one after startAfter
+    map<string, string>::const_iterator it = startAfter < prefix ? logicToPhysicalName.lower_bound(prefix)
+                                                                 : logicToPhysicalName.upper_bound(startAfter);
+    // names with the same prefix are next to each other, stop at the first one without it
+    for (; it != logicToPhysicalName.end() && result.size() < limit; ++it) {
+        if (it->first.compare(0, prefix.size(), prefix) != 0) {
+            break;
+        }
+        result.push_back(it->first);
+    }
+    return result;
+}
+
 string FolderManager::getContent(const string fileName) {
     std::shared_lock<std::shared_mutex> lock(dbMutex); // shared lock because this is a read-only operation
     if (!logicToPhysicalName.count(fileName)) {
@@ -132,3 +197,19 @@ string FolderManager::getContent(const string fileName) {
     buffer << in.rdbuf();
     return buffer.str();
 }
+
+unique_ptr<istream> FolderManager::openContentStream(const string fileName) {
+    std::shared_lock<std::shared_mutex> lock(dbMutex); // shared lock because this is a read-only operation
+    if (!logicToPhysicalName.count(fileName)) {
+        printf("File %s does not exist in the database\n", fileName.c_str());
+        throw exception();
+    }
+    filesystem::path fullPath = mainStorage / logicToPhysicalName.at(fileName);
+    // the file stays readable after the lock is released even if it is deleted meanwhile (unlink keeps open files alive)
+    unique_ptr<ifstream> in = make_unique<ifstream>(fullPath, ios::binary);
+    if (!in->is_open()) {
+        printf("Could not open file %s\n", fullPath.c_str());
+        throw exception();
+    }
+    return in;
+}
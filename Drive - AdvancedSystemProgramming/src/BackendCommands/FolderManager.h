@@ -6,6 +6,7 @@
 #include "IdataBaseHandler.h"
 #include <filesystem>
 #include <map>
+#include <set>
 #include <fstream>
 #include <shared_mutex> // for reader-writer lock
 
@@ -17,11 +18,20 @@ private:
     mutable std::shared_mutex dbMutex; // mutex to protect access
         
     map<string, string> logicToPhysicalName; 
+
+    set<string> busyNames; // names with an insert or a delete in progress outside the lock (see beginInsert)
     
     filesystem::path mainStorage;
 
     filesystem::path folderForLogicalNames;
 
+    // adds the name (its content is in fullFilePath) to the map and the logical names file, holding the lock.
+    // if the file can not be written the content file is removed and false is returned
+    bool registerName(const string& fileName, const string& physicalName, const filesystem::path& fullFilePath);
+
+    // removes the name from the map and rewrites the logical names file, holding the lock
+    bool unregisterName(const string& fileName);
+
 public: 
 
     // Constructor
@@ -36,11 +46,37 @@ public:
     // get all file names in the database
     vector<string> getAllFileNames() override;
 
+    // get one page of file names with a range scan on the (sorted) names map - costs O(log n + page)
+    vector<string> getFileNames(const string& prefix, const string& startAfter, size_t limit) override;
+
     // get file content (compressed) from the database
     string getContent(const string fileName) override;
 
+    // open the file content (compressed) as a stream instead of reading it all into memory
+    unique_ptr<istream> openContentStream(const string fileName) override;
+
     // delete a file from the database
     bool deleteFile(const string fileName) override;
+
+    // the steps of getContent, insertFile and deleteFile for a caller that reads and writes the content files
+    // itself (e.g. through io_uring, see UringStorage) and must not hold the lock meanwhile.
+
+    // where the content of the file is. throws exception if the file does not exist
+    filesystem::path contentPath(const string& fileName);
+
+    // reserves the name for an insert, false if it exists or is busy. fullFilePath - where to write the content,
+    // then call finishInsert
+    bool beginInsert(const string& fileName, const filesystem::path& filePath, filesystem::path& fullFilePath);
+
+    // adds the reserved name if its content was written (the content file is removed if not). true if inserted
+    bool finishInsert(const string& fileName, const filesystem::path& fullFilePath, bool written);
+
+    // reserves an existing name for a delete, false if it does not exist or is busy. fullPath - the content file
+    // to remove, then call finishDelete
+    bool beginDelete(const string& fileName, filesystem::path& fullPath);
+
+    // removes the reserved name if its content file was removed (keeps it if not). true if deleted
+    bool finishDelete(const string& fileName, bool removed);
 };
 
 #endif
@@ -3,6 +3,13 @@
 #define IEXECUTOR_H
 
 #include "IRunnable.h"
+#include "Task.h"
+#include "TaskLane.h"
+#include <future>
+#include <type_traits>
+#include <utility>
+
+class TaskMetrics;
 
 class IExecutor {
 public:
@@ -12,9 +19,48 @@ public:
     virtual ~IExecutor()=default;
 
     /*
-    * the execute method will take a runnable task and execute it.
-    * each executor implementation will define how the task is executed.
+    * the post method will take a task and run it, each executor implementation will define how.
+    * the executor owns the task from now on: it destroys the task after it ran, or without running it
+    * if the executor shuts down first. an exception that escapes the task is reported by the worker (see Task).
+    */
+    virtual void post(Task task) = 0;
+
+    /*
+    * the same, for a task of the given lane (see TaskLane). only executors that schedule by lane use it,
+    * the default ignores the lane.
+    */
+    virtual void post(Task task, int lane) {
+        post(std::move(task));
+    }
+
+    /*
+    * the queue wait and run time of the tasks, for executors that measure them (see TaskMetrics).
+    * the default - nullptr, nothing is measured
+    */
+    virtual const TaskMetrics* metrics() const {
+        return nullptr;
+    }
+
+    /*
+    * the execute method will run a task that the caller owns - it must stay alive until it ran.
+    */
+    void execute(IRunnable &task) {
+        post(Task([&task]() { task.run(); }));
+    }
+
+    /*
+    * runs the work (in the lane, see post) and returns the future of its result. the exception of the work is
+    * thrown by future.get(), and if the executor shuts down before the work ran, future.get() throws
+    * future_error (broken promise).
     */
-    virtual void execute(IRunnable &task) = 0;
+    template <typename Callable>
+    std::future<std::invoke_result_t<std::decay_t<Callable>>> submit(Callable&& work,
+                                                                      int lane = TaskLane::SAME_AS_CALLER) {
+        using Result = std::invoke_result_t<std::decay_t<Callable>>;
+        std::packaged_task<Result()> task(std::forward<Callable>(work));
+        std::future<Result> result = task.get_future();
+        post(Task(std::move(task)), lane);
+        return result;
+    }
 };
-#endif // IEXECUTOR_H
\ No newline at end of file
+#endif // IEXECUTOR_H
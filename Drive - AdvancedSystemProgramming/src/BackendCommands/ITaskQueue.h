@@ -0,0 +1,35 @@
+// Task queue interface of the ThreadPool
+#ifndef ITASKQUEUE_H
+#define ITASKQUEUE_H
+
+#include "Task.h"
+
+class ITaskQueue {
+public:
+    /*
+    * default destructor
+    */
+    virtual ~ITaskQueue()=default;
+
+    // adding a task to the queue, the queue owns it until it is taken. a task added after shutdown is dropped
+    virtual void enqueue(Task item) = 0;
+
+    // adding a task only if there is room right away, never waiting. false (and item is left as it was) if the
+    // queue is full. a queue without a bound always has room
+    virtual bool enqueueNoWait(Task& item) {
+        enqueue(std::move(item));
+        return true;
+    }
+
+    // retrieving a task from the queue into item, waits until there is one. false if the queue is shut down
+    virtual bool dequeue(Task& item) = 0;
+
+    // test if the queue is empty (a snapshot, other threads may change it right away)
+    virtual bool isEmpty() = 0;
+
+    // shutting down the queue, every thread waiting in dequeue gets false. the tasks still queued are destroyed
+    // without running (so the futures of submitted tasks break instead of waiting forever)
+    virtual void shutdown() = 0;
+};
+
+#endif // ITASKQUEUE_H
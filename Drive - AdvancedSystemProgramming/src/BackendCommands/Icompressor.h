@@ -1,7 +1,12 @@
 #ifndef ICOMPRESSOR_H
 #define ICOMPRESSOR_H
 
+#include "IdecompressStream.h"
+#include "StringDecompressStream.h"
 #include <string>
+#include <istream>
+#include <sstream>
+#include <memory>
 using namespace std;
 
 // Interface declaration
@@ -14,9 +19,17 @@ public:
     // Decompresses file content returns the decompressed content.
     virtual string decompressFile(string compressedContent) = 0;
 
+    // Opens a stream that decompresses the given compressed content piece by piece.
+    // the default decompresses everything at once, compressors that can stream should override it.
+    virtual unique_ptr<IdecompressStream> openDecompressStream(unique_ptr<istream> compressedContent) {
+        stringstream buffer;
+        buffer << compressedContent->rdbuf();
+        return make_unique<StringDecompressStream>(decompressFile(buffer.str()));
+    }
+
     // no need for constructor in Interfaces.
     // virtual destructor (every Interface should have a virtual destructor)
     virtual ~Icompressor() = default;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -6,6 +6,10 @@
 #include <map>
 #include <filesystem>
 #include <iostream>
+#include <istream>
+#include <sstream>
+#include <memory>
+#include <algorithm>
 
 using namespace std;
 
@@ -23,9 +27,31 @@ public:
     // get all file names in the database
     virtual vector<string> getAllFileNames() = 0;
 
+    // get up to limit file names, in name order, that start with prefix and come after startAfter (empty - from the first).
+    // the default filters getAllFileNames(), handlers with an ordered index should override it to scan only one page.
+    virtual vector<string> getFileNames(const string& prefix, const string& startAfter, size_t limit) {
+        vector<string> result;
+        for (const string& name : getAllFileNames()) {
+            if (name.compare(0, prefix.size(), prefix) == 0 && name > startAfter) {
+                result.push_back(name);
+            }
+        }
+        sort(result.begin(), result.end());
+        if (result.size() > limit) {
+            result.resize(limit);
+        }
+        return result;
+    }
+
     // get file content (compressed) from the database
     virtual string getContent(const string fileName) = 0;
 
+    // open a stream over the file content (compressed) so it can be read piece by piece.
+    // the default reads the whole content into memory, handlers that can stream should override it.
+    virtual unique_ptr<istream> openContentStream(const string fileName) {
+        return make_unique<istringstream>(getContent(fileName));
+    }
+
     // delete a file from the database
     virtual bool deleteFile(const string fileName) = 0; // return true if deleted, false otherwise
 };
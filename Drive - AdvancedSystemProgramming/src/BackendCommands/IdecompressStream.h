@@ -0,0 +1,22 @@
+#ifndef IDECOMPRESSSTREAM_H
+#define IDECOMPRESSSTREAM_H
+
+#include <cstddef>
+
+using namespace std;
+
+// Interface declaration
+// A decompressed view of a file that is read piece by piece, so the whole content never has to be in memory.
+class IdecompressStream {
+public:
+
+    // Reads up to maxBytes decompressed bytes into buffer.
+    // Returns the number of bytes read, 0 means the end of the content was reached.
+    virtual size_t read(char* buffer, size_t maxBytes) = 0;
+
+    // no need for constructor in Interfaces.
+    // virtual destructor (every Interface should have a virtual destructor)
+    virtual ~IdecompressStream() = default;
+};
+
+#endif // IDECOMPRESSSTREAM_H
@@ -0,0 +1,30 @@
+#include "LaneExecutor.h"
+
+LaneExecutor::LaneExecutor(size_t numThreads)
+    : m_pool(numThreads, LanePool::defaultLimits(numThreads)) {
+}
+
+LaneExecutor::LaneExecutor(size_t numThreads, const std::vector<LaneLimits>& limits, const ThreadPlacement* placement,
+                           bool measureTasks)
+    : m_pool(numThreads, limits, placement, measureTasks) {
+}
+
+LaneExecutor::~LaneExecutor() {
+    shutdown();
+}
+
+void LaneExecutor::post(Task task) {
+    m_pool.addTask(std::move(task));
+}
+
+void LaneExecutor::post(Task task, int lane) {
+    m_pool.addTask(std::move(task), lane);
+}
+
+const TaskMetrics* LaneExecutor::metrics() const {
+    return m_pool.metrics();
+}
+
+void LaneExecutor::shutdown() {
+    m_pool.shutdown();
+}
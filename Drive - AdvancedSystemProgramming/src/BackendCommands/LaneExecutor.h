@@ -0,0 +1,33 @@
+#ifndef LANEEXECUTOR_H
+#define LANEEXECUTOR_H
+
+#include "IExecutor.h"
+#include "LanePool.h"
+
+// an executor that schedules the requests by their lane (see TaskLane), see LanePool
+class LaneExecutor : public IExecutor {
+private:
+    LanePool m_pool;
+
+public:
+    // default to number of hardware threads and LanePool::defaultLimits
+    LaneExecutor(size_t numThreads = std::thread::hardware_concurrency());
+    // the workers run where the placement says (nullptr - anywhere), measureTasks - keep TaskMetrics of the tasks
+    LaneExecutor(size_t numThreads, const std::vector<LaneLimits>& limits, const ThreadPlacement* placement = nullptr,
+                 bool measureTasks = false);
+    virtual ~LaneExecutor();
+
+    // add the task to the lane of the caller (the interactive lane from outside the pool), the pool owns it
+    void post(Task task) override;
+
+    // add the task to the lane, the pool owns it
+    void post(Task task, int lane) override;
+
+    // the metrics of the pool, nullptr unless measureTasks
+    const TaskMetrics* metrics() const override;
+
+    // stops the workers after their current tasks
+    void shutdown();
+};
+
+#endif // LANEEXECUTOR_H
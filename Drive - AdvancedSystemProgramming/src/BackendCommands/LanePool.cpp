@@ -0,0 +1,143 @@
+#include "LanePool.h"
+#include <algorithm>
+
+// the pool and lane of the task running on this thread, so tasks it adds stay in its lane
+static thread_local LanePool* currentPool = nullptr;
+static thread_local int currentLane = TaskLane::INTERACTIVE;
+
+LanePool::LanePool(size_t numThreads, const std::vector<LaneLimits>& limits, const ThreadPlacement* placement,
+                   bool measureTasks)
+    : m_lanes(TaskLane::COUNT), m_stopped(false), m_placement(placement) {
+    for (size_t i = 0; i < m_lanes.size() && i < limits.size(); i++) {
+        m_lanes[i].limits = limits[i];
+    }
+    if (numThreads == 0) {
+        numThreads = 1;
+    }
+    if (measureTasks) {
+        m_metrics.reset(new TaskMetrics(numThreads));
+    }
+    for (size_t i = 0; i < numThreads; ++i) {
+        m_workers.emplace_back(&LanePool::workerRoutine, this, i);
+    }
+}
+
+// it is ok to use non-default destructor because we need to join threads
+LanePool::~LanePool() {
+    shutdown();
+}
+
+const TaskMetrics* LanePool::metrics() const {
+    return m_metrics.get();
+}
+
+std::vector<LaneLimits> LanePool::defaultLimits(size_t numThreads) {
+    size_t allButOne = std::max<size_t>(numThreads, 2) - 1;
+    std::vector<LaneLimits> limits(TaskLane::COUNT);
+    limits[TaskLane::INTERACTIVE] = {8, 0};
+    limits[TaskLane::BULK] = {2, allButOne};
+    limits[TaskLane::BACKGROUND] = {1, 1};
+    return limits;
+}
+
+void LanePool::addTask(Task task, int lane) {
+    if (lane < 0 || lane >= TaskLane::COUNT) {
+        lane = currentPool == this ? currentLane : TaskLane::INTERACTIVE;
+    }
+    if (m_metrics != nullptr) {
+        task.setEnqueuedAt(TaskMetrics::now());
+    }
+    std::lock_guard<std::mutex> lock(m_lock);
+    if (m_stopped) { // only enqueue if still running
+        return;
+    }
+    m_lanes[lane].tasks.push_back(std::move(task));
+    m_ready.notify_one();
+}
+
+int LanePool::pickLane() {
+    // smooth weighted round robin (like nginx): every ready lane earns its weight, the richest lane is picked
+    // and pays the total. over time every lane gets weight / total of the picks, evenly spread
+    long total = 0;
+    int picked = -1;
+    for (int lane = 0; lane < (int)m_lanes.size(); lane++) {
+        Lane& candidate = m_lanes[lane];
+        bool ready = !candidate.tasks.empty() &&
+                     (candidate.limits.maxRunning == 0 || candidate.running < candidate.limits.maxRunning);
+        if (!ready) {
+            continue;
+        }
+        candidate.credit += candidate.limits.weight;
+        total += candidate.limits.weight;
+        if (picked == -1 || candidate.credit > m_lanes[picked].credit) {
+            picked = lane;
+        }
+    }
+    if (picked != -1) {
+        m_lanes[picked].credit -= total;
+    }
+    return picked;
+}
+
+void LanePool::workerRoutine(size_t index) {
+    currentPool = this;
+    if (m_placement != nullptr) {
+        m_placement->placeWorker(index);
+    }
+    std::unique_lock<std::mutex> lock(m_lock);
+    while (true) {
+        int lane;
+        m_ready.wait(lock, [this, &lane, index]() {
+            if (m_stopped || (lane = pickLane()) != -1) {
+                return true;
+            }
+            if (m_metrics != nullptr) {
+                m_metrics->idle(index); // a task kept queued (a lane at its maxRunning) waits while the worker sleeps
+            }
+            return false;
+        });
+        if (m_stopped) {
+            break;
+        }
+        // the task lives only for one round, so what it owns is freed as soon as it ran
+        Task task = std::move(m_lanes[lane].tasks.front());
+        m_lanes[lane].tasks.pop_front();
+        m_lanes[lane].running++;
+
+        lock.unlock();
+        currentLane = lane;
+        // an exception of the task is reported, the worker goes on
+        if (m_metrics != nullptr) {
+            m_metrics->run(index, task);
+        } else {
+            task.runAndReport();
+        }
+        task = Task();
+        lock.lock();
+
+        m_lanes[lane].running--;
+        if (!m_lanes[lane].tasks.empty()) {
+            // the lane may have waited for this worker to be under its maxRunning
+            m_ready.notify_one();
+        }
+    }
+}
+
+void LanePool::shutdown() {
+    std::vector<std::deque<Task>> dropped; // destroyed after the lock is released, a task may own anything
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        if (m_stopped) return;  // already stopped - do nothing
+        m_stopped = true;
+        for (Lane& lane : m_lanes) {
+            dropped.push_back(std::move(lane.tasks));
+            lane.tasks.clear();
+        }
+        m_ready.notify_all();
+    }
+    for (auto& worker : m_workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef LANEPOOL_H
+#define LANEPOOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Task.h"
+#include "TaskLane.h"
+#include "ThreadPlacement.h"
+#include "TaskMetrics.h"
+#include <memory>
+
+// how a lane shares the workers of a LanePool
+struct LaneLimits {
+    unsigned weight = 1;    // the share of the picks when other lanes have tasks too
+    size_t maxRunning = 0;  // the most workers that run tasks of the lane at once (0 - all of them)
+};
+
+/*
+* A thread pool with a queue per lane (see TaskLane) instead of one FIFO queue for all the tasks.
+* a free worker picks the next lane by smooth weighted round robin among the lanes that have tasks and are
+* below their maxRunning, and takes the oldest task of that lane. so a burst of searches in the bulk lane
+* gets at most its share of the picks, and (with maxRunning below the number of workers) always leaves a
+* worker for the interactive lane.
+* a task added from inside the pool goes to the lane of the task that added it (e.g. the helpers of a search),
+* a task added from outside without a lane goes to the interactive lane.
+*/
+class LanePool {
+private:
+    struct Lane {
+        std::deque<Task> tasks;
+        LaneLimits limits;
+        size_t running = 0;
+        long credit = 0; // of the weighted round robin
+    };
+
+    std::vector<Lane> m_lanes;   // one per TaskLane
+    std::vector<std::thread> m_workers;
+    std::mutex m_lock;           // guards the lanes and m_stopped
+    std::condition_variable m_ready;
+    bool m_stopped;
+    const ThreadPlacement* m_placement; // where the workers run (nullptr - anywhere)
+    std::unique_ptr<TaskMetrics> m_metrics; // queue wait and run time of the tasks (nullptr - not measured)
+
+    void workerRoutine(size_t index);
+
+    // the lane a free worker serves next, -1 if no lane may run a task now. the lock must be held
+    int pickLane();
+
+public:
+    // limits has one entry per lane (missing ones get the defaults of LaneLimits).
+    // placement pins the workers (see ThreadPlacement), it must outlive the pool.
+    // measureTasks - keep TaskMetrics of the tasks (a few clock reads per task)
+    LanePool(size_t numThreads, const std::vector<LaneLimits>& limits, const ThreadPlacement* placement = nullptr,
+             bool measureTasks = false);
+    ~LanePool();
+
+    LanePool(const LanePool&) = delete;
+    LanePool& operator=(const LanePool&) = delete;
+
+    // the pool owns the task, a task added after shutdown is dropped
+    void addTask(Task task, int lane = TaskLane::SAME_AS_CALLER);
+
+    // stops the workers after their current tasks. tasks still queued are destroyed without running
+    void shutdown();
+
+    // the metrics of the tasks of all the lanes, one slot per worker. nullptr if the pool does not measure them
+    const TaskMetrics* metrics() const;
+
+    // the limits for numThreads workers: interactive 8 / all, bulk 2 / all but one, background 1 / one
+    static std::vector<LaneLimits> defaultLimits(size_t numThreads);
+};
+
+#endif // LANEPOOL_H
@@ -0,0 +1,87 @@
+#include "LatencyHistogram.h"
+#include <cmath>
+
+void HistogramSnapshot::merge(const HistogramSnapshot& other) {
+    if (counts.size() < other.counts.size()) {
+        counts.resize(other.counts.size(), 0);
+    }
+    for (size_t bucket = 0; bucket < other.counts.size(); bucket++) {
+        counts[bucket] += other.counts[bucket];
+    }
+    count += other.count;
+    sum += other.sum;
+    if (other.max > max) {
+        max = other.max;
+    }
+}
+
+uint64_t HistogramSnapshot::percentile(double p) const {
+    if (count == 0) {
+        return 0;
+    }
+    // the rank of the value, counting from 1
+    uint64_t rank = static_cast<uint64_t>(std::ceil(p / 100.0 * count));
+    if (rank < 1) {
+        rank = 1;
+    }
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < counts.size(); bucket++) {
+        seen += counts[bucket];
+        if (seen >= rank) {
+            uint64_t highest = LatencyHistogram::highestValueOf(bucket);
+            return highest < max ? highest : max;
+        }
+    }
+    return max;
+}
+
+uint64_t HistogramSnapshot::mean() const {
+    return count == 0 ? 0 : sum / count;
+}
+
+LatencyHistogram::LatencyHistogram() : m_sum(0), m_max(0) {
+    for (std::atomic<uint64_t>& count : m_counts) {
+        count.store(0, std::memory_order_relaxed);
+    }
+}
+
+size_t LatencyHistogram::bucketOf(uint64_t value) noexcept {
+    if (value < SUB_BUCKETS) {
+        return static_cast<size_t>(value);
+    }
+    // the power of two of the value picks the group, its next SUB_BUCKET_BITS bits the bucket in the group
+    unsigned magnitude = 63 - __builtin_clzll(value);
+    unsigned shift = magnitude - SUB_BUCKET_BITS;
+    return SUB_BUCKETS + shift * SUB_BUCKETS + ((value >> shift) - SUB_BUCKETS);
+}
+
+uint64_t LatencyHistogram::highestValueOf(size_t bucket) noexcept {
+    if (bucket < SUB_BUCKETS) {
+        return bucket;
+    }
+    unsigned shift = static_cast<unsigned>((bucket - SUB_BUCKETS) / SUB_BUCKETS);
+    uint64_t top = SUB_BUCKETS + (bucket - SUB_BUCKETS) % SUB_BUCKETS;
+    return ((top + 1) << shift) - 1; // the last bucket wraps to the biggest uint64_t
+}
+
+void LatencyHistogram::record(uint64_t value) noexcept {
+    // a single writer, so a load and a store instead of a (locked) fetch_add
+    std::atomic<uint64_t>& count = m_counts[bucketOf(value)];
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    m_sum.store(m_sum.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    if (value > m_max.load(std::memory_order_relaxed)) {
+        m_max.store(value, std::memory_order_relaxed);
+    }
+}
+
+HistogramSnapshot LatencyHistogram::snapshot() const {
+    HistogramSnapshot result;
+    result.counts.resize(BUCKET_COUNT);
+    for (size_t bucket = 0; bucket < BUCKET_COUNT; bucket++) {
+        result.counts[bucket] = m_counts[bucket].load(std::memory_order_relaxed);
+        result.count += result.counts[bucket]; // counted from the buckets, so percentile always finds its rank
+    }
+    result.sum = m_sum.load(std::memory_order_relaxed);
+    result.max = m_max.load(std::memory_order_relaxed);
+    return result;
+}
@@ -0,0 +1,60 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// the counts of a LatencyHistogram at one moment, they can be merged (e.g. the histograms of all the workers)
+struct HistogramSnapshot {
+    std::vector<uint64_t> counts; // one per bucket of LatencyHistogram
+    uint64_t count = 0;           // values recorded
+    uint64_t sum = 0;
+    uint64_t max = 0;
+
+    void merge(const HistogramSnapshot& other);
+
+    // the value that p percent (0-100) of the values are at most, within the precision of the buckets. 0 if empty
+    uint64_t percentile(double p) const;
+
+    uint64_t mean() const;
+};
+
+/*
+* A histogram of values like latencies in nanoseconds, in the style of HdrHistogram: every power of two is
+* split into SUB_BUCKETS buckets, so a value is kept within 1/SUB_BUCKETS (6%) of itself, from 1ns to hours,
+* in a fixed array and with no allocation.
+* record is wait free, it is meant for a single writer (e.g. the worker that owns the histogram): it only does
+* relaxed loads and stores, so it costs about as much as a few plain increments. any thread may take a snapshot
+* at any time, it may miss the values that are being recorded at that moment.
+*/
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 4;
+    static constexpr uint64_t SUB_BUCKETS = uint64_t(1) << SUB_BUCKET_BITS;
+    // values below SUB_BUCKETS get a bucket each, then SUB_BUCKETS buckets for every power of two up to 2^64
+    static constexpr size_t BUCKET_COUNT = SUB_BUCKETS + (64 - SUB_BUCKET_BITS) * SUB_BUCKETS;
+
+    LatencyHistogram();
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    // only one thread may record at a time
+    void record(uint64_t value) noexcept;
+
+    HistogramSnapshot snapshot() const;
+
+    static size_t bucketOf(uint64_t value) noexcept;
+
+    // the biggest value that goes to the bucket
+    static uint64_t highestValueOf(size_t bucket) noexcept;
+
+private:
+    std::atomic<uint64_t> m_counts[BUCKET_COUNT];
+    std::atomic<uint64_t> m_sum;
+    std::atomic<uint64_t> m_max;
+};
+
+#endif // LATENCYHISTOGRAM_H
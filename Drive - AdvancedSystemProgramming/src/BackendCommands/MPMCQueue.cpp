@@ -0,0 +1,154 @@
+#include "MPMCQueue.h"
+#include <thread>
+
+// Define the static constants
+const int MPMCQueue::SPIN_LIMIT = 64;
+const size_t MPMCQueue::DEFAULT_CAPACITY = 4096;
+
+// a hint to the CPU that this thread spins (frees the core for its hyper thread sibling)
+static inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+MPMCQueue::MPMCQueue(size_t capacity) : m_enqueuePos(0), m_dequeuePos(0), m_running(true) {
+    size_t size = 2;
+    while (size < capacity) {
+        size *= 2;
+    }
+    m_buffer.reset(new Cell[size]);
+    m_mask = size - 1;
+    for (size_t i = 0; i < size; i++) {
+        m_buffer[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+MPMCQueue::~MPMCQueue() {
+    shutdown();
+}
+
+bool MPMCQueue::tryEnqueue(Task& item) {
+    size_t position = m_enqueuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+        cell = &m_buffer[position & m_mask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+        if (difference == 0) {
+            // the cell is free for this position, claim the position
+            if (m_enqueuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            return false; // the cell still holds a task of the previous round - full
+        } else {
+            position = m_enqueuePos.load(std::memory_order_relaxed); // another producer took it, try the next
+        }
+    }
+    cell->item = std::move(item);
+    // publishes the item to the consumer of this position
+    cell->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+bool MPMCQueue::tryDequeue(Task& item) {
+    size_t position = m_dequeuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+        cell = &m_buffer[position & m_mask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+        if (difference == 0) {
+            if (m_dequeuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            return false; // nothing was added at this position yet - empty
+        } else {
+            position = m_dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+    item = std::move(cell->item);
+    // frees the cell for the producer of the next round
+    cell->sequence.store(position + m_mask + 1, std::memory_order_release);
+    return true;
+}
+
+void MPMCQueue::enqueue(Task item) {
+    int spins = 0;
+    while (m_running.load(std::memory_order_relaxed)) {
+        if (tryEnqueue(item)) {
+            m_notEmpty.notifyOne();
+            return;
+        }
+        if (++spins < SPIN_LIMIT) {
+            cpuRelax();
+            continue;
+        }
+        // full for a while - sleep until a consumer makes room
+        uint32_t key = m_notFull.prepareWait();
+        if (tryEnqueue(item)) {
+            m_notFull.cancelWait();
+            m_notEmpty.notifyOne();
+            return;
+        }
+        if (!m_running) {
+            m_notFull.cancelWait();
+            return;
+        }
+        m_notFull.wait(key);
+    }
+}
+
+bool MPMCQueue::enqueueNoWait(Task& item) {
+    if (!tryEnqueue(item)) {
+        return false;
+    }
+    m_notEmpty.notifyOne();
+    return true;
+}
+
+bool MPMCQueue::dequeue(Task& item) {
+    int spins = 0;
+    while (m_running.load(std::memory_order_relaxed)) {
+        if (tryDequeue(item)) {
+            m_notFull.notifyOne();
+            return true;
+        }
+        if (++spins < SPIN_LIMIT) {
+            cpuRelax();
+            continue;
+        }
+        // empty for a while - sleep until a producer adds a task
+        uint32_t key = m_notEmpty.prepareWait();
+        if (tryDequeue(item)) {
+            m_notEmpty.cancelWait();
+            m_notFull.notifyOne();
+            return true;
+        }
+        if (!m_running) {
+            m_notEmpty.cancelWait();
+            break;
+        }
+        m_notEmpty.wait(key);
+    }
+    return false; // shut down
+}
+
+bool MPMCQueue::isEmpty() {
+    return m_dequeuePos.load() >= m_enqueuePos.load();
+}
+
+void MPMCQueue::shutdown() {
+    m_running = false;
+    m_notEmpty.notifyAll();
+    m_notFull.notifyAll();
+    // the consumers stop taking tasks now, the ones left are dropped here
+    Task dropped;
+    while (tryDequeue(dropped)) {
+        dropped = Task();
+    }
+}
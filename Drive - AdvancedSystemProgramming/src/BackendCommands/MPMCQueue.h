@@ -0,0 +1,68 @@
+#ifndef MPMCQUEUE_H
+#define MPMCQUEUE_H
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include "ITaskQueue.h"
+#include "EventCount.h"
+
+/*
+* A bounded lock free task queue for many producers and many consumers (Dmitry Vyukov's ring buffer).
+* every cell has a sequence number that tells whose turn it is: a producer may fill cell i when its sequence
+* is the enqueue position, a consumer may empty it when it is the position + 1. a producer or consumer claims
+* a position with one compare-and-swap, no thread ever waits for a lock held by another one.
+* a consumer of an empty queue (or a producer of a full one) spins for a while and then sleeps on an
+* EventCount, so an idle pool costs no CPU, and a busy one does no syscalls.
+*/
+class MPMCQueue : public ITaskQueue {
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        Task item;
+    };
+
+    // how many times a thread retries before it sleeps
+    static const int SPIN_LIMIT;
+
+    std::unique_ptr<Cell[]> m_buffer;
+    size_t m_mask;                                  // capacity - 1, the capacity is a power of 2
+    // the positions are on their own cache lines, producers and consumers do not slow each other down
+    alignas(64) std::atomic<size_t> m_enqueuePos;
+    alignas(64) std::atomic<size_t> m_dequeuePos;
+    alignas(64) std::atomic<bool> m_running;
+
+    EventCount m_notEmpty; // consumers wait here
+    EventCount m_notFull;  // producers wait here
+
+public:
+    static const size_t DEFAULT_CAPACITY;
+
+    // the capacity is rounded up to a power of 2
+    MPMCQueue(size_t capacity = DEFAULT_CAPACITY);
+    ~MPMCQueue() override;
+
+    MPMCQueue(const MPMCQueue&) = delete;
+    MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+    // moves the task in if there is room, false (and item is left as it was) if the queue is full
+    bool tryEnqueue(Task& item);
+
+    // moves a task out into item if there is one, false if the queue is empty
+    bool tryDequeue(Task& item);
+
+    // adds the task, waits while the queue is full. a task added after shutdown is dropped
+    void enqueue(Task item) override;
+
+    // adds the task (and wakes a consumer) if there is room, false if the queue is full
+    bool enqueueNoWait(Task& item) override;
+
+    // takes a task, waits while the queue is empty. false if the queue is shut down
+    bool dequeue(Task& item) override;
+
+    bool isEmpty() override;
+
+    void shutdown() override;
+};
+
+#endif // MPMCQUEUE_H
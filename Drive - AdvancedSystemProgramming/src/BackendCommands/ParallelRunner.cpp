@@ -0,0 +1,60 @@
+#include "ParallelRunner.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+// shared by the caller and the helpers. a helper may outlive the call, so it holds the state by shared_ptr
+struct ParallelLoopState {
+    const function<void(size_t)>* work; // only used while items are left, and the caller waits for those
+    size_t count;
+    atomic<size_t> next{0};
+    size_t done = 0;
+    mutex lock;
+    condition_variable allDone;
+
+    // takes items until there are none left
+    void runItems() {
+        size_t finished = 0;
+        size_t item;
+        while ((item = next.fetch_add(1)) < count) {
+            try {
+                (*work)(item);
+            } catch (...) {
+                // the item reports its own failure, the loop goes on
+            }
+            finished++;
+        }
+        if (finished > 0) {
+            lock_guard<mutex> guard(lock);
+            done += finished;
+            if (done == count) {
+                allDone.notify_all();
+            }
+        }
+    }
+};
+
+void ParallelRunner::forEach(IExecutor* executor, size_t count, const function<void(size_t)>& work, size_t maxHelpers,
+                             int lane) {
+    if (count == 0) {
+        return;
+    }
+    shared_ptr<ParallelLoopState> state = make_shared<ParallelLoopState>();
+    state->work = &work;
+    state->count = count;
+
+    if (executor != nullptr) {
+        size_t helpers = min(maxHelpers, count - 1);
+        for (size_t i = 0; i < helpers; i++) {
+            // a helper task on the executor, it holds the state until it is done (or dropped)
+            executor->post([state]() { state->runItems(); }, lane);
+        }
+    }
+    state->runItems();
+
+    // wait for the items the helpers took
+    unique_lock<mutex> guard(state->lock);
+    state->allDone.wait(guard, [&state]() { return state->done == state->count; });
+}
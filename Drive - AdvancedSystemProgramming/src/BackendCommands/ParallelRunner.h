@@ -0,0 +1,29 @@
+// Runs the items of one request in parallel
+#ifndef PARALLEL_RUNNER_H
+#define PARALLEL_RUNNER_H
+
+#include "IExecutor.h"
+#include "TaskLane.h"
+#include <cstddef>
+#include <functional>
+
+using namespace std;
+
+/*
+* splits a loop over items between the calling thread and helper tasks on an executor.
+* the caller works on the items too, so the loop finishes even if the executor is busy and the helpers
+* start late (or never) - they only take items that nobody took yet, and exit when there are none.
+*/
+class ParallelRunner {
+public:
+    /*
+    * Calls work(i) for every i in [0, count) and returns when all calls are done.
+    * @param executor - runs the helper tasks (nullptr - everything runs on the calling thread), it owns them.
+    * @param maxHelpers - the most helper tasks to add. work must be safe to call from several threads.
+    * @param lane - the lane of the helpers (see TaskLane), by default the lane of the caller.
+    */
+    static void forEach(IExecutor* executor, size_t count, const function<void(size_t)>& work, size_t maxHelpers,
+                        int lane = TaskLane::SAME_AS_CALLER);
+};
+
+#endif // PARALLEL_RUNNER_H
@@ -40,4 +40,8 @@ string RLEcompressor::decompressFile(string compressedContent) {
         i++; // Move to the next segment
     }
     return decompressed;
-};
\ No newline at end of file
+};
+
+unique_ptr<IdecompressStream> RLEcompressor::openDecompressStream(unique_ptr<istream> compressedContent) {
+    return make_unique<RLEdecompressStream>(std::move(compressedContent));
+}
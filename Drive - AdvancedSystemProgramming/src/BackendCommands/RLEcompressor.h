@@ -2,6 +2,7 @@
 #define RLECOMPRESSOR_H
 
 #include "Icompressor.h"
+#include "RLEdecompressStream.h"
 #include <string>
 
 using namespace std;
@@ -14,6 +15,9 @@ class RLEcompressor: public Icompressor {
     
     // Returns the decompressed content
     string decompressFile(string compressedContent) override;
+
+    // Returns a stream that decompresses the content one run at a time
+    unique_ptr<IdecompressStream> openDecompressStream(unique_ptr<istream> compressedContent) override;
     
     // virtual destructor
     ~RLEcompressor() override = default;
@@ -0,0 +1,60 @@
+#include "RLEdecompressStream.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <exception>
+#include <string>
+
+RLEdecompressStream::RLEdecompressStream(unique_ptr<istream> compressedContent)
+    : compressedContent(std::move(compressedContent)), inputBlock(INPUT_BLOCK_SIZE),
+      inputPosition(0), inputEnd(0), pendingCount(0), pendingChar(0) {
+}
+
+int RLEdecompressStream::nextByte() {
+    if (inputPosition == inputEnd) {
+        // refill the input block from the underlying stream
+        compressedContent->read(inputBlock.data(), inputBlock.size());
+        inputEnd = compressedContent->gcount();
+        inputPosition = 0;
+        if (inputEnd == 0) {
+            return -1; // end of the compressed content
+        }
+    }
+    return (unsigned char)inputBlock[inputPosition++];
+}
+
+bool RLEdecompressStream::readNextRun() {
+    // Extract count (number before the '/'), same format as RLEcompressor::decompressFile
+    string countStr;
+    int current = nextByte();
+    while (current != -1 && isdigit(current)) {
+        countStr += (char)current;
+        current = nextByte();
+    }
+    if (countStr.empty() && current == -1) {
+        return false; // clean end of the content
+    }
+    // current holds the '/' delimiter, the character to repeat comes right after it
+    int runChar = nextByte();
+    if (countStr.empty() || current == -1 || runChar == -1) {
+        throw exception(); // corrupted compressed content
+    }
+    pendingCount = stoull(countStr);
+    pendingChar = (char)runChar;
+    return true;
+}
+
+size_t RLEdecompressStream::read(char* buffer, size_t maxBytes) {
+    size_t filled = 0;
+    while (filled < maxBytes) {
+        if (pendingCount == 0 && !readNextRun()) {
+            break; // no more runs
+        }
+        // write as much of the current run as fits, the rest stays pending for the next read
+        size_t toWrite = (size_t)min<unsigned long long>(pendingCount, maxBytes - filled);
+        memset(buffer + filled, pendingChar, toWrite);
+        filled += toWrite;
+        pendingCount -= toWrite;
+    }
+    return filled;
+}
@@ -0,0 +1,40 @@
+#ifndef RLEDECOMPRESSSTREAM_H
+#define RLEDECOMPRESSSTREAM_H
+
+#include "IdecompressStream.h"
+#include <istream>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+// Decompresses RLE content ("count/char" runs) piece by piece.
+// only one input block and the current run are kept in memory, so a run of any length is split between reads.
+class RLEdecompressStream : public IdecompressStream {
+private:
+    static const size_t INPUT_BLOCK_SIZE = 64 * 1024;
+
+    unique_ptr<istream> compressedContent; // the compressed content we read from
+
+    vector<char> inputBlock; // block of compressed bytes read from compressedContent
+    size_t inputPosition;    // next unread byte in inputBlock
+    size_t inputEnd;         // number of valid bytes in inputBlock
+
+    unsigned long long pendingCount; // how many times pendingChar still has to be written
+    char pendingChar;                // the character of the current run
+
+    // Returns the next compressed byte, or -1 at the end of the content
+    int nextByte();
+
+    // Parses the next "count/char" run into pendingCount and pendingChar. returns false at the end of the content
+    bool readNextRun();
+
+public:
+    // Constructor
+    RLEdecompressStream(unique_ptr<istream> compressedContent);
+
+    // Decompresses the next part of the content into buffer
+    size_t read(char* buffer, size_t maxBytes) override;
+};
+
+#endif // RLEDECOMPRESSSTREAM_H
@@ -8,21 +8,25 @@ SafeQueue::~SafeQueue() {
 
 /*
  * adding a task to the queue
- * @param item: pointer to IRunnable
+ * @param item: the task, the queue owns it until it is taken
  * @return void
 */
-void SafeQueue::enqueue(IRunnable* item) {
+void SafeQueue::enqueue(Task item) {
     // lock the mutex, automatically unlocks when goes out of scope
     std::lock_guard<std::mutex> lock(m_mutex); 
-    m_queue.push(item);
+    if (!m_running) {
+        return; // shut down - the task is dropped (destroyed with item)
+    }
+    m_queue.push(std::move(item));
     m_cond.notify_one();
 }
 
 /*
     * retrieving a task from the queue
-    * @return pointer to IRunnable or nullptr if the queue is shut down
+    * @param item: gets the task
+    * @return false if the queue is shut down
 */
-IRunnable* SafeQueue::dequeue() {
+bool SafeQueue::dequeue(Task& item) {
     // lock the mutex, automatically unlocks when goes out of scope
     std::unique_lock<std::mutex> lock(m_mutex);
     
@@ -30,13 +34,13 @@ IRunnable* SafeQueue::dequeue() {
     m_cond.wait(lock, [this]() { return !m_queue.empty() || !m_running; });
 
     if (m_queue.empty() || !m_running) { // if shut down and no tasks left
-        return nullptr;
+        return false;
     }
-    // doing front and pop separately to avoid copying the item
-    IRunnable* item = m_queue.front();
+    // doing front and pop separately, the task is moved out before it is popped
+    item = std::move(m_queue.front());
     m_queue.pop();
 
-    return item;
+    return true;
 }
 
 /*
@@ -53,7 +57,9 @@ bool SafeQueue::isEmpty() {
  * shutting down the queue. not supposed to be used but in case of destructor call.
 */
 void SafeQueue::shutdown() {
+    std::queue<Task> dropped; // destroyed after the lock is released, a task may own anything
     std::lock_guard<std::mutex> lock(m_mutex);
     m_running = false;
+    m_queue.swap(dropped);
     m_cond.notify_all();
 }
\ No newline at end of file
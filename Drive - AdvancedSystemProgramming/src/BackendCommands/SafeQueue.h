@@ -4,30 +4,31 @@
 #include <queue>
 #include <mutex>
 #include <condition_variable>
-#include "IRunnable.h"
+#include "ITaskQueue.h"
 
-class SafeQueue {
+// a task queue behind one mutex, workers wait on a condition variable
+class SafeQueue : public ITaskQueue {
 private:
-    std::queue<IRunnable*> m_queue; // queue of IRunnable pointers
+    std::queue<Task> m_queue;       // queue of tasks, owned until they are taken
     std::mutex m_mutex;             // only one thread can access the queue at a time
     std::condition_variable m_cond; // to notify worker threads of new tasks - saves CPU cycles
     bool m_running;                 // indicates if the queue is still running  
 
 public:
     SafeQueue();
-    ~SafeQueue();
+    ~SafeQueue() override;
 
-    // adding a task to the queue(pointer to IRunnable)
-    void enqueue(IRunnable* item);
+    // adding a task to the queue
+    void enqueue(Task item) override;
 
     // retrieving a task from the queue
-    IRunnable* dequeue();
+    bool dequeue(Task& item) override;
 
     // test if the queue is empty. ONLY FOR OUTSIDE USE! OTHERWISE, USE m_queue.empty() TO NOT GET A DEADLOCK!!!
-    bool isEmpty();
+    bool isEmpty() override;
 
     // shutting down the queue
-    void shutdown();
+    void shutdown() override;
 };
 
 #endif // SAFEQUEUE_H
\ No newline at end of file
@@ -0,0 +1,35 @@
+#include "StreamScanner.h"
+#include "SubstringSearch.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+StreamScanner::StreamScanner(size_t chunkSize) : chunkSize(max<size_t>(chunkSize, 1)) {
+}
+
+bool StreamScanner::contains(IdecompressStream& stream, const string& pattern, const CancellationToken* token) const {
+    if (pattern.empty()) {
+        return true;
+    }
+    // the window holds the tail of the previous chunk followed by the new chunk
+    size_t overlap = pattern.size() - 1;
+    vector<char> window(overlap + chunkSize);
+    size_t carried = 0;
+
+    while (true) {
+        if (token != nullptr && token->shouldStop()) {
+            return false; // out of time or nobody waits for the result
+        }
+        size_t received = stream.read(window.data() + carried, chunkSize);
+        if (received == 0) {
+            return false; // end of the content, no match
+        }
+        size_t length = carried + received;
+        if (SubstringSearch::find(string_view(window.data(), length), pattern) != string_view::npos) {
+            return true;
+        }
+        // keep the last (pattern length - 1) bytes, a match may start there and end in the next chunk
+        carried = min(overlap, length);
+        memmove(window.data(), window.data() + length - carried, carried);
+    }
+}
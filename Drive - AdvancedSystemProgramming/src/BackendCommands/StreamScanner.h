@@ -0,0 +1,28 @@
+#ifndef STREAMSCANNER_H
+#define STREAMSCANNER_H
+
+#include "IdecompressStream.h"
+#include "CancellationToken.h"
+#include <string>
+
+using namespace std;
+
+// Looks for a pattern in a decompress stream using a fixed size window.
+// consecutive chunks overlap by (pattern length - 1) bytes so matches that cross a chunk boundary are found,
+// and peak memory depends only on the chunk size, not on the file size.
+class StreamScanner {
+private:
+    size_t chunkSize; // how many decompressed bytes are read at once
+
+public:
+    static const size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+    // Constructor
+    StreamScanner(size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+    // Returns true if pattern appears in the stream. stops reading at the first match.
+    // if a token is given it is checked between chunks, when it says stop the scan gives up and returns false
+    bool contains(IdecompressStream& stream, const string& pattern, const CancellationToken* token = nullptr) const;
+};
+
+#endif // STREAMSCANNER_H
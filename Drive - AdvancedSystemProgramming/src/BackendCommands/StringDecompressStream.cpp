@@ -0,0 +1,14 @@
+#include "StringDecompressStream.h"
+#include <algorithm>
+#include <cstring>
+
+StringDecompressStream::StringDecompressStream(string content)
+    : content(std::move(content)), position(0) {
+}
+
+size_t StringDecompressStream::read(char* buffer, size_t maxBytes) {
+    size_t toCopy = min(maxBytes, content.size() - position);
+    memcpy(buffer, content.data() + position, toCopy);
+    position += toCopy;
+    return toCopy;
+}
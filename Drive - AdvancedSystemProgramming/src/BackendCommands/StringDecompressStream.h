@@ -0,0 +1,24 @@
+#ifndef STRINGDECOMPRESSSTREAM_H
+#define STRINGDECOMPRESSSTREAM_H
+
+#include "IdecompressStream.h"
+#include <string>
+
+using namespace std;
+
+// A decompress stream over content that was already decompressed in memory.
+// used as the fallback for compressors that cannot decompress piece by piece.
+class StringDecompressStream : public IdecompressStream {
+private:
+    string content;  // the whole decompressed content
+    size_t position; // how much of the content was already read
+
+public:
+    // Constructor
+    StringDecompressStream(string content);
+
+    // Copies the next part of the content into buffer
+    size_t read(char* buffer, size_t maxBytes) override;
+};
+
+#endif // STRINGDECOMPRESSSTREAM_H
@@ -0,0 +1,127 @@
+#include "SubstringSearch.h"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SUBSTRING_SEARCH_X86
+#endif
+
+// verifies a candidate position whose first and last byte already match
+static bool matchesAt(const char* position, string_view needle) {
+    return needle.size() <= 2 || memcmp(position + 1, needle.data() + 1, needle.size() - 2) == 0;
+}
+
+// scans positions [start, end of haystack) without SIMD
+static size_t scalarFrom(string_view haystack, string_view needle, size_t start) {
+    const char* data = haystack.data();
+    size_t lastStart = haystack.size() - needle.size(); // caller guarantees needle fits
+    char first = needle[0];
+    char last = needle[needle.size() - 1];
+    size_t i = start;
+    while (i <= lastStart) {
+        const char* candidate = (const char*)memchr(data + i, first, lastStart - i + 1);
+        if (candidate == nullptr) {
+            return string_view::npos;
+        }
+        i = candidate - data;
+        if (data[i + needle.size() - 1] == last && matchesAt(candidate, needle)) {
+            return i;
+        }
+        i++;
+    }
+    return string_view::npos;
+}
+
+#ifdef SUBSTRING_SEARCH_X86
+
+static size_t findSSE2(string_view haystack, string_view needle) {
+    const char* data = haystack.data();
+    size_t lastOffset = needle.size() - 1;
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[lastOffset]);
+    size_t i = 0;
+    // each block checks 16 start positions, the last byte of the block's last candidate must be inside the haystack
+    for (; i + 16 + lastOffset <= haystack.size(); i += 16) {
+        __m128i blockFirst = _mm_loadu_si128((const __m128i*)(data + i));
+        __m128i blockLast = _mm_loadu_si128((const __m128i*)(data + i + lastOffset));
+        unsigned mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, blockFirst), _mm_cmpeq_epi8(last, blockLast)));
+        while (mask != 0) {
+            unsigned bit = __builtin_ctz(mask);
+            if (matchesAt(data + i + bit, needle)) {
+                return i + bit;
+            }
+            mask &= mask - 1; // clear the lowest candidate
+        }
+    }
+    return scalarFrom(haystack, needle, i);
+}
+
+__attribute__((target("avx2")))
+static size_t findAVX2(string_view haystack, string_view needle) {
+    const char* data = haystack.data();
+    size_t lastOffset = needle.size() - 1;
+    const __m256i first = _mm256_set1_epi8(needle[0]);
+    const __m256i last = _mm256_set1_epi8(needle[lastOffset]);
+    size_t i = 0;
+    for (; i + 32 + lastOffset <= haystack.size(); i += 32) {
+        __m256i blockFirst = _mm256_loadu_si256((const __m256i*)(data + i));
+        __m256i blockLast = _mm256_loadu_si256((const __m256i*)(data + i + lastOffset));
+        unsigned mask = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first, blockFirst), _mm256_cmpeq_epi8(last, blockLast)));
+        while (mask != 0) {
+            unsigned bit = __builtin_ctz(mask);
+            if (matchesAt(data + i + bit, needle)) {
+                return i + bit;
+            }
+            mask &= mask - 1;
+        }
+    }
+    return scalarFrom(haystack, needle, i);
+}
+
+// checked once, the first time it is needed
+static bool hasAVX2() {
+    static const bool supported = []() {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return supported;
+}
+
+#endif // SUBSTRING_SEARCH_X86
+
+size_t SubstringSearch::find(string_view haystack, string_view needle) {
+    if (needle.empty()) {
+        return 0;
+    }
+    if (needle.size() > haystack.size()) {
+        return string_view::npos;
+    }
+    if (needle.size() == 1) {
+        // a single byte needs no verification, memchr is already vectorized by the C library
+        const char* found = (const char*)memchr(haystack.data(), needle[0], haystack.size());
+        return found == nullptr ? string_view::npos : (size_t)(found - haystack.data());
+    }
+#ifdef SUBSTRING_SEARCH_X86
+    return hasAVX2() ? findAVX2(haystack, needle) : findSSE2(haystack, needle);
+#else
+    return scalarFrom(haystack, needle, 0);
+#endif
+}
+
+size_t SubstringSearch::findScalar(string_view haystack, string_view needle) {
+    if (needle.empty()) {
+        return 0;
+    }
+    if (needle.size() > haystack.size()) {
+        return string_view::npos;
+    }
+    return scalarFrom(haystack, needle, 0);
+}
+
+const char* SubstringSearch::implementationName() {
+#ifdef SUBSTRING_SEARCH_X86
+    return hasAVX2() ? "avx2" : "sse2";
+#else
+    return "scalar";
+#endif
+}
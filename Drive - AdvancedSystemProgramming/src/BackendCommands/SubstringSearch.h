@@ -0,0 +1,23 @@
+#ifndef SUBSTRINGSEARCH_H
+#define SUBSTRINGSEARCH_H
+
+#include <string_view>
+
+using namespace std;
+
+// Substring search kernel used by content search.
+// candidates are filtered by comparing the first and last byte of the pattern against a whole SIMD block at once,
+// and only positions where both match are verified with memcmp. machines without SIMD use the scalar version.
+class SubstringSearch {
+public:
+    // Returns the position of the first occurrence of needle in haystack, or string_view::npos
+    static size_t find(string_view haystack, string_view needle);
+
+    // Portable version without SIMD (memchr on the first byte + verification). used as the fallback
+    static size_t findScalar(string_view haystack, string_view needle);
+
+    // Name of the implementation find() uses on this machine ("avx2", "sse2" or "scalar")
+    static const char* implementationName();
+};
+
+#endif // SUBSTRINGSEARCH_H
@@ -0,0 +1,65 @@
+#include "Task.h"
+#include <exception>
+#include <iostream>
+
+Task::Task() noexcept : m_operations(nullptr), m_enqueuedAt(0) {
+}
+
+Task::Task(Task&& other) noexcept : m_operations(other.m_operations), m_enqueuedAt(other.m_enqueuedAt) {
+    if (m_operations != nullptr) {
+        m_operations->moveTo(other.m_storage, m_storage);
+        other.m_operations = nullptr;
+    }
+}
+
+Task& Task::operator=(Task&& other) noexcept {
+    if (this != &other) {
+        reset();
+        m_operations = other.m_operations;
+        m_enqueuedAt = other.m_enqueuedAt;
+        if (m_operations != nullptr) {
+            m_operations->moveTo(other.m_storage, m_storage);
+            other.m_operations = nullptr;
+        }
+    }
+    return *this;
+}
+
+Task::~Task() {
+    reset();
+}
+
+void Task::reset() noexcept {
+    if (m_operations != nullptr) {
+        m_operations->destroy(m_storage);
+        m_operations = nullptr;
+    }
+}
+
+Task::operator bool() const noexcept {
+    return m_operations != nullptr;
+}
+
+void Task::operator()() {
+    m_operations->invoke(m_storage);
+}
+
+bool Task::runAndReport() noexcept {
+    try {
+        (*this)();
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Task: exception in worker thread: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "Task: unknown exception in worker thread." << std::endl;
+    }
+    return false;
+}
+
+void Task::setEnqueuedAt(uint64_t time) noexcept {
+    m_enqueuedAt = time;
+}
+
+uint64_t Task::enqueuedAt() const noexcept {
+    return m_enqueuedAt;
+}
@@ -0,0 +1,123 @@
+#ifndef TASK_H
+#define TASK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/*
+* A unit of work that the executors own: any callable with no arguments (a lambda, a packaged_task...).
+* it is move only, so it may hold move only state (a unique_ptr to a connection, the promise of a future),
+* and whoever holds the Task owns that state - it is destroyed with the Task, whether it ran or not.
+* a small callable (up to INLINE_SIZE bytes, e.g. a lambda that captures a few pointers and a string) is kept inside the
+* Task itself, so queueing it allocates nothing. a bigger one is moved to the heap.
+*/
+class Task {
+public:
+    static constexpr size_t INLINE_SIZE = 8 * sizeof(void*);
+
+    // an empty task
+    Task() noexcept;
+
+    template <typename Callable,
+              typename = std::enable_if_t<!std::is_same<std::decay_t<Callable>, Task>::value>>
+    Task(Callable&& work);
+
+    Task(Task&& other) noexcept;
+    Task& operator=(Task&& other) noexcept;
+    ~Task();
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    // false for an empty (or moved from) task
+    explicit operator bool() const noexcept;
+
+    // runs the work, its exceptions go to the caller
+    void operator()();
+
+    /*
+    * runs the work for a worker of a pool. an exception that escapes a posted task has nobody to go to,
+    * so it is written to stderr instead of being lost (a task from IExecutor::submit keeps it in its future).
+    * @return false if the work threw
+    */
+    bool runAndReport() noexcept;
+
+    // when the task was added to a pool, for its TaskMetrics (0 - not stamped). it moves with the task
+    void setEnqueuedAt(uint64_t time) noexcept;
+    uint64_t enqueuedAt() const noexcept;
+
+private:
+    // what the task does with the callable it holds, one set of functions per callable type
+    struct Operations {
+        void (*invoke)(void* storage);
+        void (*moveTo)(void* from, void* to) noexcept; // moves the callable and destroys the old one
+        void (*destroy)(void* storage) noexcept;
+    };
+
+    // the callable lives in the storage
+    template <typename Callable>
+    struct InlineOperations {
+        static void invoke(void* storage) {
+            (*static_cast<Callable*>(storage))();
+        }
+        static void moveTo(void* from, void* to) noexcept {
+            new (to) Callable(std::move(*static_cast<Callable*>(from)));
+            static_cast<Callable*>(from)->~Callable();
+        }
+        static void destroy(void* storage) noexcept {
+            static_cast<Callable*>(storage)->~Callable();
+        }
+        static const Operations table;
+    };
+
+    // the storage holds a pointer to the callable
+    template <typename Callable>
+    struct HeapOperations {
+        static void invoke(void* storage) {
+            (**static_cast<Callable**>(storage))();
+        }
+        static void moveTo(void* from, void* to) noexcept {
+            *static_cast<Callable**>(to) = *static_cast<Callable**>(from);
+        }
+        static void destroy(void* storage) noexcept {
+            delete *static_cast<Callable**>(storage);
+        }
+        static const Operations table;
+    };
+
+    // moving a task must not throw (the queues move tasks around), so only a callable with a noexcept move fits inline
+    template <typename Callable>
+    static constexpr bool fitsInline() {
+        return sizeof(Callable) <= INLINE_SIZE && alignof(std::max_align_t) % alignof(Callable) == 0 &&
+               std::is_nothrow_move_constructible<Callable>::value;
+    }
+
+    void reset() noexcept;
+
+    alignas(std::max_align_t) unsigned char m_storage[INLINE_SIZE];
+    const Operations* m_operations; // nullptr - empty
+    uint64_t m_enqueuedAt;
+};
+
+template <typename Callable>
+const Task::Operations Task::InlineOperations<Callable>::table = {&invoke, &moveTo, &destroy};
+
+template <typename Callable>
+const Task::Operations Task::HeapOperations<Callable>::table = {&invoke, &moveTo, &destroy};
+
+template <typename Callable, typename>
+Task::Task(Callable&& work) : m_enqueuedAt(0) {
+    using Stored = std::decay_t<Callable>;
+    if constexpr (fitsInline<Stored>()) {
+        new (m_storage) Stored(std::forward<Callable>(work));
+        m_operations = &InlineOperations<Stored>::table;
+    } else {
+        *reinterpret_cast<Stored**>(m_storage) = new Stored(std::forward<Callable>(work));
+        m_operations = &HeapOperations<Stored>::table;
+    }
+}
+
+#endif // TASK_H
@@ -0,0 +1,18 @@
+#include "TaskLane.h"
+
+// Define the static constants
+const int TaskLane::INTERACTIVE;
+const int TaskLane::BULK;
+const int TaskLane::BACKGROUND;
+const int TaskLane::COUNT;
+const int TaskLane::SAME_AS_CALLER;
+
+string TaskLane::name(int lane) {
+    if (lane == BULK) {
+        return "bulk";
+    }
+    if (lane == BACKGROUND) {
+        return "background";
+    }
+    return "interactive";
+}
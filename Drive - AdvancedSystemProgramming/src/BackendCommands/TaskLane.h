@@ -0,0 +1,29 @@
+// The scheduling classes of the requests
+#ifndef TASK_LANE_H
+#define TASK_LANE_H
+
+#include <string>
+
+using namespace std;
+
+/*
+* every request runs in the lane of its command (see ICommands::lane), so slow requests can not hold up fast ones:
+* INTERACTIVE - finishes in microseconds (get, exists, delete, small posts), the lane with the most weight.
+* BULK - may run for seconds (search, large posts, big batches), never takes every worker.
+* BACKGROUND - nobody waits for it urgently (e.g. a big mdelete), one worker at most.
+* executors that do not schedule by lane (see IExecutor::post) ignore it.
+*/
+class TaskLane {
+public:
+    static const int INTERACTIVE = 0;
+    static const int BULK = 1;
+    static const int BACKGROUND = 2;
+    static const int COUNT = 3;
+    // the lane of the task that posts it (e.g. the helpers of a search), interactive from outside the pool
+    static const int SAME_AS_CALLER = -1;
+
+    // the name of the lane ("interactive", "bulk", "background"), e.g. for the STATS command
+    static string name(int lane);
+};
+
+#endif // TASK_LANE_H
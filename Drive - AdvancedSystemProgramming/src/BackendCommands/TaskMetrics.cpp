@@ -0,0 +1,64 @@
+#include "TaskMetrics.h"
+#include <chrono>
+
+TaskMetrics::TaskMetrics(size_t workers) {
+    for (size_t i = 0; i < workers; i++) {
+        m_workers.emplace_back(new WorkerMetrics());
+    }
+}
+
+uint64_t TaskMetrics::now() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void TaskMetrics::run(size_t worker, Task& task) noexcept {
+    WorkerMetrics& metrics = *m_workers[worker];
+    uint64_t enqueuedAt = task.enqueuedAt();
+    uint64_t started = enqueuedAt != 0 && enqueuedAt <= metrics.lastFinished ? metrics.lastFinished : now();
+    task.runAndReport();
+    uint64_t finished = now();
+    record(worker, enqueuedAt, started, finished);
+    metrics.lastFinished = finished;
+}
+
+void TaskMetrics::idle(size_t worker) noexcept {
+    m_workers[worker]->lastFinished = 0;
+}
+
+void TaskMetrics::record(size_t worker, uint64_t enqueuedAt, uint64_t startedAt, uint64_t finishedAt) noexcept {
+    WorkerMetrics& metrics = *m_workers[worker];
+    // a task that was not stamped (added before the metrics were on) has no queue wait to record
+    if (enqueuedAt != 0 && startedAt >= enqueuedAt) {
+        metrics.queueWait.record(startedAt - enqueuedAt);
+    }
+    metrics.runTime.record(finishedAt - startedAt);
+}
+
+size_t TaskMetrics::workerCount() const {
+    return m_workers.size();
+}
+
+HistogramSnapshot TaskMetrics::queueWait(size_t worker) const {
+    return m_workers[worker]->queueWait.snapshot();
+}
+
+HistogramSnapshot TaskMetrics::runTime(size_t worker) const {
+    return m_workers[worker]->runTime.snapshot();
+}
+
+HistogramSnapshot TaskMetrics::queueWait() const {
+    HistogramSnapshot result;
+    for (const std::unique_ptr<WorkerMetrics>& worker : m_workers) {
+        result.merge(worker->queueWait.snapshot());
+    }
+    return result;
+}
+
+HistogramSnapshot TaskMetrics::runTime() const {
+    HistogramSnapshot result;
+    for (const std::unique_ptr<WorkerMetrics>& worker : m_workers) {
+        result.merge(worker->runTime.snapshot());
+    }
+    return result;
+}
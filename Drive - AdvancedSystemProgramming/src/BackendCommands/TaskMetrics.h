@@ -0,0 +1,63 @@
+#ifndef TASKMETRICS_H
+#define TASKMETRICS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "LatencyHistogram.h"
+#include "Task.h"
+
+/*
+* What the tasks of a pool spent, to tell queueing from execution: for every worker, a histogram of how long
+* its tasks waited from addTask until the worker took them (queue wait) and one of how long they ran.
+* the pool stamps a task when it is added (Task::setEnqueuedAt) and the worker runs it through run().
+* a task that was queued before the worker finished its previous task started when that one finished, so
+* a busy worker reads the clock once per task, not twice. a worker that waits for a task in between (e.g. for
+* a lane under its limit) calls idle() first, so the next task reads the clock and the wait is queue wait.
+* every worker writes only its own histograms (on a cache line of their own), so recording takes no lock and
+* no shared write - a few clock reads and increments per task. STATS reads them while the pool runs.
+* the times are in nanoseconds of the steady clock.
+*/
+class TaskMetrics {
+private:
+    struct alignas(64) WorkerMetrics {
+        LatencyHistogram queueWait;
+        LatencyHistogram runTime;
+        uint64_t lastFinished = 0; // only the worker itself uses it
+    };
+
+    std::vector<std::unique_ptr<WorkerMetrics>> m_workers;
+
+public:
+    explicit TaskMetrics(size_t workers);
+
+    TaskMetrics(const TaskMetrics&) = delete;
+    TaskMetrics& operator=(const TaskMetrics&) = delete;
+
+    // the steady clock in nanoseconds, the time stamps of record
+    static uint64_t now() noexcept;
+
+    // runs the task for the worker (see Task::runAndReport) and records it. only the worker itself may call it
+    void run(size_t worker, Task& task) noexcept;
+
+    // the worker is going to wait for its next task, that task did not start when the last one finished.
+    // only the worker itself may call it
+    void idle(size_t worker) noexcept;
+
+    // a task of the worker that was added at enqueuedAt and ran from startedAt to finishedAt.
+    // only the worker itself may record for its index
+    void record(size_t worker, uint64_t enqueuedAt, uint64_t startedAt, uint64_t finishedAt) noexcept;
+
+    size_t workerCount() const;
+
+    // the histograms of one worker
+    HistogramSnapshot queueWait(size_t worker) const;
+    HistogramSnapshot runTime(size_t worker) const;
+
+    // the histograms of all the workers together
+    HistogramSnapshot queueWait() const;
+    HistogramSnapshot runTime() const;
+};
+
+#endif // TASKMETRICS_H
@@ -0,0 +1,89 @@
+#include "ThreadPlacement.h"
+#include <pthread.h>
+#include <sched.h>
+
+// Define the static constants
+const int ThreadPlacement::NONE;
+const int ThreadPlacement::CORES;
+const int ThreadPlacement::NODES;
+
+int ThreadPlacement::fromName(const string& name) {
+    if (name == "cores") {
+        return CORES;
+    }
+    if (name == "nodes") {
+        return NODES;
+    }
+    return NONE;
+}
+
+ThreadPlacement::ThreadPlacement(int policy, const CpuTopology& topology) : policy(policy), topology(topology) {
+}
+
+int ThreadPlacement::getPolicy() const {
+    return policy;
+}
+
+const CpuTopology& ThreadPlacement::getTopology() const {
+    return topology;
+}
+
+int ThreadPlacement::nodeForWorker(size_t index) const {
+    if (policy == NONE) {
+        return -1;
+    }
+    return static_cast<int>(index % topology.nodeCount());
+}
+
+vector<int> ThreadPlacement::cpusForWorker(size_t index) const {
+    if (policy == NONE) {
+        return {};
+    }
+    const vector<int>& cpus = topology.cpusOf(index % topology.nodeCount());
+    if (policy == NODES || cpus.empty()) {
+        return cpus;
+    }
+    // CORES - the workers of a node take its cores in turn
+    return {cpus[(index / topology.nodeCount()) % cpus.size()]};
+}
+
+bool ThreadPlacement::placeWorker(size_t index) const {
+    vector<int> cpus = cpusForWorker(index);
+    return !cpus.empty() && pinCurrentThread(cpus);
+}
+
+bool ThreadPlacement::placeOnNode(int node) const {
+    if (policy == NONE) {
+        return false;
+    }
+    if (node < 0 || node >= static_cast<int>(topology.nodeCount())) {
+        return pinCurrentThread(topology.allCpus());
+    }
+    return pinCurrentThread(topology.cpusOf(node));
+}
+
+bool ThreadPlacement::pinCurrentThread(const vector<int>& cpus) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+vector<int> ThreadPlacement::currentAffinity() {
+    vector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        return cpus;
+    }
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &set)) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
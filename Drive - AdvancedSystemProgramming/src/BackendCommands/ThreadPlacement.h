@@ -0,0 +1,55 @@
+#ifndef THREADPLACEMENT_H
+#define THREADPLACEMENT_H
+
+#include "CpuTopology.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/*
+* Where the threads of the server run (CPU affinity), so a worker stays next to the memory it uses.
+* NONE (the default) lets the kernel move threads freely. CORES pins every worker to a core of its own,
+* NODES pins every worker to all the cores of one NUMA node. the workers take the nodes in turn (worker 0 on
+* node 0, worker 1 on node 1...), so a pool smaller than the machine is spread over every node.
+* memory is placed on the node of the thread that touches it first (the Linux default), so the buffers a
+* pinned worker allocates are local to it without any NUMA library.
+*/
+class ThreadPlacement {
+private:
+    int policy;
+    CpuTopology topology;
+
+public:
+    static const int NONE = 0;
+    static const int CORES = 1;
+    static const int NODES = 2;
+
+    // Policy by its name ("none", "cores", "nodes"). unknown or empty names give NONE
+    static int fromName(const string& name);
+
+    ThreadPlacement(int policy = NONE, const CpuTopology& topology = CpuTopology::detect());
+
+    int getPolicy() const;
+    const CpuTopology& getTopology() const;
+
+    // the node of the index-th worker of a pool, -1 with NONE
+    int nodeForWorker(size_t index) const;
+
+    // the CPUs of the index-th worker of a pool (empty with NONE - anywhere)
+    vector<int> cpusForWorker(size_t index) const;
+
+    // pins the calling thread as the index-th worker of a pool. false with NONE or if the kernel refuses
+    bool placeWorker(size_t index) const;
+
+    // pins the calling thread to every CPU of the node (node -1: every CPU of the topology). false with NONE
+    bool placeOnNode(int node) const;
+
+    // pins the calling thread to the CPUs, false if the kernel refuses (e.g. none of them is allowed)
+    static bool pinCurrentThread(const vector<int>& cpus);
+
+    // the CPUs the calling thread may run on
+    static vector<int> currentAffinity();
+};
+
+#endif // THREADPLACEMENT_H
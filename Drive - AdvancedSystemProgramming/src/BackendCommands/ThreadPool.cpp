@@ -1,10 +1,15 @@
 #include "ThreadPool.h"
-#include <iostream>
 
-ThreadPool::ThreadPool(size_t numThreads) : m_stopped(false) {
+// the pool of the worker running on this thread, and its index (nullptr on other threads)
+static thread_local ThreadPool* currentPool = nullptr;
+static thread_local size_t currentWorker = 0;
+
+ThreadPool::ThreadPool(size_t numThreads, ITaskQueue* queue, const ThreadPlacement* placement, bool measureTasks)
+    : m_tasks(queue != nullptr ? queue : new SafeQueue()), m_stopped(false), m_placement(placement),
+      m_metrics(measureTasks ? new TaskMetrics(numThreads) : nullptr) {
     for (size_t i = 0; i < numThreads; ++i) {
         // emplace_back constructs a new thread, pushes it to the vector and starts it
-        m_workers.emplace_back(&ThreadPool::workerRoutine, this); 
+        m_workers.emplace_back(&ThreadPool::workerRoutine, this, i);
     }
 }
 
@@ -13,9 +18,16 @@ ThreadPool::~ThreadPool() {
     shutdown();
 }
 
-void ThreadPool::addTask(IRunnable* task) {
+void ThreadPool::addTask(Task task) {
     if (!m_stopped) { // only enqueue if still running
-        m_tasks.enqueue(task);
+        if (m_metrics != nullptr) {
+            task.setEnqueuedAt(TaskMetrics::now());
+        }
+        if (currentPool != this) {
+            m_tasks->enqueue(std::move(task));
+        } else if (!m_tasks->enqueueNoWait(task)) {
+            runTask(currentWorker, task); // full - waiting for room could leave no worker to make it
+        }
     }
 }
 
@@ -23,7 +35,7 @@ void ThreadPool::shutdown() {
     if (m_stopped) return;  // already stopped - do nothing
     
     m_stopped = true;       // mark as stopped
-    m_tasks.shutdown();
+    m_tasks->shutdown();
 
     for (auto& worker : m_workers) {
         // join each thread to wait for its completion
@@ -34,22 +46,34 @@ void ThreadPool::shutdown() {
     }
 }
 
-void ThreadPool::workerRoutine() {
+const TaskMetrics* ThreadPool::metrics() const {
+    return m_metrics.get();
+}
+
+void ThreadPool::runTask(size_t index, Task& task) {
+    // an exception of the task is reported, the worker goes on
+    if (m_metrics != nullptr) {
+        m_metrics->run(index, task);
+    } else {
+        task.runAndReport();
+    }
+}
+
+void ThreadPool::workerRoutine(size_t index) {
+    if (m_placement != nullptr) {
+        m_placement->placeWorker(index);
+    }
+    currentPool = this;
+    currentWorker = index;
     while (true) {
-        // SafeQueue::dequeue returns nullptr if shutdown has been called and the queue is empty
-        IRunnable* task = m_tasks.dequeue();
-        
-        if (task == nullptr) { // queue has been shut down and is empty
+        // the task lives only for one round, so what it owns (e.g. a connection) is freed as soon as it ran
+        Task task;
+        // SafeQueue::dequeue returns false if shutdown has been called
+        if (!m_tasks->dequeue(task)) { // queue has been shut down
             break;
         }
 
-        try {
-            task->run();
-        } catch (const std::exception& e) {
-            // std::cerr << "ThreadPool: Exception in worker thread: " << e.what() << std::endl;
-        } catch (...) {
-            // std::cerr << "ThreadPool: Unknown exception in worker thread." << std::endl;
-        }
+        runTask(index, task);
     }
     // if we reach here, it means shutdown was called and the queue is empty - exit the thread
 }
\ No newline at end of file
@@ -3,23 +3,40 @@
 
 #include <vector>
 #include <thread>
+#include <memory>
 #include "SafeQueue.h"
-#include "IRunnable.h"
+#include "ITaskQueue.h"
+#include "ThreadPlacement.h"
+#include "TaskMetrics.h"
+#include "Task.h"
 
 class ThreadPool {
 private:
     std::vector<std::thread> m_workers; // vector of worker threads
-    SafeQueue m_tasks;                  // thread-safe queue of tasks
+    std::unique_ptr<ITaskQueue> m_tasks; // thread-safe queue of tasks
     bool m_stopped;                     // indicates if the pool is stopped
+    const ThreadPlacement* m_placement; // where the workers run (nullptr - anywhere)
+    std::unique_ptr<TaskMetrics> m_metrics; // queue wait and run time of the tasks (nullptr - not measured)
 
-    void workerRoutine();               // routine for each worker thread. private for internal use only
+    void workerRoutine(size_t index);   // routine for each worker thread. private for internal use only
+    void runTask(size_t index, Task& task); // runs a task on the index-th worker (measured if the pool measures)
 
 public:
-    ThreadPool(size_t numThreads = std::thread::hardware_concurrency()); // default to num of hardware threads
+    // default to num of hardware threads. the pool owns the queue, nullptr - a SafeQueue.
+    // placement pins the workers (see ThreadPlacement), it must outlive the pool.
+    // measureTasks - keep TaskMetrics of the tasks (a few clock reads per task)
+    ThreadPool(size_t numThreads = std::thread::hardware_concurrency(), ITaskQueue* queue = nullptr,
+               const ThreadPlacement* placement = nullptr, bool measureTasks = false);
     ~ThreadPool();
 
-    void addTask(IRunnable* task);
+    // the pool owns the task, a task added after shutdown is dropped.
+    // a worker of the pool never waits here: if the queue is full (a bounded one) its task runs at once on the
+    // worker, since the workers that would make room may all be adding tasks too
+    void addTask(Task task);
     void shutdown();
+
+    // the metrics of the tasks, one slot per worker. nullptr if the pool does not measure them
+    const TaskMetrics* metrics() const;
 };
 
 #endif // THREADPOOL_H
\ No newline at end of file
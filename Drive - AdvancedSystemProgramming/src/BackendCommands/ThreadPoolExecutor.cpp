@@ -1,7 +1,8 @@
 #include "ThreadPoolExecutor.h"
 
-ThreadPoolExecutor::ThreadPoolExecutor(size_t numThreads) 
-    : m_pool(numThreads) {
+ThreadPoolExecutor::ThreadPoolExecutor(size_t numThreads, ITaskQueue* queue, const ThreadPlacement* placement,
+                                       bool measureTasks)
+    : m_pool(numThreads, queue, placement, measureTasks) {
 }
 
 // it is ok to use non-default destructor because we need to shutdown the pool
@@ -9,10 +10,13 @@ ThreadPoolExecutor::~ThreadPoolExecutor() {
     shutdown();
 }
 
-// add the task to the thread pool (by pointer)
-void ThreadPoolExecutor::execute(IRunnable& task) {
-    // pass the address (pointer) of the task to the Pool
-    m_pool.addTask(&task);
+// add the task to the thread pool, the pool owns it
+void ThreadPoolExecutor::post(Task task) {
+    m_pool.addTask(std::move(task));
+}
+
+const TaskMetrics* ThreadPoolExecutor::metrics() const {
+    return m_pool.metrics();
 }
 
 void ThreadPoolExecutor::shutdown() {
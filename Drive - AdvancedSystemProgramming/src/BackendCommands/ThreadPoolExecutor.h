@@ -9,12 +9,17 @@ private:
     ThreadPool m_pool;
 
 public:
-    // default to number of hardware threads
-    ThreadPoolExecutor(size_t numThreads = std::thread::hardware_concurrency());
+    // default to number of hardware threads. the tasks wait in the queue (owned by the pool, nullptr - a SafeQueue),
+    // the workers run where the placement says (nullptr - anywhere), measureTasks - keep TaskMetrics of the tasks
+    ThreadPoolExecutor(size_t numThreads = std::thread::hardware_concurrency(), ITaskQueue* queue = nullptr,
+                       const ThreadPlacement* placement = nullptr, bool measureTasks = false);
     virtual ~ThreadPoolExecutor();
 
-    // add the task to the thread pool (by pointer)
-    void execute(IRunnable& task) override;
+    // add the task to the thread pool, the pool owns it
+    void post(Task task) override;
+
+    // the metrics of the pool, nullptr unless measureTasks
+    const TaskMetrics* metrics() const override;
     
     // here we do need a shutdown method because we have a pool
     void shutdown();
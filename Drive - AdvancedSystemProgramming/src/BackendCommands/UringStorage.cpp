@@ -0,0 +1,94 @@
+#include "UringStorage.h"
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <exception>
+
+// the most bytes one read or write asks for (the length of an io_uring request is 32 bits)
+static const size_t MAX_TRANSFER = 1 << 30;
+
+UringStorage::UringStorage(FolderManager* folder, IoUring* ring, IExecutor* blockingExecutor,
+                           IExecutor* requestExecutor)
+    : AsyncStorage(folder, blockingExecutor, requestExecutor), m_folder(folder), m_ring(ring) {
+}
+
+AsyncTask<bool> UringStorage::isExists(std::string fileName) {
+    co_return m_folder->isExists(fileName);
+}
+
+AsyncTask<std::string> UringStorage::getContent(std::string fileName) {
+    std::filesystem::path path = m_folder->contentPath(fileName);
+    int file = co_await m_ring->openAt(path.c_str(), O_RDONLY | O_CLOEXEC, 0);
+    if (file < 0) {
+        printf("Could not open file %s\n", path.c_str());
+        throw std::exception();
+    }
+    // the size is in the inode, which the open brought to memory - fstat does not wait for the disk
+    struct stat info;
+    std::string content;
+    bool failed = fstat(file, &info) != 0;
+    if (!failed) {
+        content.resize(info.st_size);
+    }
+    size_t done = 0;
+    while (!failed && done < content.size()) {
+        unsigned size = static_cast<unsigned>(std::min(content.size() - done, MAX_TRANSFER));
+        int received = co_await m_ring->read(file, &content[done], size, done);
+        if (received <= 0) {
+            failed = received < 0;
+            content.resize(done); // the file is shorter than it was, e.g. it was replaced meanwhile
+            break;
+        }
+        done += received;
+    }
+    co_await m_ring->close(file);
+    if (failed) {
+        printf("Could not read file %s\n", path.c_str());
+        throw std::exception();
+    }
+    co_return content;
+}
+
+AsyncTask<bool> UringStorage::writeFile(std::filesystem::path path, const std::string& content) {
+    int file = co_await m_ring->openAt(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    if (file < 0) {
+        co_return false;
+    }
+    bool written = true;
+    size_t done = 0;
+    while (done < content.size()) {
+        unsigned size = static_cast<unsigned>(std::min(content.size() - done, MAX_TRANSFER));
+        int sent = co_await m_ring->write(file, content.data() + done, size, done);
+        if (sent <= 0) {
+            written = false;
+            break;
+        }
+        done += sent;
+    }
+    if (written) {
+        written = co_await m_ring->fsync(file) == 0;
+    }
+    int closed = co_await m_ring->close(file);
+    co_return written && closed == 0;
+}
+
+AsyncTask<bool> UringStorage::insertFile(std::string fileName, std::string content, std::filesystem::path filePath) {
+    std::filesystem::path fullFilePath;
+    if (!m_folder->beginInsert(fileName, filePath, fullFilePath)) {
+        co_return false;
+    }
+    bool written = co_await writeFile(fullFilePath, content);
+    co_return m_folder->finishInsert(fileName, fullFilePath, written);
+}
+
+AsyncTask<bool> UringStorage::deleteFile(std::string fileName) {
+    std::filesystem::path fullPath;
+    if (!m_folder->beginDelete(fileName, fullPath)) {
+        co_return false;
+    }
+    int result = co_await m_ring->unlink(fullPath.c_str());
+    // a file that is already gone counts as removed, like filesystem::remove
+    co_return m_folder->finishDelete(fileName, result == 0 || result == -ENOENT);
+}
@@ -0,0 +1,38 @@
+#ifndef URINGSTORAGE_H
+#define URINGSTORAGE_H
+
+#include <filesystem>
+#include <string>
+#include "AsyncStorage.h"
+#include "AsyncTask.h"
+#include "FolderManager.h"
+#include "IoUring.h"
+
+/*
+* The storage for coroutines that reads and writes the files of a FolderManager through an io_uring (see IoUring):
+* a coroutine that waits for the disk is suspended, and no thread waits with it - so the requests that wait for a
+* slow disk do not hold up the workers, and how many of them are served at once is not capped by the pool size.
+* the names stay in the FolderManager (in memory, under its lock), only the content files go through the ring:
+* open, read / write, fsync and close for a file, unlink to delete it.
+* everything else (e.g. a command without a coroutine form) runs on the blocking executor, like in AsyncStorage.
+*/
+class UringStorage : public AsyncStorage {
+private:
+    FolderManager* m_folder;
+    IoUring* m_ring;
+
+    // writes the content to a new file, and flushes it to the disk. false if any of it failed
+    AsyncTask<bool> writeFile(std::filesystem::path path, const std::string& content);
+
+public:
+    UringStorage(FolderManager* folder, IoUring* ring, IExecutor* blockingExecutor, IExecutor* requestExecutor);
+
+    // the names are in memory, answered at once
+    AsyncTask<bool> isExists(std::string fileName) override;
+    // throws exception if the file does not exist or can not be read (like FolderManager::getContent)
+    AsyncTask<std::string> getContent(std::string fileName) override;
+    AsyncTask<bool> insertFile(std::string fileName, std::string content, std::filesystem::path filePath) override;
+    AsyncTask<bool> deleteFile(std::string fileName) override;
+};
+
+#endif // URINGSTORAGE_H
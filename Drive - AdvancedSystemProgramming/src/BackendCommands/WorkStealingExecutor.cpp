@@ -0,0 +1,21 @@
+#include "WorkStealingExecutor.h"
+
+WorkStealingExecutor::WorkStealingExecutor(size_t numThreads, const ThreadPlacement* placement, bool measureTasks)
+    : m_pool(numThreads, placement, measureTasks) {
+}
+
+WorkStealingExecutor::~WorkStealingExecutor() {
+    shutdown();
+}
+
+void WorkStealingExecutor::post(Task task) {
+    m_pool.addTask(std::move(task));
+}
+
+const TaskMetrics* WorkStealingExecutor::metrics() const {
+    return m_pool.metrics();
+}
+
+void WorkStealingExecutor::shutdown() {
+    m_pool.shutdown();
+}
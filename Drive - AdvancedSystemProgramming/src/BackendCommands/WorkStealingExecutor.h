@@ -0,0 +1,29 @@
+#ifndef WORKSTEALINGEXECUTOR_H
+#define WORKSTEALINGEXECUTOR_H
+
+#include "IExecutor.h"
+#include "WorkStealingPool.h"
+
+// an executor for many short tasks (requests, batch helpers), see WorkStealingPool
+class WorkStealingExecutor : public IExecutor {
+private:
+    WorkStealingPool m_pool;
+
+public:
+    // default to number of hardware threads, the workers run where the placement says (nullptr - anywhere),
+    // measureTasks - keep TaskMetrics of the tasks
+    WorkStealingExecutor(size_t numThreads = std::thread::hardware_concurrency(),
+                         const ThreadPlacement* placement = nullptr, bool measureTasks = false);
+    virtual ~WorkStealingExecutor();
+
+    // add the task to the pool, the pool owns it
+    void post(Task task) override;
+
+    // the metrics of the pool, nullptr unless measureTasks
+    const TaskMetrics* metrics() const override;
+
+    // runs the tasks that are queued already and stops the workers
+    void shutdown();
+};
+
+#endif // WORKSTEALINGEXECUTOR_H
@@ -0,0 +1,131 @@
+#include "WorkStealingPool.h"
+
+// the pool and queue of the worker running on this thread, so tasks it adds go to its own queue
+static thread_local WorkStealingPool* currentPool = nullptr;
+static thread_local size_t currentQueue = 0;
+
+WorkStealingPool::WorkStealingPool(size_t numThreads, const ThreadPlacement* placement, bool measureTasks)
+    : m_pending(0), m_nextQueue(0), m_stopped(false), m_placement(placement), m_sleepers(0) {
+    if (numThreads == 0) {
+        numThreads = 1;
+    }
+    if (measureTasks) {
+        m_metrics.reset(new TaskMetrics(numThreads));
+    }
+    for (size_t i = 0; i < numThreads; ++i) {
+        m_queues.emplace_back(new WorkerQueue());
+    }
+    // the queues are all there before any worker may steal from them
+    for (size_t i = 0; i < numThreads; ++i) {
+        m_workers.emplace_back(&WorkStealingPool::workerRoutine, this, i);
+    }
+}
+
+// it is ok to use non-default destructor because we need to join threads
+WorkStealingPool::~WorkStealingPool() {
+    shutdown();
+}
+
+void WorkStealingPool::addTask(Task task) {
+    if (m_stopped) { // only enqueue if still running
+        return;
+    }
+    if (m_metrics != nullptr) {
+        task.setEnqueuedAt(TaskMetrics::now());
+    }
+    size_t index = currentPool == this ? currentQueue : m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+    // counted before it is queued, so a worker that sees no pending tasks can not miss it
+    m_pending.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(m_queues[index]->lock);
+        m_queues[index]->tasks.push_back(std::move(task));
+    }
+    // the lock is taken only to wake a sleeping worker, a busy pool never touches it
+    if (m_sleepers.load() > 0) {
+        std::lock_guard<std::mutex> lock(m_idleLock);
+        m_idle.notify_one();
+    }
+}
+
+const TaskMetrics* WorkStealingPool::metrics() const {
+    return m_metrics.get();
+}
+
+bool WorkStealingPool::take(size_t index, uint32_t& seed, Task& task) {
+    {
+        std::lock_guard<std::mutex> lock(m_queues[index]->lock);
+        if (!m_queues[index]->tasks.empty()) {
+            task = std::move(m_queues[index]->tasks.back());
+            m_queues[index]->tasks.pop_back();
+        }
+    }
+    // steal - every other queue once, starting at a random one (xorshift)
+    size_t count = m_queues.size();
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    for (size_t i = 0; !task && i < count; i++) {
+        size_t victim = (seed + i) % count;
+        if (victim == index) {
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(m_queues[victim]->lock);
+        if (!m_queues[victim]->tasks.empty()) {
+            task = std::move(m_queues[victim]->tasks.front());
+            m_queues[victim]->tasks.pop_front();
+        }
+    }
+    if (!task) {
+        return false;
+    }
+    m_pending.fetch_sub(1);
+    return true;
+}
+
+void WorkStealingPool::workerRoutine(size_t index) {
+    currentPool = this;
+    currentQueue = index;
+    if (m_placement != nullptr) {
+        m_placement->placeWorker(index);
+    }
+    uint32_t seed = static_cast<uint32_t>(index) * 2654435761u + 1;
+    while (true) {
+        // the task lives only for one round, so what it owns is freed as soon as it ran
+        Task task;
+        if (take(index, seed, task)) {
+            // an exception of the task is reported, the worker goes on
+            if (m_metrics != nullptr) {
+                m_metrics->run(index, task);
+            } else {
+                task.runAndReport();
+            }
+            continue;
+        }
+
+        // no task anywhere - sleep until one is added (or the pool stops)
+        if (m_metrics != nullptr) {
+            m_metrics->idle(index);
+        }
+        std::unique_lock<std::mutex> lock(m_idleLock);
+        m_sleepers.fetch_add(1);
+        m_idle.wait(lock, [this]() { return m_pending.load() > 0 || m_stopped; });
+        m_sleepers.fetch_sub(1);
+        if (m_stopped && m_pending.load() == 0) {
+            break; // shutdown was called and every task ran
+        }
+    }
+}
+
+void WorkStealingPool::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(m_idleLock);
+        if (m_stopped) return;  // already stopped - do nothing
+        m_stopped = true;
+        m_idle.notify_all();
+    }
+    for (auto& worker : m_workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
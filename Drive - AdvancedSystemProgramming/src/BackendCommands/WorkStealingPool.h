@@ -0,0 +1,68 @@
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include "Task.h"
+#include "ThreadPlacement.h"
+#include "TaskMetrics.h"
+
+/*
+* A thread pool where every worker has its own queue (deque) instead of one queue for all.
+* - a task added from a worker (e.g. the helpers of a batch) goes to the queue of that worker,
+*   a task added from outside the pool goes to the queues in turn.
+* - a worker takes its newest task first (its data is still in the cache), when its queue is empty
+*   it steals the oldest task of another worker, starting at a random one so thieves spread out.
+* every queue has its own lock, so workers and producers rarely wait for each other, and a producer
+* wakes a worker (notify) only when one is sleeping.
+*/
+class WorkStealingPool {
+private:
+    struct WorkerQueue {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> m_queues; // one per worker
+    std::vector<std::thread> m_workers;
+    std::atomic<size_t> m_pending;    // tasks in all the queues, the workers sleep when there are none
+    std::atomic<size_t> m_nextQueue;  // where the next task from outside the pool goes
+    std::atomic<bool> m_stopped;
+    const ThreadPlacement* m_placement; // where the workers run (nullptr - anywhere)
+    std::unique_ptr<TaskMetrics> m_metrics; // queue wait and run time of the tasks (nullptr - not measured)
+
+    std::mutex m_idleLock;            // only for sleeping and waking workers, never held while queues are used
+    std::condition_variable m_idle;
+    std::atomic<size_t> m_sleepers;
+
+    void workerRoutine(size_t index);
+
+    // takes a task for the worker: its own newest, or the oldest of another worker. false if there are none
+    bool take(size_t index, uint32_t& seed, Task& task);
+
+public:
+    // default to num of hardware threads. placement pins the workers (see ThreadPlacement), it must outlive the pool.
+    // measureTasks - keep TaskMetrics of the tasks (a few clock reads per task)
+    WorkStealingPool(size_t numThreads = std::thread::hardware_concurrency(), const ThreadPlacement* placement = nullptr,
+                     bool measureTasks = false);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // the pool owns the task, a task added after shutdown is dropped
+    void addTask(Task task);
+
+    // the workers run the tasks that are queued already, then stop. tasks added later are not run
+    void shutdown();
+
+    // the metrics of the tasks, one slot per worker (a stolen task counts for the thief). nullptr if not measured
+    const TaskMetrics* metrics() const;
+};
+
+#endif // WORKSTEALINGPOOL_H
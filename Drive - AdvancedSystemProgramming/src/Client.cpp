@@ -108,6 +108,12 @@ void Client::run() {
             send(sock, message);
             string response = receive(sock);
             cliManager.displayOutput(response);
+            // a streamed response (e.g. search with limit=/cursor=) sends data frames before its status line.
+            // a status line always has a space in it, data frames never do
+            while (response.substr(0, response.find('\n')).find(' ') == string::npos) {
+                response = receive(sock);
+                cliManager.displayOutput(response);
+            }
         } catch (const exception& e) {
             close(sock);
             throw; // Rethrow network errors to be handled by caller
@@ -201,6 +201,12 @@ class Client:
                 
                 # Display response to user (via CLIManager)
                 self.cli_manager.display_output(response)
+
+                # A streamed response (e.g. search with limit=/cursor=) sends data frames before its status line.
+                # A status line always has a space in it, data frames never do
+                while ' ' not in response.split('\n', 1)[0]:
+                    response = self.receive(sock)
+                    self.cli_manager.display_output(response)
                 
         except Exception as e:
             sock.close()
@@ -0,0 +1,68 @@
+#include "ConnectionContextPool.h"
+
+const size_t ConnectionContextPool::DEFAULT_MAX_IDLE = 256;
+
+ConnectionContext::ConnectionContext(const CommandRegistry* registry, CommandWrapper* commandWrapper,
+                                     chrono::milliseconds requestTimeBudget, IExecutor* requestExecutor,
+                                     AdmissionController* admission)
+    : csio(-1, commandWrapper), app(registry, &csio, &csio, requestTimeBudget, requestExecutor, admission) {
+    csio.setAdmission(admission);
+}
+
+void ConnectionContextPool::Returner::operator()(ConnectionContext* context) const {
+    pool->release(context);
+}
+
+ConnectionContextPool::ConnectionContextPool(const CommandRegistry* registry, CommandWrapper* commandWrapper,
+                                             chrono::milliseconds requestTimeBudget, IExecutor* requestExecutor,
+                                             AdmissionController* admission, size_t maxIdle)
+    : registry(registry), commandWrapper(commandWrapper), requestTimeBudget(requestTimeBudget),
+      requestExecutor(requestExecutor), admission(admission), maxIdle(maxIdle), created(0) {
+}
+
+ConnectionContextPool::~ConnectionContextPool() {
+    for (ConnectionContext* context : idle) {
+        delete context;
+    }
+}
+
+ConnectionContextPool::Context ConnectionContextPool::acquire(int clientSocket) {
+    ConnectionContext* context = nullptr;
+    {
+        lock_guard<mutex> guard(lock);
+        if (!idle.empty()) {
+            context = idle.back(); // the most recently used, its memory is the most likely to be in the cache
+            idle.pop_back();
+        } else {
+            created++;
+        }
+    }
+    if (context == nullptr) {
+        context = new ConnectionContext(registry, commandWrapper, requestTimeBudget, requestExecutor, admission);
+    }
+    context->csio.reset(clientSocket);
+    return Context(context, Returner{this});
+}
+
+void ConnectionContextPool::release(ConnectionContext* context) {
+    // the client sees the connection closed now, not when the context is reused
+    context->csio.closeSocket();
+    {
+        lock_guard<mutex> guard(lock);
+        if (idle.size() < maxIdle) {
+            idle.push_back(context);
+            return;
+        }
+    }
+    delete context;
+}
+
+size_t ConnectionContextPool::createdCount() {
+    lock_guard<mutex> guard(lock);
+    return created;
+}
+
+size_t ConnectionContextPool::idleCount() {
+    lock_guard<mutex> guard(lock);
+    return idle.size();
+}
@@ -0,0 +1,80 @@
+#ifndef CONNECTION_CONTEXT_POOL_H
+#define CONNECTION_CONTEXT_POOL_H
+
+#include "App.h"
+#include "CSIO.h"
+#include "CommandWrapper.h"
+#include "CommandRegistry.h"
+#include "IExecutor.h"
+#include "AdmissionController.h"
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+// everything one client connection (served by a thread) uses. the app reads and answers through the csio
+struct ConnectionContext {
+    CSIO csio;
+    App app;
+
+    ConnectionContext(const CommandRegistry* registry, CommandWrapper* commandWrapper,
+                      chrono::milliseconds requestTimeBudget, IExecutor* requestExecutor,
+                      AdmissionController* admission);
+};
+
+/*
+* a free list of connection contexts: a connection takes one that an earlier connection left (its socket reset,
+* see CSIO::reset), so accepting a connection allocates nothing once the pool has warmed up.
+* the commands are in the shared registry, a context only has the state of its connection.
+* up to maxIdle contexts are kept, the ones beyond it are freed when their connection ends.
+*/
+class ConnectionContextPool {
+public:
+    static const size_t DEFAULT_MAX_IDLE;
+
+    // gives the context back to its pool when the connection is done with it
+    struct Returner {
+        ConnectionContextPool* pool;
+        void operator()(ConnectionContext* context) const;
+    };
+
+    // a context taken from the pool, back in the pool when this is destroyed
+    using Context = unique_ptr<ConnectionContext, Returner>;
+
+private:
+    const CommandRegistry* registry;
+    CommandWrapper* commandWrapper;
+    chrono::milliseconds requestTimeBudget;
+    IExecutor* requestExecutor;
+    AdmissionController* admission;
+    size_t maxIdle;
+
+    mutex lock;
+    vector<ConnectionContext*> idle; // the free list
+    size_t created;                  // contexts made so far
+
+    // closes the socket of the context and keeps it (or frees it if enough are kept)
+    void release(ConnectionContext* context);
+
+public:
+    // the apps of the contexts run with these (see App). everything must outlive the pool
+    ConnectionContextPool(const CommandRegistry* registry, CommandWrapper* commandWrapper,
+                          chrono::milliseconds requestTimeBudget, IExecutor* requestExecutor,
+                          AdmissionController* admission, size_t maxIdle = DEFAULT_MAX_IDLE);
+    // frees the idle contexts, the ones in use must be back before
+    ~ConnectionContextPool();
+
+    ConnectionContextPool(const ConnectionContextPool&) = delete;
+    ConnectionContextPool& operator=(const ConnectionContextPool&) = delete;
+
+    // a context for the client socket (it owns the socket from now on): an idle one, or a new one if none is idle
+    Context acquire(int clientSocket);
+
+    // how many contexts were made, and how many wait for a connection now
+    size_t createdCount();
+    size_t idleCount();
+};
+
+#endif // CONNECTION_CONTEXT_POOL_H
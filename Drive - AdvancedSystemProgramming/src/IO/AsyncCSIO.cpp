@@ -0,0 +1,181 @@
+#include "AsyncCSIO.h"
+#include "CSIO.h"
+#include "ProtocolV2.h"
+#include "TcpPolicy.h"
+#include <algorithm>
+#include <exception>
+
+const int AsyncCSIO::PROTOCOL_UNKNOWN;
+const int AsyncCSIO::PROTOCOL_LEGACY;
+const int AsyncCSIO::PROTOCOL_V2;
+
+AsyncCSIO::AsyncCSIO(int clientSocket, IoReactor* reactor, CommandWrapper* commandWrapper)
+    : socket(clientSocket, reactor), commandWrapper(commandWrapper), readPosition(0),
+      protocolVersion(PROTOCOL_UNKNOWN), closed(false), tcpPolicy(TcpPolicy::NAGLE),
+      maxBodyLength(ProtocolV2::DEFAULT_MAX_BODY_LENGTH), admission(nullptr) {
+}
+
+// the body of a v2 request grows by at least this much at a time, as its bytes arrive (see CSIO)
+static const size_t BODY_CHUNK_BYTES = 64 * 1024;
+
+AsyncTask<void> AsyncCSIO::receiveMore() {
+    // drop the consumed requests before the buffer grows
+    if (readPosition > 0) {
+        readBuffer.erase(0, readPosition);
+        readPosition = 0;
+    }
+    char buffer[4096];
+    size_t received = 0;
+    try {
+        received = co_await socket.read(buffer, sizeof(buffer));
+    } catch (...) {
+        closed = true;
+        throw;
+    }
+    if (received == 0) {
+        closed = true;
+        throw exception(); // Connection closed by client
+    }
+    readBuffer.append(buffer, received);
+}
+
+AsyncTask<vector<string>> AsyncCSIO::getCommandAndArgs() {
+    if (protocolVersion == PROTOCOL_UNKNOWN) {
+        // the first 4 bytes tell the protocol. a legacy command may be shorter, then its newline tells
+        while (readBuffer.size() - readPosition < 4 && readBuffer.find('\n', readPosition) == string::npos) {
+            co_await receiveMore();
+        }
+        protocolVersion = ProtocolV2::hasMagic(string_view(readBuffer).substr(readPosition)) ? PROTOCOL_V2 : PROTOCOL_LEGACY;
+    }
+    if (protocolVersion == PROTOCOL_V2) {
+        co_return co_await getFrameV2();
+    }
+    co_return co_await getLegacyCommand();
+}
+
+AsyncTask<vector<string>> AsyncCSIO::getLegacyCommand() {
+    size_t searched = 0; // bytes after readPosition that have no newline
+    size_t newline;
+    while ((newline = readBuffer.find('\n', readPosition + searched)) == string::npos) {
+        searched = readBuffer.size() - readPosition;
+        co_await receiveMore();
+    }
+    string line = readBuffer.substr(readPosition, newline - readPosition);
+    readPosition = newline + 1;
+    co_return CSIO::splitCommand(line);
+}
+
+AsyncTask<vector<string>> AsyncCSIO::getFrameV2() {
+    ProtocolV2::FrameHeader header;
+    bool parsed;
+    try {
+        parsed = ProtocolV2::parseHeader(string_view(readBuffer).substr(readPosition), header);
+        while (!parsed) {
+            co_await receiveMore();
+            parsed = ProtocolV2::parseHeader(string_view(readBuffer).substr(readPosition), header);
+        }
+    } catch (...) {
+        // a bad magic means we lost the frame boundaries, nothing after it can be read
+        closed = true;
+        throw;
+    }
+    readPosition += ProtocolV2::HEADER_SIZE;
+    // the requests of the connection are answered in order, a concurrent one too
+    currentRequest.opcode = header.opcode;
+    currentRequest.requestId = header.requestId;
+    currentRequest.concurrent = false;
+    currentRequest.admittedBytes = 0;
+    // a body beyond the largest one, or that does not fit in the bytes in flight, is refused before it takes
+    // any memory
+    int refusal = 0;
+    if (header.bodyLength > maxBodyLength) {
+        refusal = CommandWrapper::STATUS_BAD_REQUEST;
+    } else if (admission != nullptr && !admission->admitBytes(header.bodyLength)) {
+        refusal = CommandWrapper::STATUS_SERVICE_UNAVAILABLE;
+    }
+    if (refusal != 0) {
+        // answered without reading the body, so the rest of the stream can not be followed
+        try {
+            co_await respond(currentRequest, refusal, "");
+        } catch (...) {
+            // the client is gone already
+        }
+        closed = true;
+        throw exception();
+    }
+
+    // take what is already buffered, the rest is received straight into the body
+    size_t buffered = min<uint64_t>(readBuffer.size() - readPosition, header.bodyLength);
+    string body = readBuffer.substr(readPosition, buffered);
+    readPosition += buffered;
+    size_t totalReceived = buffered;
+    while (totalReceived < header.bodyLength) {
+        if (totalReceived == body.size()) {
+            // the body grows with the bytes that came (doubling), not with the length the header claims
+            body.resize(min<uint64_t>(header.bodyLength, max(body.size() * 2, BODY_CHUNK_BYTES)));
+        }
+        size_t received = 0;
+        try {
+            received = co_await socket.read(&body[totalReceived], body.size() - totalReceived);
+        } catch (...) {
+            received = 0;
+        }
+        if (received == 0) {
+            closed = true;
+            if (admission != nullptr) {
+                admission->finishRequest(header.bodyLength); // the request will not run
+            }
+            throw exception(); // Failed to receive data from client or connection closed
+        }
+        totalReceived += received;
+    }
+    currentRequest.admittedBytes = admission != nullptr ? header.bodyLength : 0;
+
+    // an unknown opcode gives an empty command name, that is answered as a bad request
+    co_return vector<string>{ProtocolV2::commandName(header.opcode), body};
+}
+
+AsyncTask<void> AsyncCSIO::respond(RequestContext request, int statusCode, string data) {
+    string frame;
+    if (protocolVersion == PROTOCOL_V2) {
+        ProtocolV2::FrameHeader header;
+        header.opcode = request.opcode;
+        header.status = static_cast<uint16_t>(statusCode);
+        header.requestId = request.requestId;
+        header.bodyLength = data.size();
+        frame = ProtocolV2::encodeHeader(header) + data;
+    } else {
+        string output = commandWrapper->formatOutput(statusCode, data);
+        frame = CSIO::legacyLength(output.size()) + output;
+    }
+    try {
+        co_await socket.write(move(frame));
+    } catch (...) {
+        closed = true;
+        throw;
+    }
+    if (tcpPolicy == TcpPolicy::CORK) {
+        TcpPolicy::flush(socket.descriptor()); // the response is complete, do not hold it
+    }
+}
+
+RequestContext AsyncCSIO::lastRequest() const {
+    return currentRequest;
+}
+
+void AsyncCSIO::setTcpPolicy(int policy) {
+    tcpPolicy = policy;
+    TcpPolicy::apply(socket.descriptor(), policy);
+}
+
+void AsyncCSIO::setMaxBodyLength(uint64_t length) {
+    maxBodyLength = length;
+}
+
+void AsyncCSIO::setAdmission(AdmissionController* admissionController) {
+    admission = admissionController;
+}
+
+bool AsyncCSIO::isClosed() const {
+    return closed;
+}
@@ -0,0 +1,82 @@
+// Client-Server Input/Output for coroutines
+#ifndef ASYNC_CSIO_H
+#define ASYNC_CSIO_H
+
+#include "AsyncSocket.h"
+#include "AsyncTask.h"
+#include "CommandWrapper.h"
+#include "AdmissionController.h"
+#include "RequestContext.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/*
+* the coroutine form of CSIO: reads the requests of a client and sends the responses, in the legacy or the v2
+* protocol (decided by the first bytes, like CSIO), suspending instead of blocking while the socket waits.
+* the requests of a connection are answered in order, one at a time (App::runAsync), so nothing here is locked.
+*/
+class AsyncCSIO {
+private:
+    AsyncSocket socket;
+
+    // formats the status lines of legacy responses
+    CommandWrapper* commandWrapper;
+
+    // bytes received that were not handed out as a request yet, from readPosition on (see CSIO)
+    string readBuffer;
+    size_t readPosition;
+
+    static const int PROTOCOL_UNKNOWN = 0;
+    static const int PROTOCOL_LEGACY = 1;
+    static const int PROTOCOL_V2 = 2;
+    int protocolVersion;
+
+    // the last request read
+    RequestContext currentRequest;
+
+    // set once receiving or sending failed
+    bool closed;
+
+    // the TcpPolicy of the socket (CORK needs a flush after every response)
+    int tcpPolicy;
+
+    // the largest body of a v2 request frame, see ProtocolV2::DEFAULT_MAX_BODY_LENGTH
+    uint64_t maxBodyLength;
+
+    // admits the body of a v2 request before it is received (nullptr - no limits)
+    AdmissionController* admission;
+
+    // receives more bytes into readBuffer. throws exception if the connection is closed
+    AsyncTask<void> receiveMore();
+
+    AsyncTask<vector<string>> getLegacyCommand();
+    AsyncTask<vector<string>> getFrameV2();
+
+public:
+    AsyncCSIO(int clientSocket, IoReactor* reactor, CommandWrapper* commandWrapper);
+
+    // the next request: command and arguments. throws exception if the connection is closed (isClosed)
+    // or the request is bad (a legacy line without arguments)
+    AsyncTask<vector<string>> getCommandAndArgs();
+
+    // the id of the last request (v2 only)
+    RequestContext lastRequest() const;
+
+    // sends the response of the request in the protocol of the client. throws exception if sending failed
+    AsyncTask<void> respond(RequestContext request, int statusCode, string data);
+
+    // set the TcpPolicy of the socket
+    void setTcpPolicy(int policy);
+
+    // set the largest body a v2 request may have, a bigger one is answered with 400 and the connection closed
+    void setMaxBodyLength(uint64_t length);
+
+    // admit the body of every v2 request before it is received, like CSIO::setAdmission (503 if it does not fit)
+    void setAdmission(AdmissionController* admissionController);
+
+    bool isClosed() const;
+};
+
+#endif // ASYNC_CSIO_H
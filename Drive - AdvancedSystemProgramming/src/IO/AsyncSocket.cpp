@@ -0,0 +1,55 @@
+#include "AsyncSocket.h"
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <exception>
+
+AsyncSocket::AsyncSocket(int socket, IoReactor* reactor) : socket(socket), reactor(reactor) {
+    fcntl(socket, F_SETFL, fcntl(socket, F_GETFL) | O_NONBLOCK);
+}
+
+AsyncSocket::~AsyncSocket() {
+    reactor->forget(socket);
+    close(socket);
+}
+
+AsyncTask<size_t> AsyncSocket::read(char* buffer, size_t size) {
+    while (true) {
+        // try first, most reads of a busy connection find data already
+        ssize_t received = ::recv(socket, buffer, size, 0);
+        if (received >= 0) {
+            co_return static_cast<size_t>(received);
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            throw exception(); // Failed to receive data from client
+        }
+        co_await reactor->readable(socket);
+    }
+}
+
+AsyncTask<void> AsyncSocket::write(string data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        // MSG_NOSIGNAL - a closed client makes send fail instead of killing the server with SIGPIPE
+        ssize_t written = ::send(socket, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (written >= 0) {
+            sent += written;
+            continue;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            throw exception(); // Failed to send, the connection is closed
+        }
+        co_await reactor->writable(socket);
+    }
+}
+
+int AsyncSocket::descriptor() const {
+    return socket;
+}
@@ -0,0 +1,39 @@
+// A non blocking socket for coroutines
+#ifndef ASYNC_SOCKET_H
+#define ASYNC_SOCKET_H
+
+#include "AsyncTask.h"
+#include "IoReactor.h"
+#include <cstddef>
+#include <string>
+
+using namespace std;
+
+/*
+* reads and writes suspend the coroutine (see IoReactor) instead of blocking its thread.
+* the socket is made non blocking and is owned: it is closed with the AsyncSocket.
+* one read and one write may wait at a time (one coroutine per connection, like App::runAsync).
+*/
+class AsyncSocket {
+private:
+    int socket;
+    IoReactor* reactor;
+
+public:
+    AsyncSocket(int socket, IoReactor* reactor);
+    ~AsyncSocket();
+
+    AsyncSocket(const AsyncSocket&) = delete;
+    AsyncSocket& operator=(const AsyncSocket&) = delete;
+
+    // receives what came, up to size bytes, suspends until something did. 0 - the peer closed the connection.
+    // throws exception if receiving failed
+    AsyncTask<size_t> read(char* buffer, size_t size);
+
+    // sends all the data, suspends while the socket is full. throws exception if sending failed
+    AsyncTask<void> write(string data);
+
+    int descriptor() const;
+};
+
+#endif // ASYNC_SOCKET_H
@@ -36,3 +36,12 @@ void CLIManager::displayCommands(map<string, ICommands*> commands) const {
 void CLIManager::displayOutput(string output) const {
     cout << output ; // Display the output message
 }
+void CLIManager::displayResponse(int statusCode, const string& data) const {
+    cout << statusCode << endl;
+    if (!data.empty()) {
+        cout << data << endl;
+    }
+}
+void CLIManager::displayPartialResponse(const string& data) const {
+    cout << data; // items of a streamed command, one per line
+}
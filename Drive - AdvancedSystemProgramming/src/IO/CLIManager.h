@@ -31,6 +31,12 @@ public:
     // Implementing Ioutput interface
     void displayOutput(string output) const override;
 
+    // Implementing Ioutput interface - prints the status code and the data
+    void displayResponse(int statusCode, const string& data) const override;
+
+    // Implementing Ioutput interface - prints the data
+    void displayPartialResponse(const string& data) const override;
+
     // virtual destructor
     ~CLIManager() = default;
 };
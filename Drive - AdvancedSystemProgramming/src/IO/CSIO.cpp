@@ -1,26 +1,194 @@
 #include "CSIO.h"
 
 CSIO::CSIO(int clientSocket, CommandWrapper* commandWrapper) 
-: clientSocket(clientSocket), commandWrapper(commandWrapper) {
+: clientSocket(clientSocket), commandWrapper(commandWrapper), closed(false), readPosition(0),
+  protocolVersion(PROTOCOL_UNKNOWN), maxBodyLength(ProtocolV2::DEFAULT_MAX_BODY_LENGTH), admission(nullptr),
+  tcpPolicy(TcpPolicy::NAGLE), concurrentPending(0), reaped(false) {
 }
 
-vector<string> CSIO::getCommandAndArgs() {
-    string receivedData;
+// a read buffer that grew beyond this (a big request) is freed when the object is reset, not kept for the next connection
+static const size_t KEPT_BUFFER_BYTES = 64 * 1024;
+
+// the body of a v2 request grows by at least this much at a time, as its bytes arrive
+static const size_t BODY_CHUNK_BYTES = 64 * 1024;
+
+// Define the static constants
+const int CSIO::PROTOCOL_UNKNOWN;
+const int CSIO::PROTOCOL_LEGACY;
+const int CSIO::PROTOCOL_V2;
+
+void CSIO::receiveMore() {
+    bool betweenRequests = readPosition == readBuffer.size();
+    // drop the consumed commands before the buffer grows
+    if (readPosition > 0) {
+        readBuffer.erase(0, readPosition);
+        readPosition = 0;
+    }
+    waitForData(betweenRequests);
+    char buffer[4096];
+    int bytesReceived = ::recv(clientSocket, buffer, sizeof(buffer), 0);
+    if (bytesReceived == -1) {
+        closed = true;
+        throw exception(); // Failed to receive data from client
+    } else if (bytesReceived == 0) {
+        closed = true;
+        throw exception(); // Connection closed by client
+    }
+    if (betweenRequests) {
+        requestDeadline = chrono::steady_clock::now() + timeouts.read; // the first bytes of a request
+    }
+    readBuffer.append(buffer, bytesReceived);
+}
+
+void CSIO::waitForData(bool betweenRequests) {
+    chrono::milliseconds limit = betweenRequests ? timeouts.idle : timeouts.read;
+    if (limit.count() <= 0) {
+        return; // no limit, recv waits as long as it takes
+    }
     while (true) {
-        char buffer[4096];
-        int bytesReceived = ::recv(clientSocket, buffer, sizeof(buffer), 0);
-        if (bytesReceived == -1) {
-            throw exception(); // Failed to receive data from client
-        } else if (bytesReceived == 0) {
-            throw exception(); // Connection closed by client
+        chrono::milliseconds timeout = limit;
+        if (!betweenRequests) {
+            timeout = max(chrono::milliseconds(0),
+                          chrono::duration_cast<chrono::milliseconds>(requestDeadline - chrono::steady_clock::now()));
         }
-        receivedData.append(buffer, bytesReceived);
-        // Check if we have received a full command (ending with newline)
-        if (!receivedData.empty() && receivedData.back() == '\n') {
-            receivedData.pop_back(); // Remove the newline character
-            break;
+        pollfd descriptor;
+        descriptor.fd = clientSocket;
+        descriptor.events = POLLIN;
+        descriptor.revents = 0;
+        int ready = ::poll(&descriptor, 1, static_cast<int>(timeout.count()));
+        if (ready == -1 && errno == EINTR) {
+            continue;
         }
+        if (ready != 0) {
+            return; // data, a hang up or an error - recv tells which
+        }
+        if (betweenRequests && concurrentPending > 0) {
+            continue; // a request of the connection still runs, the client waits for it
+        }
+        reap();
+        throw exception(); // the client was silent for too long
+    }
+}
+
+void CSIO::reap() const {
+    reaped = true;
+    closed = true;
+    ::shutdown(clientSocket, SHUT_RDWR);
+}
+
+vector<string> CSIO::getCommandAndArgs() {
+    if (readPosition < readBuffer.size()) {
+        // a part of the request came with the one before it (pipelined), its read timeout starts now
+        requestDeadline = chrono::steady_clock::now() + timeouts.read;
+    }
+    if (protocolVersion == PROTOCOL_UNKNOWN) {
+        // the first 4 bytes tell the protocol. a legacy command may be shorter, then its newline tells
+        while (readBuffer.size() - readPosition < 4 && readBuffer.find('\n', readPosition) == string::npos) {
+            receiveMore();
+        }
+        protocolVersion = ProtocolV2::hasMagic(string_view(readBuffer).substr(readPosition)) ? PROTOCOL_V2 : PROTOCOL_LEGACY;
+    }
+    if (protocolVersion == PROTOCOL_V2) {
+        return getFrameV2();
+    }
+    return getLegacyCommand();
+}
+
+vector<string> CSIO::getLegacyCommand() {
+    // look for a full command (ending with newline) in what we already have, receive more only if there is none
+    size_t searched = 0; // bytes after readPosition that have no newline
+    size_t newline;
+    while ((newline = readBuffer.find('\n', readPosition + searched)) == string::npos) {
+        searched = readBuffer.size() - readPosition;
+        receiveMore();
+    }
+    // take the command (without the newline), whatever comes after it stays for the next call
+    string receivedData = readBuffer.substr(readPosition, newline - readPosition);
+    readPosition = newline + 1;
+    if (readPosition == readBuffer.size()) {
+        readBuffer.clear();
+        readPosition = 0;
     }
+    return splitCommand(receivedData);
+}
+
+vector<string> CSIO::getFrameV2() {
+    // the header is parsed in place, from the read buffer
+    ProtocolV2::FrameHeader header;
+    try {
+        while (!ProtocolV2::parseHeader(string_view(readBuffer).substr(readPosition), header)) {
+            receiveMore();
+        }
+    } catch (...) {
+        // a bad magic means we lost the frame boundaries, nothing after it can be read
+        closed = true;
+        throw;
+    }
+    readPosition += ProtocolV2::HEADER_SIZE;
+    if (header.bodyLength > maxBodyLength) {
+        rejectFrame(header, CommandWrapper::STATUS_BAD_REQUEST);
+    }
+    // the bytes in flight are counted from here, before the body takes any memory
+    if (admission != nullptr && !admission->admitBytes(header.bodyLength)) {
+        rejectFrame(header, CommandWrapper::STATUS_SERVICE_UNAVAILABLE);
+    }
+
+    // take what is already buffered, the rest is received straight into the body (no copy through readBuffer)
+    size_t buffered = min<uint64_t>(readBuffer.size() - readPosition, header.bodyLength);
+    string body = readBuffer.substr(readPosition, buffered);
+    readPosition += buffered;
+    if (readPosition == readBuffer.size()) {
+        readBuffer.clear();
+        readPosition = 0;
+    }
+    size_t totalReceived = buffered;
+    try {
+        while (totalReceived < header.bodyLength) {
+            if (totalReceived == body.size()) {
+                // the body grows with the bytes that came (doubling), not with the length the header claims
+                body.resize(min<uint64_t>(header.bodyLength, max(body.size() * 2, BODY_CHUNK_BYTES)));
+            }
+            waitForData(false);
+            ssize_t bytesReceived = ::recv(clientSocket, &body[totalReceived], body.size() - totalReceived, 0);
+            if (bytesReceived <= 0) {
+                closed = true;
+                throw exception(); // Failed to receive data from client or connection closed
+            }
+            totalReceived += bytesReceived;
+        }
+    } catch (...) {
+        if (admission != nullptr) {
+            admission->finishRequest(header.bodyLength); // the request will not run
+        }
+        throw;
+    }
+
+    currentRequest.opcode = header.opcode;
+    currentRequest.requestId = header.requestId;
+    currentRequest.concurrent = (header.flags & ProtocolV2::FLAG_CONCURRENT) != 0;
+    currentRequest.admittedBytes = admission != nullptr ? header.bodyLength : 0;
+    if (currentRequest.concurrent) {
+        concurrentPending++;
+    }
+    // an unknown opcode gives an empty command name, that is answered as a bad request
+    return {ProtocolV2::commandName(header.opcode), body};
+}
+
+void CSIO::rejectFrame(const ProtocolV2::FrameHeader& header, int statusCode) {
+    currentRequest.opcode = header.opcode;
+    currentRequest.requestId = header.requestId;
+    currentRequest.concurrent = false;
+    currentRequest.admittedBytes = 0;
+    try {
+        displayResponse(statusCode, "");
+    } catch (...) {
+        // the client is gone already
+    }
+    closed = true;
+    throw exception();
+}
+
+vector<string> CSIO::splitCommand(const string& receivedData) {
     // Split the received data into command and arguments
     vector<string> commandAndArgs;
     // check if there is a space to separate command and arguments
@@ -37,25 +205,221 @@ vector<string> CSIO::getCommandAndArgs() {
     return commandAndArgs;
 }
 
+// a part of a message, pointing to bytes that live elsewhere (nothing is copied)
+static iovec part(const char* data, size_t length) {
+    iovec vector;
+    vector.iov_base = const_cast<char*>(data);
+    vector.iov_len = length;
+    return vector;
+}
+
+void CSIO::sendAll(iovec* parts, int count) const {
+    while (count > 0) {
+        msghdr message;
+        memset(&message, 0, sizeof(message));
+        message.msg_iov = parts;
+        message.msg_iovlen = count;
+        // MSG_NOSIGNAL - a closed client makes send fail instead of killing the server with SIGPIPE
+        ssize_t sent = ::sendmsg(clientSocket, &message, MSG_NOSIGNAL);
+        if (sent == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                reap(); // the write timeout passed, the client does not read its responses
+            }
+            closed = true;
+            throw exception();
+        }
+        // skip the parts that were sent, the last one may be sent only partially
+        while (count > 0 && static_cast<size_t>(sent) >= parts->iov_len) {
+            sent -= parts->iov_len;
+            parts++;
+            count--;
+        }
+        if (count > 0) {
+            parts->iov_base = static_cast<char*>(parts->iov_base) + sent;
+            parts->iov_len -= sent;
+        }
+    }
+}
+
+string CSIO::legacyLength(size_t length) {
+    string header = to_string(length);
+    while (header.length() < 8) {
+        header += " ";
+    }
+    return header;
+}
+
 void CSIO::displayOutput(string output) const {
-    // send the output to the client. first the length of the output, then the output itself
-    string length = to_string(output.size());
-    while (length.length() < 8) {
-        length += " "; // pad with spaces to make it 8 bytes
-    }
-    // send length
-    int sentLen = ::send(clientSocket, length.c_str(), 8, 0);
-    if (sentLen == -1) throw exception();
-    
-    // send Actual Message
-    int totalSent = 0;
-    while (totalSent < output.length()) {
-        int sent = ::send(clientSocket, output.c_str() + totalSent, output.length() - totalSent, 0);
-        if (sent == -1) throw exception();
-        totalSent += sent;
+    // send the output to the client. first the length of the output, then the output itself - in one call
+    string length = legacyLength(output.size());
+    iovec parts[] = {part(length.c_str(), 8), part(output.c_str(), output.length())};
+    lock_guard<mutex> lock(writeLock);
+    sendAll(parts, 2);
+}
+
+void CSIO::sendFrameV2(const RequestContext& request, uint8_t flags, int statusCode, const string& body) const {
+    ProtocolV2::FrameHeader header;
+    header.opcode = request.opcode;
+    header.flags = flags;
+    header.status = static_cast<uint16_t>(statusCode);
+    header.requestId = request.requestId;
+    header.bodyLength = body.size();
+    string encodedHeader = ProtocolV2::encodeHeader(header);
+    iovec parts[] = {part(encodedHeader.data(), encodedHeader.size()), part(body.data(), body.size())};
+    // header and body must not be split by a frame of another request
+    lock_guard<mutex> lock(writeLock);
+    sendAll(parts, 2);
+}
+
+void CSIO::displayResponse(int statusCode, const string& data) const {
+    displayResponseFor(currentRequest, statusCode, data);
+}
+
+void CSIO::displayPartialResponse(const string& data) const {
+    displayPartialResponseFor(currentRequest, data);
+}
+
+void CSIO::displayResponseFor(const RequestContext& request, int statusCode, const string& data) const {
+    if (request.concurrent) {
+        concurrentPending--; // answered (even if sending fails below, nobody waits for it anymore)
+    }
+    if (protocolVersion == PROTOCOL_V2) {
+        sendFrameV2(request, 0, statusCode, data);
+    } else {
+        // the same bytes as formatOutput, sent from where they are instead of being joined into a new string
+        const string& statusLine = commandWrapper->statusMessage(statusCode);
+        bool withData = CommandWrapper::hasData(statusCode);
+        bool endsWithNewline = withData ? (data.empty() || data.back() == '\n')
+                                        : (!statusLine.empty() && statusLine.back() == '\n');
+        size_t length = statusLine.size() + (withData ? 2 + data.size() : 0) + (endsWithNewline ? 0 : 1);
+        string header = legacyLength(length);
+
+        iovec parts[5];
+        int count = 0;
+        parts[count++] = part(header.c_str(), 8);
+        parts[count++] = part(statusLine.data(), statusLine.size());
+        if (withData) {
+            parts[count++] = part("\n\n", 2);
+            parts[count++] = part(data.data(), data.size());
+        }
+        if (!endsWithNewline) {
+            parts[count++] = part("\n", 1);
+        }
+        lock_guard<mutex> lock(writeLock);
+        sendAll(parts, count);
+    }
+    if (tcpPolicy == TcpPolicy::CORK) {
+        TcpPolicy::flush(clientSocket); // the response is complete, do not hold it
+    }
+}
+
+void CSIO::displayPartialResponseFor(const RequestContext& request, const string& data) const {
+    if (protocolVersion == PROTOCOL_V2) {
+        sendFrameV2(request, ProtocolV2::FLAG_MORE, CommandWrapper::STATUS_OK, data);
+    } else {
+        displayOutput(data);
+    }
+}
+
+void CSIO::setTcpPolicy(int policy) {
+    tcpPolicy = policy;
+    TcpPolicy::apply(clientSocket, policy);
+}
+
+void CSIO::refuse(int statusCode) {
+    // the client may have sent its first request already - its first bytes tell the protocol to answer in.
+    // nothing is read (only peeked) and nothing waits, a client that did not send yet gets a legacy response
+    char firstBytes[ProtocolV2::HEADER_SIZE];
+    ssize_t peeked = ::recv(clientSocket, firstBytes, sizeof(firstBytes), MSG_PEEK | MSG_DONTWAIT);
+    string_view received(firstBytes, peeked > 0 ? peeked : 0);
+    ProtocolV2::FrameHeader header;
+    if (ProtocolV2::hasMagic(received)) {
+        protocolVersion = PROTOCOL_V2;
+        if (ProtocolV2::parseHeader(received, header)) {
+            currentRequest.opcode = header.opcode;
+            currentRequest.requestId = header.requestId;
+        }
+    } else {
+        protocolVersion = PROTOCOL_LEGACY;
+    }
+    try {
+        displayResponse(statusCode, "");
+    } catch (...) {
+        // the client is gone already
+    }
+    closed = true;
+}
+
+void CSIO::setTimeouts(const ConnectionTimeouts& connectionTimeouts) {
+    timeouts = connectionTimeouts;
+    // a blocked send gives up (EAGAIN) after the write timeout
+    timeval sendTimeout;
+    sendTimeout.tv_sec = timeouts.write.count() / 1000;
+    sendTimeout.tv_usec = (timeouts.write.count() % 1000) * 1000;
+    setsockopt(clientSocket, SOL_SOCKET, SO_SNDTIMEO, &sendTimeout, sizeof(sendTimeout));
+}
+
+void CSIO::setMaxBodyLength(uint64_t length) {
+    maxBodyLength = length;
+}
+
+void CSIO::setAdmission(AdmissionController* admissionController) {
+    admission = admissionController;
+}
+
+bool CSIO::wasReaped() const {
+    return reaped;
+}
+
+RequestContext CSIO::lastRequest() const {
+    return currentRequest;
+}
+
+bool CSIO::isClosed() {
+    if (closed) {
+        return true;
+    }
+    // poll without waiting. only a hang up or an error mean nobody reads our answers - a client that sent a FIN
+    // (shutdown(SHUT_WR)) is done sending but still waits for the answers to its requests
+    pollfd descriptor;
+    descriptor.fd = clientSocket;
+    descriptor.events = 0; // POLLHUP, POLLERR and POLLNVAL are always reported
+    descriptor.revents = 0;
+    if (::poll(&descriptor, 1, 0) > 0 && (descriptor.revents & (POLLHUP | POLLERR | POLLNVAL))) {
+        closed = true;
+    }
+    return closed;
+}
+
+void CSIO::reset(int newClientSocket) {
+    closeSocket();
+    clientSocket = newClientSocket;
+    closed = false;
+    if (readBuffer.capacity() > KEPT_BUFFER_BYTES) {
+        string().swap(readBuffer);
+    }
+    readBuffer.clear(); // keeps its capacity
+    readPosition = 0;
+    protocolVersion = PROTOCOL_UNKNOWN;
+    currentRequest = RequestContext();
+    timeouts = ConnectionTimeouts();
+    maxBodyLength = ProtocolV2::DEFAULT_MAX_BODY_LENGTH;
+    requestDeadline = chrono::steady_clock::time_point();
+    concurrentPending = 0;
+    reaped = false;
+    tcpPolicy = TcpPolicy::NAGLE;
+}
+
+void CSIO::closeSocket() {
+    if (clientSocket != -1) {
+        close(clientSocket);
+        clientSocket = -1;
     }
 }
 
 CSIO::~CSIO() {
-    close(clientSocket);
+    closeSocket();
 }
\ No newline at end of file
@@ -4,13 +4,24 @@
 #include "Iinput.h"
 #include "Ioutput.h"
 #include "CommandWrapper.h"
+#include "ProtocolV2.h"
+#include "TcpPolicy.h"
+#include "ConnectionTimeouts.h"
+#include "AdmissionController.h"
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
+#include <poll.h>
 #include <unistd.h>
 #include <cstring>
+#include <cerrno>
 #include <string>
 #include <vector>
 #include <iostream>
+#include <atomic>
+#include <mutex>
+#include <string_view>
+#include <chrono>
 using namespace std;
 
 class CSIO: public IInput, public Ioutput {
@@ -21,22 +32,150 @@ private:
     // command wrapper to format output
     CommandWrapper* commandWrapper;
 
+    // set once the connection is known to be closed (recv/send failed or the peer hung up)
+    mutable atomic<bool> closed;
+
+    // bytes received from the client that were not handed out as a command yet.
+    // one recv may hold several pipelined commands (or a part of the next one), they are kept for the next calls
+    string readBuffer;
+
+    // where the next command starts in readBuffer (consumed bytes are dropped lazily, not on every command)
+    size_t readPosition;
+
+    // which protocol the client speaks, decided by the first bytes it sends
+    static const int PROTOCOL_UNKNOWN = 0;
+    static const int PROTOCOL_LEGACY = 1; // newline terminated commands, 8 bytes text length before responses
+    static const int PROTOCOL_V2 = 2;     // binary frames, see ProtocolV2
+    int protocolVersion;
+
+    // the last request read, its opcode and id are sent back in the response frames
+    RequestContext currentRequest;
+
+    // responses of concurrent requests are sent from several threads, one frame at a time
+    mutable mutex writeLock;
+
+    // when the connection is closed for a silent client
+    ConnectionTimeouts timeouts;
+
+    // the largest body of a v2 request frame, see ProtocolV2::DEFAULT_MAX_BODY_LENGTH
+    uint64_t maxBodyLength;
+
+    // admits the body of a v2 request before it is received (nullptr - no limits)
+    AdmissionController* admission;
+
+    // the TcpPolicy of the socket (CORK needs a flush after every response)
+    int tcpPolicy;
+
+    // when the request being received must be complete (its first byte came, see ConnectionTimeouts::read)
+    chrono::steady_clock::time_point requestDeadline;
+
+    // concurrent requests handed out that were not answered yet. the connection is not idle while they run
+    mutable atomic<size_t> concurrentPending;
+
+    // set when a timeout closed the connection
+    mutable atomic<bool> reaped;
+
+    // Receives more bytes from the client into readBuffer. throws exception if the connection is closed
+    void receiveMore();
+
+    /*
+    * Waits until the client sent something, for as long as the timeouts allow.
+    * betweenRequests - nothing of the next request came yet (the idle timeout), otherwise the read timeout.
+    * closes the connection and throws exception if the time ran out
+    */
+    void waitForData(bool betweenRequests);
+
+    // closes the connection of a silent client. the socket is shut down (the client sees it closed right away)
+    void reap() const;
+
+    // Reads a legacy newline terminated command
+    vector<string> getLegacyCommand();
+
+    // Reads a v2 request frame
+    vector<string> getFrameV2();
+
+    // answers the frame with the status without reading its body, then ends the connection (the rest of the
+    // stream can not be followed) and throws exception
+    void rejectFrame(const ProtocolV2::FrameHeader& header, int statusCode);
+
+    /*
+    * Sends all the parts to the client with as few sendmsg calls as possible (one, unless the socket is full).
+    * the parts are changed while they are sent. throws exception if sending failed
+    */
+    void sendAll(iovec* parts, int count) const;
+
+    // Sends a v2 frame answering the request
+    void sendFrameV2(const RequestContext& request, uint8_t flags, int statusCode, const string& body) const;
+
 public:
     // Constructor
     CSIO(int clientSocket, CommandWrapper* commandWrapper);
 
+    // Splits a received line into command and arguments, throws exception if it has no arguments
+    static vector<string> splitCommand(const string& line);
+
+    // the 8 bytes length of a legacy frame, padded with spaces
+    static string legacyLength(size_t length);
+
     // display commands menu - empty implementation
     virtual void displayCommands(map<string, ICommands*> commands) const override
     {
         // empty implementation
     }
 
-    // display output to the client
+    // display output to the client (a legacy frame: 8 bytes length and the output)
     virtual void displayOutput(string output) const override;
 
+    // send the response in the protocol of the client
+    virtual void displayResponse(int statusCode, const string& data) const override;
+
+    // send a part of a streamed response in the protocol of the client
+    virtual void displayPartialResponse(const string& data) const override;
+
+    // send the response of a specific request (thread safe)
+    virtual void displayResponseFor(const RequestContext& request, int statusCode, const string& data) const override;
+
+    // send a part of the streamed response of a specific request (thread safe)
+    virtual void displayPartialResponseFor(const RequestContext& request, const string& data) const override;
+
+    // the id of the last request and whether it may run concurrently (v2 only)
+    virtual RequestContext lastRequest() const override;
+
     // read command and arguments from the client
     virtual vector<string> getCommandAndArgs() override;
 
+    // set the TcpPolicy of the socket
+    void setTcpPolicy(int policy);
+
+    // set how long the connection waits for its client (see ConnectionTimeouts)
+    void setTimeouts(const ConnectionTimeouts& connectionTimeouts);
+
+    // set the largest body a v2 request may have, a bigger one is answered with 400 and the connection closed
+    void setMaxBodyLength(uint64_t length);
+
+    // admit the body of every v2 request with the controller before it is received. a body that does not fit is
+    // answered with 503 and the connection closed. the bytes admitted are in the RequestContext of the request
+    void setAdmission(AdmissionController* admissionController);
+
+    // true if a timeout closed the connection
+    virtual bool wasReaped() const override;
+
+    // answers a connection that will not be served (e.g. 503 when the server is overloaded) and ends it
+    void refuse(int statusCode);
+
+    // check (without blocking) if the client closed the connection
+    virtual bool isClosed() override;
+
+    /*
+    * Serves a new connection with this object (see ConnectionContextPool): closes the socket of the previous one
+    * (if still open) and starts over, keeping the memory of the read buffer. the timeouts, the largest body and
+    * the TcpPolicy are back to their defaults (the admission controller is kept). no request of the previous connection may still be running
+    */
+    void reset(int newClientSocket);
+
+    // closes the socket now instead of in the destructor, the object can be reset for another connection
+    void closeSocket();
+
     // Destructor  to close the socket
     ~CSIO();
     
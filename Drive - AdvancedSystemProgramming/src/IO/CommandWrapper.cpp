@@ -1,15 +1,15 @@
 #include "CommandWrapper.h"
-
-// Define the static map
-map<int, string> statusMessages;
+#include "OutputResultSink.h"
 
 // Define the static constants
 const int CommandWrapper::STATUS_OK;
 const int CommandWrapper::STATUS_CREATED;
 const int CommandWrapper::STATUS_NO_CONTENT;
+const int CommandWrapper::STATUS_PARTIAL_CONTENT;
 const int CommandWrapper::STATUS_BAD_REQUEST;
 const int CommandWrapper::STATUS_NOT_FOUND;
 const int CommandWrapper::STATUS_INTERNAL_SERVER_ERROR;
+const int CommandWrapper::STATUS_SERVICE_UNAVAILABLE;
 
 
 map<int, string> CommandWrapper::initStatusMessages() {
@@ -17,32 +17,60 @@ map<int, string> CommandWrapper::initStatusMessages() {
     messages[STATUS_OK] = "200 Ok";
     messages[STATUS_CREATED] = "201 Created";
     messages[STATUS_NO_CONTENT] = "204 No Content";
+    messages[STATUS_PARTIAL_CONTENT] = "206 Partial Content";
     messages[STATUS_BAD_REQUEST] = "400 Bad Request";
     messages[STATUS_NOT_FOUND] = "404 Not Found";
     messages[STATUS_INTERNAL_SERVER_ERROR] = "500 Internal Server Error";
+    messages[STATUS_SERVICE_UNAVAILABLE] = "503 Service Unavailable";
     return messages;
 }
 
+// Define the static map
+const map<int, string> CommandWrapper::STATUS_MESSAGES = CommandWrapper::initStatusMessages();
+
 CommandWrapper::CommandWrapper() {
-    statusMessages = CommandWrapper::initStatusMessages();
 }
 
 string CommandWrapper::executeCommand(ICommands* command, const string& args) {
+    // a token that never stops the command
+    return executeCommand(command, args, CancellationToken());
+}
+
+pair<int, string> CommandWrapper::runCommand(ICommands* command, const string& args, const CancellationToken& token) {
     if (command == nullptr) {
-        return formatOutput(STATUS_BAD_REQUEST, "");
+        return {STATUS_BAD_REQUEST, ""};
     }
-    
+
     // Execute command - returns pair<statusCode, output>
-    pair<int, string> result = command->execute(args);
-    
-    return formatOutput(result. first, result. second);
+    return command->execute(args, token);
 }
 
-string CommandWrapper::formatOutput(int statusCode, const string& commandOutput) {
-    string output = statusMessages[statusCode];
+int CommandWrapper::runStreamedCommand(ICommands* command, const string& args, Ioutput* output, const CancellationToken& token,
+                                       const RequestContext& request) {
+    if (command == nullptr) {
+        return STATUS_BAD_REQUEST;
+    }
+
+    OutputResultSink sink(output, request);
+    int statusCode = command->executeStreamed(args, sink, token);
+    sink.flush(); // send the items that are still batched before the final status line
+    return statusCode;
+}
+
+string CommandWrapper::executeCommand(ICommands* command, const string& args, const CancellationToken& token) {
+    pair<int, string> result = runCommand(command, args, token);
+    return formatOutput(result.first, result.second);
+}
+
+string CommandWrapper::executeStreamedCommand(ICommands* command, const string& args, Ioutput* output, const CancellationToken& token) {
+    return formatOutput(runStreamedCommand(command, args, output, token), "");
+}
+
+string CommandWrapper::formatOutput(int statusCode, const string& commandOutput) const {
+    string output = statusMessage(statusCode);
     
-    // For successful operations with output data (200 Ok), append the data after two newlines
-    if (statusCode == STATUS_OK) {
+    // For successful operations with output data (200 Ok, 206 Partial Content), append the data after two newlines
+    if (hasData(statusCode)) {
         output += "\n\n" + commandOutput;
     }
     
@@ -52,4 +80,15 @@ string CommandWrapper::formatOutput(int statusCode, const string& commandOutput)
     }
     
     return output;
-}
\ No newline at end of file
+}
+
+const string& CommandWrapper::statusMessage(int statusCode) const {
+    static const string unknown;
+    // find, not operator[] - the map is shared and never written
+    map<int, string>::const_iterator message = STATUS_MESSAGES.find(statusCode);
+    return message != STATUS_MESSAGES.end() ? message->second : unknown;
+}
+
+bool CommandWrapper::hasData(int statusCode) {
+    return statusCode == STATUS_OK || statusCode == STATUS_PARTIAL_CONTENT;
+}
@@ -8,6 +8,7 @@
 #include <functional>
 #include <utility>
 #include "Icommand.h"
+#include "Ioutput.h"
 
 using namespace std;
 
@@ -17,13 +18,15 @@ public:
     static const int STATUS_OK = 200;
     static const int STATUS_CREATED = 201;
     static const int STATUS_NO_CONTENT = 204;
+    static const int STATUS_PARTIAL_CONTENT = 206;
     static const int STATUS_BAD_REQUEST = 400;
     static const int STATUS_NOT_FOUND = 404;
     static const int STATUS_INTERNAL_SERVER_ERROR = 500;
+    static const int STATUS_SERVICE_UNAVAILABLE = 503;
 
 private:
-    // Map from status code to output message
-    map<int, string> statusMessages;
+    // Map from status code to output message. built once and never changed, so every connection shares it
+    static const map<int, string> STATUS_MESSAGES;
     
     // Initialize the status messages map
     static map<int, string> initStatusMessages();
@@ -31,11 +34,36 @@ private:
 public:
     CommandWrapper();
     
+    // Execute command and return its status code and data, not formatted (the output frames them)
+    pair<int, string> runCommand(ICommands* command, const string& args, const CancellationToken& token);
+
+    // Execute a streamed command, its items are sent to the output as partial responses of the request.
+    // returns the final status code
+    int runStreamedCommand(ICommands* command, const string& args, Ioutput* output, const CancellationToken& token,
+                           const RequestContext& request = RequestContext());
+
     // Execute command and return formatted response
     string executeCommand(ICommands* command, const string& args);
+
+    // Execute command that stops when the token says so, and return formatted response
+    string executeCommand(ICommands* command, const string& args, const CancellationToken& token);
     
+    /*
+    * Execute a streamed command. its items are sent to the output as data frames while it runs
+    * (one item per line, a data frame never contains a space). the returned status line ends the response,
+    * so a client reads frames until it gets one whose first line contains a space.
+    */
+    string executeStreamedCommand(ICommands* command, const string& args, Ioutput* output, const CancellationToken& token);
+
     // Format the final output with status code and captured data
-    string formatOutput(int statusCode, const string& commandOutput);
+    string formatOutput(int statusCode, const string& commandOutput) const;
+
+    // The status line of a status code (e.g. "200 Ok"), for outputs that send it without formatOutput.
+    // empty for an unknown code
+    const string& statusMessage(int statusCode) const;
+
+    // true if the data of the status code is sent after its status line (200 Ok, 206 Partial Content)
+    static bool hasData(int statusCode);
 };
 
 #endif // COMMAND_WRAPPER_H
\ No newline at end of file
@@ -0,0 +1,25 @@
+// How long a connection may wait for its client
+#ifndef CONNECTION_TIMEOUTS_H
+#define CONNECTION_TIMEOUTS_H
+
+#include <chrono>
+
+using namespace std;
+
+/*
+* a client that goes silent (or a half open connection, whose client is gone without a FIN) would hold its
+* connection forever. when a timeout passes the connection is closed - reaped - and its resources are released.
+* 0 - no limit (the default, a connection waits as long as its client is there).
+*/
+struct ConnectionTimeouts {
+    // waiting for the next request while no request of the connection runs
+    chrono::milliseconds idle{0};
+
+    // receiving the whole of a request, from its first byte (a request that stalls half way)
+    chrono::milliseconds read{0};
+
+    // a send that is blocked because the client does not read its responses
+    chrono::milliseconds write{0};
+};
+
+#endif // CONNECTION_TIMEOUTS_H
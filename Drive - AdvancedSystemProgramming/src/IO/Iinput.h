@@ -4,6 +4,7 @@
 using namespace std;
 #include <string>
 #include <vector>
+#include "RequestContext.h"
 
 // Interface decleration
 class IInput {
@@ -13,6 +14,23 @@ public:
     // Reads and parses a command from input, returns the command name in 0 index of vector, and its arguments as a vector of strings.
     virtual vector<string> getCommandAndArgs() = 0;
 
+    // Returns true if the input source is gone (e.g. the client closed the connection) and no more commands will come.
+    // inputs that can not tell return false.
+    virtual bool isClosed() {
+        return false;
+    }
+
+    // Returns true if the input was closed because its client was silent for too long (see ConnectionTimeouts)
+    virtual bool wasReaped() const {
+        return false;
+    }
+
+    // Returns the context of the last request returned by getCommandAndArgs (its id, if it may run concurrently).
+    // inputs without request ids return the default context
+    virtual RequestContext lastRequest() const {
+        return RequestContext();
+    }
+
     // no need for constructor in Interfaces.
     // virtual destructor (every Interface should have a virtual destructor)
     virtual ~IInput() = default;
@@ -0,0 +1,101 @@
+#include "IoReactor.h"
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+
+IoReactor::IoReactor(IExecutor* executor) : executor(executor), epollFd(-1), wakeFd(-1), stopped(false) {
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.ptr = nullptr; // the wake up, every other event has its coroutine
+    if (epollFd == -1 || wakeFd == -1 || epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event) == -1) {
+        if (epollFd != -1) {
+            close(epollFd);
+        }
+        if (wakeFd != -1) {
+            close(wakeFd);
+        }
+        throw exception();
+    }
+    loop = thread(&IoReactor::run, this);
+}
+
+IoReactor::~IoReactor() {
+    stop();
+    close(epollFd);
+    close(wakeFd);
+}
+
+void IoReactor::stop() {
+    if (stopped.exchange(true)) {
+        return;
+    }
+    uint64_t one = 1;
+    ssize_t written = write(wakeFd, &one, sizeof(one));
+    (void)written; // a full eventfd wakes the loop too
+    if (loop.joinable()) {
+        loop.join();
+    }
+}
+
+void IoReactor::run() {
+    epoll_event events[64];
+    while (!stopped) {
+        int ready = epoll_wait(epollFd, events, 64, -1);
+        if (ready == -1) {
+            continue; // interrupted by a signal
+        }
+        for (int i = 0; i < ready; i++) {
+            if (events[i].data.ptr == nullptr) {
+                continue; // the wake up, the loop checks stopped
+            }
+            coroutine_handle<> coroutine = coroutine_handle<>::from_address(events[i].data.ptr);
+            executor->post(Task([coroutine]() { coroutine.resume(); }));
+        }
+    }
+}
+
+bool IoReactor::watch(int socket, uint32_t events, coroutine_handle<> coroutine) {
+    epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = events | EPOLLONESHOT;
+    event.data.ptr = coroutine.address();
+    // the socket is added by its first wait and armed again by the next ones
+    if (epoll_ctl(epollFd, EPOLL_CTL_MOD, socket, &event) == 0) {
+        return true;
+    }
+    return errno == ENOENT && epoll_ctl(epollFd, EPOLL_CTL_ADD, socket, &event) == 0;
+}
+
+void IoReactor::forget(int socket) {
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, socket, nullptr);
+}
+
+IoReactor::Readiness IoReactor::readable(int socket) {
+    return Readiness(this, socket, EPOLLIN | EPOLLRDHUP);
+}
+
+IoReactor::Readiness IoReactor::writable(int socket) {
+    return Readiness(this, socket, EPOLLOUT);
+}
+
+IoReactor::Readiness::Readiness(IoReactor* reactor, int socket, uint32_t events)
+    : reactor(reactor), socket(socket), events(events) {
+}
+
+bool IoReactor::Readiness::await_ready() const noexcept {
+    return false;
+}
+
+bool IoReactor::Readiness::await_suspend(coroutine_handle<> coroutine) {
+    // once armed the coroutine may be resumed on a worker before this returns, nothing of it is used after
+    return reactor->watch(socket, events, coroutine);
+}
+
+void IoReactor::Readiness::await_resume() const noexcept {
+}
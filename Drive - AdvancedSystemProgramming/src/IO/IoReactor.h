@@ -0,0 +1,69 @@
+// Wakes coroutines when their sockets are ready
+#ifndef IO_REACTOR_H
+#define IO_REACTOR_H
+
+#include "IExecutor.h"
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <thread>
+
+using namespace std;
+
+/*
+* one thread waits (epoll) on the sockets of every suspended coroutine. a coroutine that awaits readable(fd)
+* or writable(fd) is suspended until the socket is ready (or hung up, or failed - the next recv / send tells),
+* then it is resumed in a task of the executor. so a connection that waits for its client holds no thread.
+* a socket has at most one waiting coroutine at a time (EPOLLONESHOT: it is armed again by the next await).
+* the reactor must outlive the coroutines that wait on it, those still waiting when it stops are never resumed.
+*/
+class IoReactor {
+private:
+    IExecutor* executor; // resumes the coroutines
+    int epollFd;
+    int wakeFd;          // an eventfd, written to stop the loop
+    atomic<bool> stopped;
+    thread loop;
+
+    void run();
+
+    // arms the socket for the events and the coroutine. false if epoll does not take the socket
+    bool watch(int socket, uint32_t events, coroutine_handle<> coroutine);
+
+public:
+    // the awaitable of readable() and writable()
+    class Readiness {
+    private:
+        IoReactor* reactor;
+        int socket;
+        uint32_t events;
+
+    public:
+        Readiness(IoReactor* reactor, int socket, uint32_t events);
+        bool await_ready() const noexcept;
+        // a socket epoll does not take is not waited for, the coroutine goes on at once
+        bool await_suspend(coroutine_handle<> coroutine);
+        void await_resume() const noexcept;
+    };
+
+    // throws exception if epoll can not be created
+    explicit IoReactor(IExecutor* executor);
+    ~IoReactor();
+
+    IoReactor(const IoReactor&) = delete;
+    IoReactor& operator=(const IoReactor&) = delete;
+
+    // co_await readable(socket) - until the socket has data (or the peer hung up)
+    Readiness readable(int socket);
+
+    // co_await writable(socket) - until the socket has room to send
+    Readiness writable(int socket);
+
+    // stops watching the socket, call before it is closed
+    void forget(int socket);
+
+    // stops the loop (the destructor does too)
+    void stop();
+};
+
+#endif // IO_REACTOR_H
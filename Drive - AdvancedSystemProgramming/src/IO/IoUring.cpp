@@ -0,0 +1,311 @@
+#include "IoUring.h"
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <vector>
+
+const unsigned IoUring::ENTRIES = 256;
+
+// the operations the storage needs, the ring is not used if the kernel lacks one of them
+static const uint8_t NEEDED_OPERATIONS[] = {IORING_OP_NOP, IORING_OP_OPENAT, IORING_OP_READ, IORING_OP_WRITE,
+                                            IORING_OP_FSYNC, IORING_OP_CLOSE, IORING_OP_UNLINKAT};
+
+static bool supportsOperations(int ringFd) {
+    const unsigned probed = 256;
+    vector<char> buffer(sizeof(io_uring_probe) + probed * sizeof(io_uring_probe_op), 0);
+    io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(buffer.data());
+    if (syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_PROBE, probe, probed) < 0) {
+        return false; // older than the probe (5.6), so older than the operations too
+    }
+    for (uint8_t operation : NEEDED_OPERATIONS) {
+        if (operation > probe->last_op || !(probe->ops[operation].flags & IO_URING_OP_SUPPORTED)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static io_uring_sqe emptyRequest(uint8_t opcode) {
+    io_uring_sqe request;
+    memset(&request, 0, sizeof(request));
+    request.opcode = opcode;
+    return request;
+}
+
+IoUring::IoUring(IExecutor* executor)
+    : executor(executor), ringFd(-1), submissionRing(MAP_FAILED), submissionRingSize(0), completionRing(MAP_FAILED),
+      completionRingSize(0), requests(static_cast<io_uring_sqe*>(MAP_FAILED)), requestsSize(0), inKernel(0),
+      unsubmitted(0), flushPosted(false), submitCalls(0), operations(0),
+      stopRequest(this, emptyRequest(IORING_OP_NOP)), stopped(false) {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    ringFd = syscall(__NR_io_uring_setup, ENTRIES, &params);
+    if (ringFd < 0) {
+        throw exception(); // no io_uring (ENOSYS), or it is not allowed here (EPERM)
+    }
+    if (!supportsOperations(ringFd)) {
+        ::close(ringFd);
+        throw exception();
+    }
+    // the rings are mapped one by one, which works with or without IORING_FEAT_SINGLE_MMAP
+    submissionRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    completionRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    requestsSize = params.sq_entries * sizeof(io_uring_sqe);
+    submissionRing = mmap(nullptr, submissionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd,
+                          IORING_OFF_SQ_RING);
+    completionRing = mmap(nullptr, completionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd,
+                          IORING_OFF_CQ_RING);
+    requests = static_cast<io_uring_sqe*>(mmap(nullptr, requestsSize, PROT_READ | PROT_WRITE,
+                                               MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES));
+    if (submissionRing == MAP_FAILED || completionRing == MAP_FAILED || requests == MAP_FAILED) {
+        if (submissionRing != MAP_FAILED) {
+            munmap(submissionRing, submissionRingSize);
+        }
+        if (completionRing != MAP_FAILED) {
+            munmap(completionRing, completionRingSize);
+        }
+        if (requests != MAP_FAILED) {
+            munmap(requests, requestsSize);
+        }
+        ::close(ringFd);
+        throw exception();
+    }
+    char* submissionBase = static_cast<char*>(submissionRing);
+    char* completionBase = static_cast<char*>(completionRing);
+    submissionTail = reinterpret_cast<unsigned*>(submissionBase + params.sq_off.tail);
+    submissionMask = *reinterpret_cast<unsigned*>(submissionBase + params.sq_off.ring_mask);
+    completionHead = reinterpret_cast<unsigned*>(completionBase + params.cq_off.head);
+    completionTail = reinterpret_cast<unsigned*>(completionBase + params.cq_off.tail);
+    completionMask = *reinterpret_cast<unsigned*>(completionBase + params.cq_off.ring_mask);
+    completions = reinterpret_cast<io_uring_cqe*>(completionBase + params.cq_off.cqes);
+    // slot i of the ring always holds request i, so a request is submitted by moving the tail past it
+    unsigned* slots = reinterpret_cast<unsigned*>(submissionBase + params.sq_off.array);
+    for (unsigned i = 0; i < params.sq_entries; i++) {
+        slots[i] = i;
+    }
+    completionThread = thread(&IoUring::run, this);
+}
+
+IoUring::~IoUring() {
+    stop();
+    munmap(submissionRing, submissionRingSize);
+    munmap(completionRing, completionRingSize);
+    munmap(requests, requestsSize);
+    ::close(ringFd);
+}
+
+void IoUring::stop() {
+    if (stopped.exchange(true)) {
+        return;
+    }
+    {
+        // submitted here and not by a flush task, the executor may be gone already
+        lock_guard<mutex> guard(lock);
+        while (unsubmitted > 0) {
+            int submitted = enter(unsubmitted, false);
+            if (submitted < 0) {
+                break;
+            }
+            unsubmitted -= submitted;
+        }
+        if (inKernel < ENTRIES) {
+            enqueue(&stopRequest);
+            enter(unsubmitted, false);
+            unsubmitted = 0;
+            flushPosted = false;
+        } else {
+            waiting.push_front(&stopRequest); // goes in with the first completion
+        }
+    }
+    if (completionThread.joinable()) {
+        completionThread.join();
+    }
+}
+
+int IoUring::enter(unsigned count, bool wait) {
+    int result;
+    do {
+        result = syscall(__NR_io_uring_enter, ringFd, count, wait ? 1 : 0, wait ? IORING_ENTER_GETEVENTS : 0,
+                         nullptr, 0);
+    } while (result < 0 && errno == EINTR);
+    if (result > 0) {
+        submitCalls++;
+        operations += result;
+    }
+    return result;
+}
+
+bool IoUring::enqueue(Operation* operation) {
+    if (inKernel == ENTRIES) {
+        waiting.push_back(operation);
+        return false;
+    }
+    // the completions ring has room for twice ENTRIES, so it never overflows
+    unsigned tail = *submissionTail;
+    io_uring_sqe& request = requests[tail & submissionMask];
+    request = operation->request;
+    request.user_data = reinterpret_cast<uint64_t>(operation);
+    __atomic_store_n(submissionTail, tail + 1, __ATOMIC_RELEASE); // the kernel sees the request with the tail
+    inKernel++;
+    unsubmitted++;
+    if (flushPosted) {
+        return false; // goes with that flush
+    }
+    flushPosted = true;
+    return true;
+}
+
+void IoUring::flush() {
+    {
+        lock_guard<mutex> guard(lock);
+        flushPosted = false;
+        if (unsubmitted == 0) {
+            return;
+        }
+        int submitted = enter(unsubmitted, false);
+        if (submitted > 0) {
+            unsubmitted -= submitted;
+        }
+        if (unsubmitted == 0 || stopped) {
+            return;
+        }
+        // the kernel took only part of them (e.g. EAGAIN, out of memory), try again later
+        flushPosted = true;
+    }
+    // posted without the lock, a worker of a full pool runs the task at once
+    executor->post(Task([this]() { flush(); }));
+}
+
+void IoUring::run() {
+    vector<coroutine_handle<>> ready;
+    bool stopping = false;
+    while (!stopping) {
+        enter(0, true);
+        bool postFlush = false;
+        ready.clear();
+        {
+            // the completions are taken holding the lock the operations were put in the ring with, so the fields
+            // of an operation (written by its coroutine) are seen here without relying on the kernel
+            lock_guard<mutex> guard(lock);
+            unsigned head = *completionHead;
+            unsigned tail = __atomic_load_n(completionTail, __ATOMIC_ACQUIRE);
+            for (; head != tail; head++) {
+                const io_uring_cqe& completion = completions[head & completionMask];
+                Operation* operation = reinterpret_cast<Operation*>(completion.user_data);
+                inKernel--;
+                if (operation == &stopRequest) {
+                    stopping = true;
+                    continue;
+                }
+                operation->result = completion.res;
+                ready.push_back(operation->coroutine); // the operation is gone once its coroutine is resumed
+            }
+            __atomic_store_n(completionHead, head, __ATOMIC_RELEASE); // the kernel may reuse the completions
+            while (!waiting.empty() && inKernel < ENTRIES) {
+                Operation* operation = waiting.front();
+                waiting.pop_front();
+                postFlush = enqueue(operation) || postFlush;
+            }
+            if (postFlush && stopped) {
+                // the stop request came from waiting, there may be no executor to flush it
+                enter(unsubmitted, false);
+                unsubmitted = 0;
+                flushPosted = false;
+                postFlush = false;
+            }
+        }
+        if (postFlush) {
+            executor->post(Task([this]() { flush(); }));
+        }
+        for (coroutine_handle<> coroutine : ready) {
+            executor->post(Task([coroutine]() { coroutine.resume(); }));
+        }
+    }
+}
+
+IoUring::Operation IoUring::openAt(const char* path, int flags, mode_t mode) {
+    io_uring_sqe request = emptyRequest(IORING_OP_OPENAT);
+    request.fd = AT_FDCWD;
+    request.addr = reinterpret_cast<uint64_t>(path);
+    request.len = mode;
+    request.open_flags = flags;
+    return Operation(this, request);
+}
+
+IoUring::Operation IoUring::read(int file, char* buffer, unsigned size, uint64_t offset) {
+    io_uring_sqe request = emptyRequest(IORING_OP_READ);
+    request.fd = file;
+    request.addr = reinterpret_cast<uint64_t>(buffer);
+    request.len = size;
+    request.off = offset;
+    return Operation(this, request);
+}
+
+IoUring::Operation IoUring::write(int file, const char* buffer, unsigned size, uint64_t offset) {
+    io_uring_sqe request = emptyRequest(IORING_OP_WRITE);
+    request.fd = file;
+    request.addr = reinterpret_cast<uint64_t>(buffer);
+    request.len = size;
+    request.off = offset;
+    return Operation(this, request);
+}
+
+IoUring::Operation IoUring::fsync(int file) {
+    io_uring_sqe request = emptyRequest(IORING_OP_FSYNC);
+    request.fd = file;
+    request.fsync_flags = IORING_FSYNC_DATASYNC;
+    return Operation(this, request);
+}
+
+IoUring::Operation IoUring::close(int file) {
+    io_uring_sqe request = emptyRequest(IORING_OP_CLOSE);
+    request.fd = file;
+    return Operation(this, request);
+}
+
+IoUring::Operation IoUring::unlink(const char* path) {
+    io_uring_sqe request = emptyRequest(IORING_OP_UNLINKAT);
+    request.fd = AT_FDCWD;
+    request.addr = reinterpret_cast<uint64_t>(path);
+    return Operation(this, request);
+}
+
+size_t IoUring::submitCount() {
+    lock_guard<mutex> guard(lock);
+    return submitCalls;
+}
+
+size_t IoUring::operationCount() {
+    lock_guard<mutex> guard(lock);
+    return operations;
+}
+
+IoUring::Operation::Operation(IoUring* ring, const io_uring_sqe& request)
+    : ring(ring), request(request), result(0) {
+}
+
+bool IoUring::Operation::await_ready() const noexcept {
+    return false;
+}
+
+void IoUring::Operation::await_suspend(coroutine_handle<> coroutine) {
+    this->coroutine = coroutine;
+    IoUring* owner = ring;
+    bool postFlush;
+    {
+        lock_guard<mutex> guard(owner->lock);
+        postFlush = owner->enqueue(this);
+    }
+    // the operation may complete (and the coroutine go on) before this returns, nothing of it is used after
+    if (postFlush) {
+        owner->executor->post(Task([owner]() { owner->flush(); }));
+    }
+}
+
+int IoUring::Operation::await_resume() const noexcept {
+    return result;
+}
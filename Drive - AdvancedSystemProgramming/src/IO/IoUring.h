@@ -0,0 +1,125 @@
+// Runs file operations of coroutines on an io_uring
+#ifndef IO_URING_H
+#define IO_URING_H
+
+#include "IExecutor.h"
+#include <linux/io_uring.h>
+#include <sys/types.h>
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+/*
+* an io_uring (through its system calls, without liburing): a coroutine that awaits an operation (openAt, read,
+* write, fsync, close, unlink) is suspended while the kernel does it, then it is resumed in a task of the executor
+* with the result of the operation (like the system call: the result, or -errno). so a file that waits for the
+* disk holds no thread.
+* submissions are batched: the operations go into the ring when they are awaited, and the first one posts a flush
+* task to the executor, which submits all the operations that came before it ran with a single io_uring_enter.
+* a thread waits for the completions. at most ENTRIES operations are in the kernel at once, more wait their turn.
+* the constructor throws exception if the kernel has no io_uring (or not these operations) - then use blocking
+* calls on a pool (see AsyncStorage). the ring must outlive the operations, those still in it when it stops are
+* never resumed.
+*/
+class IoUring {
+public:
+    static const unsigned ENTRIES;
+
+    // the awaitable of every operation, the result of co_await is the result of the operation
+    class Operation {
+    private:
+        friend class IoUring;
+        IoUring* ring;
+        io_uring_sqe request;
+        coroutine_handle<> coroutine;
+        int result;
+
+    public:
+        Operation(IoUring* ring, const io_uring_sqe& request);
+        bool await_ready() const noexcept;
+        void await_suspend(coroutine_handle<> coroutine);
+        int await_resume() const noexcept;
+    };
+
+private:
+    IExecutor* executor; // resumes the coroutines and runs the flushes
+    int ringFd;
+
+    // the rings, shared with the kernel
+    void* submissionRing;
+    size_t submissionRingSize;
+    void* completionRing;
+    size_t completionRingSize;
+    io_uring_sqe* requests;
+    size_t requestsSize;
+    unsigned* submissionTail;
+    unsigned submissionMask;
+    unsigned* completionHead;
+    unsigned* completionTail;
+    unsigned completionMask;
+    io_uring_cqe* completions;
+
+    mutex lock;                // guards everything below, and the submission ring
+    unsigned inKernel;         // operations in the ring that did not complete
+    unsigned unsubmitted;      // operations in the ring that no io_uring_enter took yet
+    bool flushPosted;
+    deque<Operation*> waiting; // operations beyond ENTRIES
+    size_t submitCalls;
+    size_t operations;
+
+    Operation stopRequest; // completes last, stops the completion thread
+    atomic<bool> stopped;
+    thread completionThread;
+
+    void run();
+
+    // puts the operation in the ring (or in waiting if it is full), holding the lock. true if a flush should be posted
+    bool enqueue(Operation* operation);
+
+    // submits the operations in the ring
+    void flush();
+
+    // io_uring_enter - submits count operations, waits for one completion if wait. returns how many it submitted
+    int enter(unsigned count, bool wait);
+
+public:
+    // throws exception if the ring can not be created
+    explicit IoUring(IExecutor* executor);
+    ~IoUring();
+
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    // the file descriptor, or -errno. path must stay alive until the operation completed
+    Operation openAt(const char* path, int flags, mode_t mode);
+
+    // the bytes read (0 at the end of the file), or -errno
+    Operation read(int file, char* buffer, unsigned size, uint64_t offset);
+
+    // the bytes written, or -errno
+    Operation write(int file, const char* buffer, unsigned size, uint64_t offset);
+
+    // flushes the data of the file to the disk. 0 or -errno
+    Operation fsync(int file);
+
+    // 0 or -errno
+    Operation close(int file);
+
+    // 0 or -errno. path must stay alive until the operation completed
+    Operation unlink(const char* path);
+
+    // how many io_uring_enter calls submitted how many operations (more operations than calls - batches)
+    size_t submitCount();
+    size_t operationCount();
+
+    // stops the completion thread (the destructor does too)
+    void stop();
+};
+
+#endif // IO_URING_H
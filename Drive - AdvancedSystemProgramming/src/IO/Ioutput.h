@@ -6,6 +6,7 @@ using namespace std;
 #include <map>
 #include <string>
 #include "../UserCommands/Icommand.h"
+#include "RequestContext.h"
 // Interface declaration
 class Ioutput {
 
@@ -16,6 +17,23 @@ public:
 
     // Prints a general output line to the user (results, messages, etc.).
     virtual void displayOutput(string output) const = 0;
+
+    // Sends the response of a command: its status code and its data (the output decides how they are framed).
+    virtual void displayResponse(int statusCode, const string& data) const = 0;
+
+    // Sends a part of the data of a streamed command. its status comes last, with displayResponse.
+    virtual void displayPartialResponse(const string& data) const = 0;
+
+    // Sends the response of a specific request (may be called from other threads for concurrent requests).
+    // outputs without request ids answer in order, like displayResponse
+    virtual void displayResponseFor(const RequestContext& request, int statusCode, const string& data) const {
+        displayResponse(statusCode, data);
+    }
+
+    // Sends a part of the streamed response of a specific request
+    virtual void displayPartialResponseFor(const RequestContext& request, const string& data) const {
+        displayPartialResponse(data);
+    }
     
     // no need for constructor in Interfaces.
     // virtual destructor (every Interface should have a virtual destructor)
@@ -0,0 +1,38 @@
+#include "OutputResultSink.h"
+
+constexpr chrono::milliseconds OutputResultSink::FLUSH_INTERVAL;
+
+OutputResultSink::OutputResultSink(Ioutput* output, const RequestContext& request)
+    : output(output), request(request), lastFlush(chrono::steady_clock::now()), sentFirst(false), isBroken(false) {
+}
+
+bool OutputResultSink::write(const string& item) {
+    if (isBroken) {
+        return false;
+    }
+    batch += item;
+    batch += '\n';
+    if (!sentFirst || batch.size() >= MAX_BATCH_BYTES || chrono::steady_clock::now() - lastFlush >= FLUSH_INTERVAL) {
+        sentFirst = true;
+        return flush();
+    }
+    return true;
+}
+
+bool OutputResultSink::flush() {
+    if (isBroken) {
+        return false;
+    }
+    if (batch.empty()) {
+        return true;
+    }
+    try {
+        output->displayPartialResponseFor(request, batch);
+    } catch (...) {
+        isBroken = true; // the client is gone, tell the command to stop
+        return false;
+    }
+    batch.clear();
+    lastFlush = chrono::steady_clock::now();
+    return true;
+}
@@ -0,0 +1,40 @@
+#ifndef OUTPUT_RESULT_SINK_H
+#define OUTPUT_RESULT_SINK_H
+
+#include "IresultSink.h"
+#include "Ioutput.h"
+#include <chrono>
+#include <string>
+
+using namespace std;
+
+/*
+* Sends the items of a streamed command to the client as data frames.
+* every item is written as one line. items are batched so a broad search does not cost a send per match:
+* the first item is sent right away (so the client sees results quickly), after that a batch is sent when it
+* reaches MAX_BATCH_BYTES or when FLUSH_INTERVAL passed since the last send. flush() sends what is left.
+*/
+class OutputResultSink : public IresultSink {
+private:
+    static const size_t MAX_BATCH_BYTES = 16 * 1024;
+    static constexpr chrono::milliseconds FLUSH_INTERVAL{20};
+
+    Ioutput* output;                        // where the data frames are sent
+    RequestContext request;                 // the request the data frames answer
+    string batch;                           // items waiting to be sent
+    chrono::steady_clock::time_point lastFlush;
+    bool sentFirst;                         // the first item is never delayed
+    bool isBroken;                          // set once sending failed, no more frames are sent after that
+
+public:
+    // Constructor
+    OutputResultSink(Ioutput* output, const RequestContext& request = RequestContext());
+
+    // add an item to the batch and send the batch if it is due
+    bool write(const string& item) override;
+
+    // send the items that are still waiting. returns false if sending failed
+    bool flush();
+};
+
+#endif // OUTPUT_RESULT_SINK_H
@@ -0,0 +1,88 @@
+#include "ProtocolV2.h"
+
+// Define the static constants
+const size_t ProtocolV2::HEADER_SIZE;
+const uint32_t ProtocolV2::MAGIC;
+const uint64_t ProtocolV2::DEFAULT_MAX_BODY_LENGTH;
+const uint8_t ProtocolV2::FLAG_MORE;
+const uint8_t ProtocolV2::FLAG_CONCURRENT;
+const uint8_t ProtocolV2::OPCODE_POST;
+const uint8_t ProtocolV2::OPCODE_GET;
+const uint8_t ProtocolV2::OPCODE_SEARCH;
+const uint8_t ProtocolV2::OPCODE_DELETE;
+const uint8_t ProtocolV2::OPCODE_LIST;
+const uint8_t ProtocolV2::OPCODE_MGET;
+const uint8_t ProtocolV2::OPCODE_MEXISTS;
+const uint8_t ProtocolV2::OPCODE_MDELETE;
+const uint8_t ProtocolV2::OPCODE_STATS;
+
+// read/write a big endian number of 'size' bytes
+static uint64_t readBigEndian(const char* bytes, size_t size) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < size; i++) {
+        value = (value << 8) | static_cast<unsigned char>(bytes[i]);
+    }
+    return value;
+}
+
+static void writeBigEndian(string& out, uint64_t value, size_t size) {
+    for (size_t i = size; i > 0; i--) {
+        out += static_cast<char>((value >> ((i - 1) * 8)) & 0xFF);
+    }
+}
+
+bool ProtocolV2::hasMagic(string_view bytes) {
+    return bytes.size() >= 4 && readBigEndian(bytes.data(), 4) == MAGIC;
+}
+
+bool ProtocolV2::parseHeader(string_view bytes, FrameHeader& header) {
+    if (bytes.size() < HEADER_SIZE) {
+        return false;
+    }
+    if (!hasMagic(bytes)) {
+        throw exception(); // not a v2 frame
+    }
+    const char* data = bytes.data();
+    header.opcode = static_cast<uint8_t>(data[4]);
+    header.flags = static_cast<uint8_t>(data[5]);
+    header.status = static_cast<uint16_t>(readBigEndian(data + 6, 2));
+    header.requestId = static_cast<uint32_t>(readBigEndian(data + 8, 4));
+    header.bodyLength = readBigEndian(data + 12, 8);
+    return true;
+}
+
+string ProtocolV2::encodeHeader(const FrameHeader& header) {
+    string out;
+    out.reserve(HEADER_SIZE);
+    writeBigEndian(out, MAGIC, 4);
+    writeBigEndian(out, header.opcode, 1);
+    writeBigEndian(out, header.flags, 1);
+    writeBigEndian(out, header.status, 2);
+    writeBigEndian(out, header.requestId, 4);
+    writeBigEndian(out, header.bodyLength, 8);
+    return out;
+}
+
+string ProtocolV2::commandName(uint8_t opcode) {
+    switch (opcode) {
+        case OPCODE_POST: return "post";
+        case OPCODE_GET: return "get";
+        case OPCODE_SEARCH: return "search";
+        case OPCODE_DELETE: return "delete";
+        case OPCODE_LIST: return "list";
+        case OPCODE_MGET: return "mget";
+        case OPCODE_MEXISTS: return "mexists";
+        case OPCODE_MDELETE: return "mdelete";
+        case OPCODE_STATS: return "stats";
+        default: return "";
+    }
+}
+
+uint8_t ProtocolV2::opcodeOf(const string& commandName) {
+    for (uint8_t opcode = OPCODE_POST; opcode <= OPCODE_STATS; opcode++) {
+        if (ProtocolV2::commandName(opcode) == commandName) {
+            return opcode;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,75 @@
+// Binary framing of the v2 protocol
+#ifndef PROTOCOL_V2_H
+#define PROTOCOL_V2_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <stdexcept>
+
+using namespace std;
+
+/*
+* v2 frames are used in both directions: a fixed 20 bytes header followed by a raw body.
+* header (all numbers big endian):
+*   magic u32 ("DRV2") | opcode u8 | flags u8 | status u16 | requestId u32 | bodyLength u64
+* a request body is the arguments of the command as is (e.g. "name content" for post), so it can hold
+* newlines and any binary data. a response body is the data of the command without the status line.
+* a connection speaks v2 if its first bytes are the magic, otherwise it is the legacy newline protocol.
+*/
+class ProtocolV2 {
+public:
+    static const size_t HEADER_SIZE = 20;
+    static const uint32_t MAGIC = 0x44525632; // "DRV2"
+
+    // the largest request body a server takes by default (64MB). the length comes from the header, a frame that
+    // claims more is refused before anything is allocated for it. the server can be set to another limit
+    static const uint64_t DEFAULT_MAX_BODY_LENGTH = 64ULL * 1024 * 1024;
+
+    // response flag - more frames of this response follow (data of a streamed command)
+    static const uint8_t FLAG_MORE = 0x01;
+
+    // request flag - the request may run concurrently with the next requests of the connection,
+    // its response may come out of order (the client matches it by the request id)
+    static const uint8_t FLAG_CONCURRENT = 0x02;
+
+    // opcodes of the commands
+    static const uint8_t OPCODE_POST = 1;
+    static const uint8_t OPCODE_GET = 2;
+    static const uint8_t OPCODE_SEARCH = 3;
+    static const uint8_t OPCODE_DELETE = 4;
+    static const uint8_t OPCODE_LIST = 5;
+    static const uint8_t OPCODE_MGET = 6;
+    static const uint8_t OPCODE_MEXISTS = 7;
+    static const uint8_t OPCODE_MDELETE = 8;
+    static const uint8_t OPCODE_STATS = 9;
+
+    struct FrameHeader {
+        uint8_t opcode = 0;
+        uint8_t flags = 0;
+        uint16_t status = 0;
+        uint32_t requestId = 0;
+        uint64_t bodyLength = 0;
+    };
+
+    // true if the bytes start with the magic (at least 4 bytes are needed to tell)
+    static bool hasMagic(string_view bytes);
+
+    /*
+    * Reads a header from the start of the bytes, in place (nothing is copied).
+    * @return false if there are less than HEADER_SIZE bytes yet.
+    * throws exception if the bytes are not a v2 header (bad magic).
+    */
+    static bool parseHeader(string_view bytes, FrameHeader& header);
+
+    // Writes the header in its wire format (HEADER_SIZE bytes)
+    static string encodeHeader(const FrameHeader& header);
+
+    // Command name of an opcode, empty string for an unknown opcode
+    static string commandName(uint8_t opcode);
+
+    // Opcode of a command name, 0 for an unknown command
+    static uint8_t opcodeOf(const string& commandName);
+};
+
+#endif // PROTOCOL_V2_H
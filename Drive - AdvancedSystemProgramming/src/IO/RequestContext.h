@@ -0,0 +1,21 @@
+// Identifies the request a response belongs to
+#ifndef REQUEST_CONTEXT_H
+#define REQUEST_CONTEXT_H
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+* what an output needs to know to answer a request. legacy requests are answered in the order they came,
+* so the default context is enough for them. a v2 request has an id (and an opcode) that its response carries,
+* and a concurrent one may be answered out of order, while the next requests of the connection already run.
+*/
+struct RequestContext {
+    uint8_t opcode = 0;
+    uint32_t requestId = 0;
+    bool concurrent = false;
+    // bytes of the request the input admitted before receiving them (see AdmissionController::admitBytes)
+    size_t admittedBytes = 0;
+};
+
+#endif // REQUEST_CONTEXT_H
@@ -0,0 +1,38 @@
+#include "TcpPolicy.h"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+// Define the static constants
+const int TcpPolicy::NAGLE;
+const int TcpPolicy::NO_DELAY;
+const int TcpPolicy::CORK;
+
+int TcpPolicy::fromName(const string& name) {
+    if (name == "nagle") {
+        return NAGLE;
+    }
+    if (name == "cork") {
+        return CORK;
+    }
+    return NO_DELAY;
+}
+
+bool TcpPolicy::apply(int socket, int policy) {
+    int on = 1;
+    if (policy == NO_DELAY) {
+        return setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on)) == 0;
+    }
+    if (policy == CORK) {
+        return setsockopt(socket, IPPROTO_TCP, TCP_CORK, &on, sizeof(on)) == 0;
+    }
+    return true; // NAGLE - kernel defaults
+}
+
+void TcpPolicy::flush(int socket) {
+    // removing the cork sends what is held, then the next response is corked again
+    int off = 0;
+    int on = 1;
+    setsockopt(socket, IPPROTO_TCP, TCP_CORK, &off, sizeof(off));
+    setsockopt(socket, IPPROTO_TCP, TCP_CORK, &on, sizeof(on));
+}
@@ -0,0 +1,30 @@
+// How a client socket trades latency for fewer packets
+#ifndef TCP_POLICY_H
+#define TCP_POLICY_H
+
+#include <string>
+
+using namespace std;
+
+/*
+* every response is written with one sendmsg, so the kernel does not need Nagle to join its parts.
+* NO_DELAY (the default) sends each response right away. CORK holds partial packets until a response is done,
+* which joins the small data frames of a streamed command. NAGLE keeps the kernel defaults.
+*/
+class TcpPolicy {
+public:
+    static const int NAGLE = 0;
+    static const int NO_DELAY = 1;
+    static const int CORK = 2;
+
+    // Policy by its name ("nagle", "nodelay", "cork"). unknown or empty names give NO_DELAY
+    static int fromName(const string& name);
+
+    // Sets the socket options of the policy. returns false if the socket does not take them (e.g. not TCP)
+    static bool apply(int socket, int policy);
+
+    // With CORK - sends the bytes held by the kernel now (the response is complete)
+    static void flush(int socket);
+};
+
+#endif // TCP_POLICY_H
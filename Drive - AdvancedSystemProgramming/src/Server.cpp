@@ -1,39 +1,154 @@
 #include "Server.h"
+#include <memory>
+#include <sys/epoll.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <cerrno>
 
-Server::Server(int serverPort, IdataBaseHandler* dataBaseHandler, IExecutor* executor)
-    : serverPort(serverPort), dataBaseHandler(dataBaseHandler), executor(executor) {
+// the NUMA node of the acceptor running on this thread (-1 - not pinned), its connections stay on that node
+static thread_local int acceptingNode = -1;
+
+Server::Server(int serverPort, IdataBaseHandler* dataBaseHandler, IExecutor* executor, chrono::milliseconds requestTimeBudget,
+               IExecutor* requestExecutor, int tcpPolicy, int acceptorThreads, AdmissionController* admission)
+    : serverPort(serverPort), dataBaseHandler(dataBaseHandler), executor(executor), requestTimeBudget(requestTimeBudget),
+      requestExecutor(requestExecutor), tcpPolicy(tcpPolicy), acceptorThreads(acceptorThreads), admission(admission),
+      listenTcp(true), maxBodyLength(ProtocolV2::DEFAULT_MAX_BODY_LENGTH), placement(nullptr), reactor(nullptr), storage(nullptr),
+      registry(new CommandRegistry(dataBaseHandler, requestExecutor, admission)),
+      contexts(new ConnectionContextPool(registry.get(), &commandWrapper, requestTimeBudget, requestExecutor, admission)) {
 }
 
-void Server::run() {
+void Server::listenOnUnixSocket(const string& path, bool alsoTcp) {
+    unixSocketPath = path;
+    listenTcp = alsoTcp;
+}
+
+void Server::setConnectionTimeouts(const ConnectionTimeouts& connectionTimeouts) {
+    timeouts = connectionTimeouts;
+}
+
+void Server::setMaxBodyLength(uint64_t length) {
+    maxBodyLength = length;
+}
+
+void Server::setThreadPlacement(const ThreadPlacement* threadPlacement) {
+    placement = threadPlacement;
+}
+
+void Server::useCoroutines(IoReactor* ioReactor, AsyncStorage* asyncStorage) {
+    reactor = ioReactor;
+    storage = asyncStorage;
+}
+
+int Server::openListener(int port, bool reusePort) {
     int serverSocket = socket(AF_INET, SOCK_STREAM, 0);
     if (serverSocket == -1) {
         throw exception(); // Failed to create socket
     }
 
-        sockaddr_in serverAddr;
-        memset(&serverAddr, 0, sizeof(serverAddr));
-        serverAddr.sin_family = AF_INET;
-        serverAddr.sin_addr.s_addr = INADDR_ANY;
-        serverAddr.sin_port = htons(serverPort);
+    int on = 1;
+    if (reusePort && setsockopt(serverSocket, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) == -1) {
+        close(serverSocket);
+        throw exception(); // SO_REUSEPORT is not supported
+    }
 
-    try{
-        if (bind(serverSocket, (sockaddr*)&serverAddr, sizeof(serverAddr)) == -1) {
-            close(serverSocket);
-            throw exception(); // Failed to bind socket
-        }
+    sockaddr_in serverAddr;
+    memset(&serverAddr, 0, sizeof(serverAddr));
+    serverAddr.sin_family = AF_INET;
+    serverAddr.sin_addr.s_addr = INADDR_ANY;
+    serverAddr.sin_port = htons(port);
 
-        if (listen(serverSocket, SOMAXCONN) == -1) {
-            close(serverSocket);
-            throw exception(); // Failed to listen on socket
+    if (bind(serverSocket, (sockaddr*)&serverAddr, sizeof(serverAddr)) == -1) {
+        close(serverSocket);
+        throw exception(); // Failed to bind socket
+    }
+
+    if (listen(serverSocket, SOMAXCONN) == -1) {
+        close(serverSocket);
+        throw exception(); // Failed to listen on socket
+    }
+    return serverSocket;
+}
+
+int Server::openUnixListener(const string& path) {
+    sockaddr_un serverAddr;
+    memset(&serverAddr, 0, sizeof(serverAddr));
+    serverAddr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(serverAddr.sun_path)) {
+        throw exception(); // the path does not fit in the address
+    }
+    path.copy(serverAddr.sun_path, path.size());
+
+    // a socket file stays after its server is gone, and binding to an existing file fails.
+    // only a socket is removed - never a regular file that happens to have the name
+    struct stat existing;
+    if (lstat(path.c_str(), &existing) == 0 && S_ISSOCK(existing.st_mode)) {
+        unlink(path.c_str());
+    }
+
+    int serverSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (serverSocket == -1) {
+        throw exception(); // Failed to create socket
+    }
+    if (bind(serverSocket, (sockaddr*)&serverAddr, sizeof(serverAddr)) == -1) {
+        close(serverSocket);
+        throw exception(); // Failed to bind socket
+    }
+    if (listen(serverSocket, SOMAXCONN) == -1) {
+        close(serverSocket);
+        throw exception(); // Failed to listen on socket
+    }
+    return serverSocket;
+}
+
+void Server::run() {
+    int listeners = acceptorThreads > 1 ? acceptorThreads : 1;
+    vector<int> serverSockets;
+    int unixSocket = -1;
+    try {
+        for (int i = 0; listenTcp && i < listeners; i++) {
+            serverSockets.push_back(openListener(serverPort, listeners > 1));
+        }
+        if (!unixSocketPath.empty()) {
+            unixSocket = openUnixListener(unixSocketPath);
+            serverSockets.push_back(unixSocket);
         }
-    
-        acceptClients(serverSocket); // Start accepting clients - this will run indefinitely
     } catch (...) {
-        close(serverSocket);
+        for (int serverSocket : serverSockets) {
+            close(serverSocket);
+        }
+        return;
+    }
+    if (serverSockets.empty()) {
+        return; // nothing to listen on
+    }
+
+    if (serverSockets.size() == 1) {
+        // Start accepting clients - this will run indefinitely
+        acceptClients(serverSockets[0], serverSockets[0] != unixSocket);
+        close(serverSockets[0]);
+        return;
+    }
+
+    // each acceptor thread has its own socket on the port, the kernel picks the socket of every new connection
+    // so a storm of connections is accepted on all of them at once instead of queuing on one accept loop.
+    // the unix socket (if any) gets an acceptor thread of its own.
+    // with a placement the TCP acceptors take the nodes in turn, but only if every node gets one - otherwise the
+    // connections would all run on the nodes that have an acceptor. the unix socket acceptor is never pinned
+    size_t tcpAcceptors = serverSockets.size() - (unixSocket != -1 ? 1 : 0);
+    bool acceptorPerNode = placement != nullptr && placement->getPolicy() != ThreadPlacement::NONE &&
+                           tcpAcceptors >= placement->getTopology().nodeCount();
+    vector<thread> acceptors;
+    for (size_t i = 0; i < serverSockets.size(); i++) {
+        bool tcp = serverSockets[i] != unixSocket;
+        int node = acceptorPerNode && tcp ? placement->nodeForWorker(i) : -1;
+        acceptors.emplace_back(&Server::runAcceptor, this, serverSockets[i], tcp, node);
+    }
+    for (thread& acceptor : acceptors) {
+        acceptor.join(); // runs indefinitely
     }
 }
 
-void Server::acceptClients(int serverSocket) {
+void Server::acceptClients(int serverSocket, bool tcp) {
     while (true) {
         sockaddr_in clientAddr;
         socklen_t clientAddrLen = sizeof(clientAddr);
@@ -44,15 +159,111 @@ void Server::acceptClients(int serverSocket) {
             continue; // continue accepting other clients
         }
 
-        // Create a new App instance for the connected client
-        CommandWrapper* commandWrapper = new CommandWrapper();
-        CSIO* csio = new CSIO(clientSocket, commandWrapper);
-        App* clientApp = new App(dataBaseHandler, csio, csio);
-        
-        // Use the executor to handle the client in a separate thread
-        executor->execute(*clientApp);
-        
-        // delete clientApp will be handled inside the executor after the thread is done
-        // also csio and commandWrapper will be deleted inside clientApp destructor
+        startClient(clientSocket, tcp);
+    }
+}
+
+void Server::runAcceptor(int serverSocket, bool tcp, int node) {
+    if (node != -1) {
+        acceptingNode = node;
+        placement->placeOnNode(node);
+    }
+    acceptLoop(serverSocket, tcp);
+}
+
+void Server::acceptLoop(int serverSocket, bool tcp) {
+    int epollFd = epoll_create1(0);
+    epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.fd = serverSocket;
+    if (epollFd == -1 || epoll_ctl(epollFd, EPOLL_CTL_ADD, serverSocket, &event) == -1
+        || fcntl(serverSocket, F_SETFL, fcntl(serverSocket, F_GETFL) | O_NONBLOCK) == -1) {
+        if (epollFd != -1) {
+            close(epollFd);
+        }
+        acceptClients(serverSocket, tcp); // no event loop, a blocking accept loop still works
+        return;
+    }
+
+    while (true) {
+        if (epoll_wait(epollFd, &event, 1, -1) == -1) {
+            continue; // interrupted by a signal
+        }
+        // accept everything that is waiting, until accept would block.
+        // the client sockets do not inherit O_NONBLOCK, the connections keep their blocking reads
+        while (true) {
+            int clientSocket = accept(serverSocket, nullptr, nullptr);
+            if (clientSocket == -1) {
+                if (errno == EINTR || errno == ECONNABORTED) {
+                    continue; // this one is gone, there may be others
+                }
+                break;
+            }
+            startClient(clientSocket, tcp);
+        }
+    }
+}
+
+void Server::startClient(int clientSocket, bool tcp) {
+    if (reactor != nullptr && requestExecutor != nullptr) {
+        startAsyncClient(clientSocket, tcp);
+        return;
+    }
+    // take a context (its app and socket) for the connected client, the one an ended connection left if there is
+    ConnectionContextPool::Context connection = contexts->acquire(clientSocket);
+    CSIO* csio = &connection->csio;
+    if (tcp) {
+        csio->setTcpPolicy(tcpPolicy);
+    }
+    csio->setTimeouts(timeouts);
+    csio->setMaxBodyLength(maxBodyLength);
+    if (admission != nullptr && !admission->admitConnection()) {
+        // too many connections - answer now, instead of waiting in the queue of the executor
+        csio->refuse(CommandWrapper::STATUS_SERVICE_UNAVAILABLE);
+        return;
+    }
+
+    // Use the executor to handle the client in a separate thread. the executor owns the connection from now on
+    // and gives its context back to the pool when the app ends (or, if the executor shuts down first, without
+    // running it). with a placement the connection runs on the node that accepted it (node -1: anywhere).
+    // only the connection thread - its concurrent requests go to the request workers on every node
+    const ThreadPlacement* connectionPlacement = placement;
+    int node = acceptingNode;
+    executor->post([connection = move(connection), connectionPlacement, node]() {
+        if (connectionPlacement != nullptr) {
+            connectionPlacement->placeOnNode(node);
+        }
+        connection->app.run();
+    });
+}
+
+// everything a connection served by a coroutine owns. the members are destroyed in reverse order:
+// the app first (it uses the socket), then the socket (closing it)
+struct AsyncClientConnection {
+    unique_ptr<AsyncCSIO> io;
+    unique_ptr<App> app;
+};
+
+// the coroutine owns the connection, it is freed when the client is gone
+static AsyncTask<void> serveAsync(unique_ptr<AsyncClientConnection> connection, AsyncStorage* storage) {
+    co_await connection->app->runAsync(*connection->io, *storage);
+}
+
+void Server::startAsyncClient(int clientSocket, bool tcp) {
+    if (admission != nullptr && !admission->admitConnection()) {
+        // too many connections - answer now (refuse only peeks, it never waits)
+        CSIO csio(clientSocket, &commandWrapper);
+        csio.refuse(CommandWrapper::STATUS_SERVICE_UNAVAILABLE);
+        return;
+    }
+    unique_ptr<AsyncClientConnection> connection(new AsyncClientConnection());
+    connection->io.reset(new AsyncCSIO(clientSocket, reactor, &commandWrapper));
+    if (tcp) {
+        connection->io->setTcpPolicy(tcpPolicy);
     }
+    connection->io->setMaxBodyLength(maxBodyLength);
+    connection->io->setAdmission(admission);
+    connection->app.reset(new App(registry.get(), nullptr, nullptr, requestTimeBudget, requestExecutor, admission));
+    CoroutineScheduler(requestExecutor).spawn(serveAsync(move(connection), storage));
 }
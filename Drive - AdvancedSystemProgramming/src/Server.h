@@ -6,11 +6,21 @@
 #include "App.h"
 #include "CSIO.h"
 #include "CommandWrapper.h"
-#include "ClientThreadExecutor.h"
+#include "CommandRegistry.h"
+#include "ConnectionContextPool.h"
+#include "AdmissionController.h"
+#include "ThreadPlacement.h"
+#include "IoReactor.h"
+#include "AsyncStorage.h"
 #include <sys/socket.h>
+#include <sys/un.h>
 #include <netinet/in.h>
 #include <unistd.h>
 #include <cstring>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
 using namespace std;
 class Server {
 
@@ -25,13 +35,99 @@ private:
     // executor to handle client connections
     IExecutor* executor;
 
+    // time budget of a single request (0 - no limit)
+    chrono::milliseconds requestTimeBudget;
+
+    // executor of the concurrent requests of all connections (nullptr - requests run in order)
+    IExecutor* requestExecutor;
+
+    // TcpPolicy of the client sockets
+    int tcpPolicy;
+
+    // number of threads that accept connections, each on its own SO_REUSEPORT socket (1 - a single blocking accept loop)
+    int acceptorThreads;
+
+    // limits of connections and requests (nullptr - no limits)
+    AdmissionController* admission;
+
+    // false - the server does not listen on TCP (only on its unix socket)
+    bool listenTcp;
+
+    // how long the connections wait for their clients
+    ConnectionTimeouts timeouts;
+
+    // the largest body of a v2 request (see ProtocolV2::DEFAULT_MAX_BODY_LENGTH)
+    uint64_t maxBodyLength;
+
+    // path of the unix domain socket the server listens on, for clients on the same host (empty - none)
+    string unixSocketPath;
+
+    // where the acceptor threads and the connections run (nullptr - anywhere)
+    const ThreadPlacement* placement;
+
+    // with coroutines: wakes the connections when their sockets are ready, and the database they await
+    // (nullptr - every connection runs on a thread of the connection executor)
+    IoReactor* reactor;
+    AsyncStorage* storage;
+
+    // formats the responses of every connection (it has no state)
+    CommandWrapper commandWrapper;
+
+    // the commands of every connection, built once (see CommandRegistry)
+    unique_ptr<CommandRegistry> registry;
+
+    // the contexts of the connections served by threads, reused from one connection to the next
+    unique_ptr<ConnectionContextPool> contexts;
+
+    // hands a new client connection to the executor, or refuses it with 503 if there are too many.
+    // tcp - the TcpPolicy applies to it (a unix socket connection has no TCP options)
+    void startClient(int clientSocket, bool tcp);
+
+    // the same, for a connection served by a coroutine (App::runAsync) on the request executor
+    void startAsyncClient(int clientSocket, bool tcp);
+
+    // event loop of one acceptor thread - waits on its (non blocking) listening socket with epoll
+    // and accepts every pending connection each time it wakes up
+    void acceptLoop(int serverSocket, bool tcp);
+
+    // an acceptor thread: pinned to the node (-1: not pinned, its connections run anywhere), then its acceptLoop
+    void runAcceptor(int serverSocket, bool tcp, int node);
+
 public:
     
     // Constructor
-    Server(int serverPort, IdataBaseHandler* dataBaseHandler, IExecutor* executor);
+    Server(int serverPort, IdataBaseHandler* dataBaseHandler, IExecutor* executor,
+           chrono::milliseconds requestTimeBudget = chrono::milliseconds(0), IExecutor* requestExecutor = nullptr,
+           int tcpPolicy = TcpPolicy::NO_DELAY, int acceptorThreads = 1, AdmissionController* admission = nullptr);
+
+    // creates a socket that listens on the port, throws exception if it can not.
+    // with reusePort many sockets can listen on the same port and the kernel spreads the connections between them
+    static int openListener(int port, bool reusePort);
+
+    // creates a unix domain socket that listens on the path (a socket left there by an old server is replaced),
+    // throws exception if it can not
+    static int openUnixListener(const string& path);
+
+    // listen on a unix domain socket too (alsoTcp) or instead of TCP. call before run()
+    void listenOnUnixSocket(const string& path, bool alsoTcp = true);
     
+    // close the connections of clients that are silent for too long. call before run()
+    void setConnectionTimeouts(const ConnectionTimeouts& connectionTimeouts);
+
+    // refuse v2 requests whose body is longer than this (400, and the connection is closed). call before run()
+    void setMaxBodyLength(uint64_t length);
+
+    // pin the acceptor threads to the NUMA nodes in turn, and run every connection on the node that accepted it.
+    // the placement must outlive the server. call before run()
+    void setThreadPlacement(const ThreadPlacement* threadPlacement);
+
+    // serve every connection with a coroutine (App::runAsync) on the request executor, instead of a thread of
+    // the connection executor each: reactor resumes them, storage runs their database calls. both must outlive
+    // the server, and the server needs a request executor. call before run()
+    void useCoroutines(IoReactor* ioReactor, AsyncStorage* asyncStorage);
+
     // method to accept clients indefinitely
-    void acceptClients(int serverSocket);
+    void acceptClients(int serverSocket, bool tcp = true);
 
     // run method to start the server
     void run();
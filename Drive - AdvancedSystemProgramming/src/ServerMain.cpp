@@ -1,10 +1,49 @@
 #include "Server.h"
 #include "FolderManager.h"
+#include "WorkStealingExecutor.h"
+#include "MPMCQueue.h"
+#include "ElasticExecutor.h"
+#include "LaneExecutor.h"
+#include "UringStorage.h"
+#include <sstream>
 #include <iostream>
 #include <cstdlib> // For getenv, stoi
 
 using namespace std;
 
+// reads a size from an environment variable, defaultValue if it is not set or not a number
+static size_t sizeFromEnv(const char* name, size_t defaultValue) {
+    const char* value = getenv(name);
+    if (value == nullptr) {
+        return defaultValue;
+    }
+    try {
+        return stoull(value);
+    } catch (...) {
+        return defaultValue; // incase of an error
+    }
+}
+
+// reads a comma separated list of sizes (e.g. "8,2,1") from an environment variable, empty if it is not set.
+// an entry that is not a number is read as 0
+static vector<size_t> sizesFromEnv(const char* name) {
+    vector<size_t> sizes;
+    const char* value = getenv(name);
+    if (value == nullptr) {
+        return sizes;
+    }
+    stringstream list(value);
+    string entry;
+    while (getline(list, entry, ',')) {
+        try {
+            sizes.push_back(stoull(entry));
+        } catch (...) {
+            sizes.push_back(0); // incase of an error
+        }
+    }
+    return sizes;
+}
+
 int main(int argc, char* argv[]) {
     if (argc != 2) {
         throw exception(); // Invalid arguments
@@ -16,7 +55,9 @@ int main(int argc, char* argv[]) {
     filesystem::path mainStorage = getenv("DRIVE_STORAGE");
     filesystem::path folderForLogicalNames = getenv("DRIVE_FILE_NAMES");
 
-    // read thread pool size from environment variable
+    // read the size of the connection pool from environment variables: THREAD_POOL_SIZE threads at least,
+    // growing up to THREAD_POOL_MAX (default 4 times the size) when connections wait longer than
+    // THREAD_POOL_GROW_AFTER_MS for a thread, and shrinking back after THREAD_POOL_IDLE_MS without work
     const char* poolSizeEnv = getenv("THREAD_POOL_SIZE");
     int poolSize = std::thread::hardware_concurrency(); // default to number of hardware threads
     if (poolSizeEnv != nullptr) {
@@ -26,17 +67,154 @@ int main(int argc, char* argv[]) {
             poolSize = std::thread::hardware_concurrency(); // incase of an error
         }
     }
+    size_t minPoolSize = poolSize > 0 ? poolSize : 1;
+    size_t maxPoolSize = sizeFromEnv("THREAD_POOL_MAX", minPoolSize * 4);
+    chrono::milliseconds poolGrowAfter(sizeFromEnv("THREAD_POOL_GROW_AFTER_MS", 5));
+    chrono::milliseconds poolIdleTimeout(sizeFromEnv("THREAD_POOL_IDLE_MS", 30000));
+
+    // read the time budget of a single request (e.g. a search) from environment variable, in milliseconds
+    const char* timeBudgetEnv = getenv("REQUEST_TIME_BUDGET_MS");
+    chrono::milliseconds requestTimeBudget(0); // default - no limit
+    if (timeBudgetEnv != nullptr) {
+        try {
+            requestTimeBudget = chrono::milliseconds(stol(timeBudgetEnv));
+        } catch (...) {
+            requestTimeBudget = chrono::milliseconds(0); // incase of an error
+        }
+    }
+
+    // read the size of the pool that runs concurrent (v2) requests from environment variable
+    const char* requestPoolSizeEnv = getenv("REQUEST_POOL_SIZE");
+    int requestPoolSize = std::thread::hardware_concurrency(); // default to number of hardware threads
+    if (requestPoolSizeEnv != nullptr) {
+        try {
+            requestPoolSize = stoi(requestPoolSizeEnv);
+        } catch (...) {
+            requestPoolSize = std::thread::hardware_concurrency(); // incase of an error
+        }
+    }
+
+    // read how client sockets send small responses ("nodelay" - the default, "cork" or "nagle") from environment variable
+    const char* tcpPolicyEnv = getenv("TCP_POLICY");
+    int tcpPolicy = TcpPolicy::fromName(tcpPolicyEnv != nullptr ? tcpPolicyEnv : "");
+
+    // read how many threads accept connections from environment variable (each gets its own SO_REUSEPORT socket)
+    const char* acceptorThreadsEnv = getenv("ACCEPTOR_THREADS");
+    int acceptorThreads = 1; // default - a single accept loop
+    if (acceptorThreadsEnv != nullptr) {
+        try {
+            acceptorThreads = stoi(acceptorThreadsEnv);
+        } catch (...) {
+            acceptorThreads = 1; // incase of an error
+        }
+    }
+
+    // read the admission limits from environment variables (0 - the default, no limit).
+    // beyond them new connections and requests are answered with 503 instead of being queued
+    size_t maxConnections = sizeFromEnv("MAX_CONNECTIONS", 0);
+    size_t maxQueuedRequests = sizeFromEnv("MAX_QUEUED_REQUESTS", 0);
+    size_t maxInFlightBytes = sizeFromEnv("MAX_INFLIGHT_BYTES", 0);
+    AdmissionController admission(maxConnections, maxQueuedRequests, maxInFlightBytes);
+
+    // read where the threads run from environment variable: "none" (the default - anywhere), "cores" (every
+    // request worker on a core of its own) or "nodes" (on a NUMA node). with ACCEPTOR_THREADS >= the number of
+    // nodes the acceptor threads take the nodes in turn and every connection thread runs on the node that accepted
+    // it (with fewer acceptors the connections run anywhere). the concurrent requests of a connection still go to
+    // the request workers of every node
+    const char* placementEnv = getenv("THREAD_PLACEMENT");
+    ThreadPlacement placement(ThreadPlacement::fromName(placementEnv != nullptr ? placementEnv : ""));
 
-    // create database handler and executor
-    IdataBaseHandler* dbHandler = new FolderManager(mainStorage, folderForLogicalNames);
-    IExecutor* executor = new ThreadPoolExecutor();
+    // create database handler and executors
+    FolderManager* folderManager = new FolderManager(mainStorage, folderForLogicalNames);
+    IdataBaseHandler* dbHandler = folderManager;
+    ElasticExecutor* executor = new ElasticExecutor(minPoolSize, maxPoolSize, poolGrowAfter, poolIdleTimeout);
+    admission.watchConnectionPool(executor);
+    // connections block on their sockets, so their requests get a pool of their own.
+    // requests are scheduled by lane (see TaskLane) so searches do not hold up gets, unless REQUEST_SCHEDULER is
+    // "worksteal" (a work stealing pool) or "fifo" (a single queue).
+    // the single queue is a SafeQueue, or the lock free MPMCQueue if TASK_QUEUE is "lockfree"
+    const char* requestSchedulerEnv = getenv("REQUEST_SCHEDULER");
+    string requestScheduler = requestSchedulerEnv != nullptr ? requestSchedulerEnv : "lanes";
+    const char* taskQueueEnv = getenv("TASK_QUEUE");
+    // the request pool keeps the queue wait and run time of every request for STATS, unless TASK_METRICS is "off"
+    const char* taskMetricsEnv = getenv("TASK_METRICS");
+    bool measureTasks = taskMetricsEnv == nullptr || string(taskMetricsEnv) != "off";
+    IExecutor* requestExecutor;
+    size_t requestThreads = requestPoolSize > 0 ? requestPoolSize : 1;
+    if (requestScheduler == "fifo") {
+        ITaskQueue* queue = nullptr; // the default, a SafeQueue
+        if (taskQueueEnv != nullptr && string(taskQueueEnv) == "lockfree") {
+            queue = new MPMCQueue(sizeFromEnv("TASK_QUEUE_CAPACITY", MPMCQueue::DEFAULT_CAPACITY));
+        }
+        requestExecutor = new ThreadPoolExecutor(requestThreads, queue, &placement, measureTasks);
+    } else if (requestScheduler == "worksteal") {
+        requestExecutor = new WorkStealingExecutor(requestThreads, &placement, measureTasks);
+    } else {
+        // the lanes in TaskLane order (interactive, bulk, background). LANE_WEIGHTS - their shares of the workers,
+        // LANE_LIMITS - the most workers each may use at once (0 - all). e.g. "8,2,1" and "0,3,1"
+        vector<LaneLimits> limits = LanePool::defaultLimits(requestThreads);
+        vector<size_t> weights = sizesFromEnv("LANE_WEIGHTS");
+        vector<size_t> maxRunning = sizesFromEnv("LANE_LIMITS");
+        for (size_t lane = 0; lane < limits.size(); lane++) {
+            if (lane < weights.size() && weights[lane] > 0) {
+                limits[lane].weight = static_cast<unsigned>(weights[lane]);
+            }
+            if (lane < maxRunning.size()) {
+                limits[lane].maxRunning = maxRunning[lane];
+            }
+        }
+        requestExecutor = new LaneExecutor(requestThreads, limits, &placement, measureTasks);
+    }
+    admission.watchRequestMetrics(requestExecutor->metrics());
 
     // create and run the server
-    Server server(serverPort, dbHandler, executor);
+    Server server(serverPort, dbHandler, executor, requestTimeBudget, requestExecutor, tcpPolicy, acceptorThreads, &admission);
+    // read how long a connection waits for a silent client before it is closed from environment variables,
+    // in milliseconds (0 - the default, no limit)
+    ConnectionTimeouts timeouts;
+    timeouts.idle = chrono::milliseconds(sizeFromEnv("IDLE_TIMEOUT_MS", 0));
+    timeouts.read = chrono::milliseconds(sizeFromEnv("READ_TIMEOUT_MS", 0));
+    timeouts.write = chrono::milliseconds(sizeFromEnv("WRITE_TIMEOUT_MS", 0));
+    server.setConnectionTimeouts(timeouts);
+    // read the largest body a v2 request may have, in bytes, from environment variable (default 64MB)
+    server.setMaxBodyLength(sizeFromEnv("MAX_REQUEST_BODY_BYTES", ProtocolV2::DEFAULT_MAX_BODY_LENGTH));
+    server.setThreadPlacement(&placement);
+
+    // read how the connections are served from environment variable: "threads" (the default - a thread of the
+    // connection pool each, for as long as the client stays) or "coroutines" (a coroutine each, on the request
+    // workers, that holds no thread while it waits - then the connection pool only runs the database calls)
+    const char* connectionModelEnv = getenv("CONNECTION_MODEL");
+    if (connectionModelEnv != nullptr && string(connectionModelEnv) == "coroutines") {
+        // read how the coroutines wait for the files from environment variable: "uring" (the default - through an
+        // io_uring, no thread waits for the disk) or "blocking" (on the connection pool). without io_uring in the
+        // kernel it is blocking anyway
+        const char* storageIoEnv = getenv("STORAGE_IO");
+        AsyncStorage* asyncStorage = nullptr;
+        if (storageIoEnv == nullptr || string(storageIoEnv) != "blocking") {
+            try {
+                asyncStorage = new UringStorage(folderManager, new IoUring(requestExecutor), executor, requestExecutor);
+            } catch (...) {
+                printf("io_uring is not available, files are read and written on the connection pool\n");
+            }
+        }
+        if (asyncStorage == nullptr) {
+            asyncStorage = new AsyncStorage(dbHandler, executor, requestExecutor);
+        }
+        server.useCoroutines(new IoReactor(requestExecutor), asyncStorage);
+    }
+
+    // read the unix domain socket for clients on the same host (e.g. the web server) from environment variables:
+    // UNIX_SOCKET_PATH - where it is, LISTEN_ON - "both" (the default, TCP too) or "unix" (no TCP)
+    const char* unixSocketEnv = getenv("UNIX_SOCKET_PATH");
+    const char* listenOnEnv = getenv("LISTEN_ON");
+    if (unixSocketEnv != nullptr && *unixSocketEnv != '\0') {
+        server.listenOnUnixSocket(unixSocketEnv, listenOnEnv == nullptr || string(listenOnEnv) != "unix");
+    }
     server.run();
 
     // cleanup (although run() suposed to loop indefinitely)
     delete executor;
+    delete requestExecutor;
     delete dbHandler;
 
     return 0;
@@ -3,6 +3,8 @@
 #include "IdataBaseHandler.h"
 #include "Icompressor.h"
 
+const size_t AddCommand::LARGE_POST_BYTES;
+
 // Constructor
 AddCommand::AddCommand(IdataBaseHandler* dataBase, Icompressor* compressor) 
     : dataBase(dataBase), compressor(compressor)
@@ -30,38 +32,84 @@ bool AddCommand::isValid(string fileName, string content) const
     return true;
 }
 
-pair<int, string> AddCommand::execute(const string& args) const
-{   
+bool AddCommand::parse(const string& args, string& fileName, string& content) const
+{
     // check if there is a space to separate filename and content
-    if (args.find(' ') == string::npos) {
-        return {400, ""};      // 400 - bad request
+    size_t space = args.find(' ');
+    if (space == string::npos) {
+        return false;
     }
 
     // Extract arguments
-    string filename = args.substr(0, args.find(' ')); // first word is the filename
-    string content = args.substr(args.find(' ') + 1); // rest is the content
+    fileName = args.substr(0, space); // first word is the filename
+    content = args.substr(space + 1); // rest is the content
 
     // validate arguments
-    if (!isValid(filename, content)) {
+    return isValid(fileName, content);
+}
+
+pair<int, string> AddCommand::answer(bool valid, bool existed, bool inserted)
+{
+    if (!valid) {
         return {400, ""};      // 400 - bad request
     }
-    
-    // Check if the file name already exists in the database
-    if (dataBase->isExists(filename)) {
+    if (existed) {
         return {404, ""};      // 404 - file already exists
     }
+    if (!inserted) {
+        return {500, ""};      // 500 - internal server error
+    }
+    return {201, ""};          // 201 - Created (no output)
+}
+
+filesystem::path AddCommand::storagePath()
+{
+    return getenv("DRIVE_STORAGE");
+}
+
+pair<int, string> AddCommand::execute(const string& args) const
+{   
+    string filename;
+    string content;
+    bool valid = parse(args, filename, content);
+    bool existed = false;
+    bool inserted = false;
+
+    // Check if the file name already exists in the database
+    if (valid) {
+        existed = dataBase->isExists(filename);
+    }
 
-    // Compress the content before adding to the database
-    string compressedContent = compressor->compressFile(content);
+    // Compress the content and add the file to the database
+    if (valid && !existed) {
+        inserted = dataBase->insertFile(filename, compressor->compressFile(content), storagePath());
+    }
 
-    // get path to storage directory from the environment variable
-    filesystem::path storagePath = getenv("DRIVE_STORAGE");
+    return answer(valid, existed, inserted);
+}
 
-    // Add file to database
-    bool success = dataBase->insertFile(filename, compressedContent, storagePath);
-    if (!success) {
-        return {500, ""};      // 500 - internal server error
+AsyncTask<pair<int, string>> AddCommand::executeAsync(const string& args, AsyncStorage& storage) const
+{
+    string filename;
+    string content;
+    bool valid = parse(args, filename, content);
+    bool existed = false;
+    bool inserted = false;
+
+    // Check if the file name already exists in the database
+    if (valid) {
+        existed = co_await storage.isExists(filename);
     }
 
-    return {201, ""};          // 201 - Created (no output)
-}
\ No newline at end of file
+    // Compress the content and add the file to the database
+    if (valid && !existed) {
+        inserted = co_await storage.insertFile(filename, compressor->compressFile(content), storagePath());
+    }
+
+    co_return answer(valid, existed, inserted);
+}
+
+int AddCommand::lane(const string& args) const
+{
+    return args.size() > LARGE_POST_BYTES ? TaskLane::BULK : TaskLane::INTERACTIVE;
+}
@@ -23,12 +23,32 @@ private:
     // Returns true if the given arguments are valid (used for error handling).
     bool isValid(string fileName, string content) const;
 
+    // the file name (the first word) and the content (the rest) of args, false if they are not valid
+    bool parse(const string& args, string& fileName, string& content) const;
+
+    // the answer of a post once the checks and the database are done: 400 if the arguments were not valid,
+    // 404 if the file already existed, 500 if inserting it failed, else 201
+    static pair<int, string> answer(bool valid, bool existed, bool inserted);
+
+    // the path to the storage directory, from the environment variable
+    static filesystem::path storagePath();
+
 public:
+    // a post with more bytes than this runs in the bulk lane (compressing and writing it takes a while)
+    static const size_t LARGE_POST_BYTES = 64 * 1024;
+
     AddCommand(IdataBaseHandler* dataBase, Icompressor* compressor); // constructor
 
     // the actual execution of the command "add"
     // Returns pair<statusCode, output>
     pair<int, string> execute(const string& args) const override;
+
+    // the same steps as execute, awaiting the storage: the content is compressed on the request executor,
+    // only the database calls block (on the blocking executor of the storage)
+    AsyncTask<pair<int, string>> executeAsync(const string& args, AsyncStorage& storage) const override;
+
+    // small posts are interactive, large ones bulk
+    int lane(const string& args) const override;
 };
 
 #endif // AddCommand_H
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include "BatchCommand.h"
+#include "ParallelRunner.h"
+#include "CancellationToken.h"
+#include <sstream>
+
+const size_t BatchCommand::MAX_ITEMS;
+const size_t BatchCommand::SMALL_BATCH_ITEMS;
+
+// Constructor
+BatchCommand::BatchCommand(ICommands* itemCommand, IExecutor* executor, size_t maxHelpers, int largeBatchLane)
+    : itemCommand(itemCommand), executor(executor), maxHelpers(maxHelpers), largeBatchLane(largeBatchLane)
+{
+}
+
+int BatchCommand::lane(const string& args) const
+{
+    // counts the names only up to the limit, a small batch is cheap to classify
+    istringstream stream(args);
+    string name;
+    size_t names = 0;
+    while (stream >> name) {
+        if (++names > SMALL_BATCH_ITEMS) {
+            return largeBatchLane;
+        }
+    }
+    return itemCommand->lane(name);
+}
+
+BatchCommand::~BatchCommand() {
+    delete itemCommand;
+}
+
+pair<int, string> BatchCommand::execute(const string& args) const
+{
+    // a token that never stops the command
+    return execute(args, CancellationToken());
+}
+
+pair<int, string> BatchCommand::execute(const string& args, const CancellationToken& token) const
+{
+    // the names are separated by whitespace
+    vector<string> names;
+    istringstream stream(args);
+    string name;
+    while (stream >> name) {
+        names.push_back(name);
+    }
+    if (names.empty() || names.size() > MAX_ITEMS) {
+        return {400, ""};      // 400 - bad request
+    }
+
+    // every item writes only its own slot, so the items need no lock
+    vector<pair<int, string>> results(names.size());
+    vector<char> ran(names.size(), false);
+    ParallelRunner::forEach(executor, names.size(), [&](size_t i) {
+        if (token.shouldStop()) {
+            return;
+        }
+        try {
+            results[i] = itemCommand->execute(names[i], token);
+        } catch (...) {
+            results[i] = {500, ""}; // 500 - Internal Server Error
+        }
+        ran[i] = true;
+    }, maxHelpers, lane(args)); // the helpers run in the lane of the batch, also when it runs on its connection
+
+    string output;
+    bool stopped = false;
+    for (size_t i = 0; i < names.size(); i++) {
+        if (!ran[i]) {
+            stopped = true;
+            continue;
+        }
+        output += to_string(results[i].first) + " " + names[i] + " " + to_string(results[i].second.size()) + "\n";
+        output += results[i].second;
+        output += "\n";
+    }
+    return {stopped ? 206 : 200, output};
+}
+
@@ -0,0 +1,53 @@
+#ifndef BatchCommand_H
+#define BatchCommand_H
+
+#include "Icommand.h"
+#include "IExecutor.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+/*
+* runs a single file command (get, delete, exists) for many file names in one request: mget, mdelete, mexists.
+* arguments: <name1> <name2> ... (at most MAX_ITEMS names)
+* the items run in parallel (see ParallelRunner). the output has one entry per name, in the order of the names:
+*   <status> <name> <length>\n<data>\n
+* where data is the output of the single command (length bytes, may hold newlines). the request itself is 200 Ok,
+* or 206 Partial Content if its time budget ran out - then only the items that ran are in the output.
+*/
+class BatchCommand : public ICommands
+{
+private:
+    ICommands* itemCommand;   // the command of a single item, owned by the batch command
+    IExecutor* executor;      // runs the items (nullptr - they run one by one)
+    size_t maxHelpers;        // the most extra tasks of one request
+    int largeBatchLane;       // the lane of a batch with more than SMALL_BATCH_ITEMS names
+
+public:
+    static const size_t MAX_ITEMS = 10000;
+    // a batch of up to this many names runs in the lane of its item command, a larger one in largeBatchLane
+    static const size_t SMALL_BATCH_ITEMS = 64;
+
+    // takes ownership of itemCommand
+    BatchCommand(ICommands* itemCommand, IExecutor* executor, size_t maxHelpers = 8,
+                 int largeBatchLane = TaskLane::BULK);
+    ~BatchCommand();
+
+    // because of the rule of 5
+    BatchCommand(const BatchCommand&) = delete;
+    BatchCommand& operator=(const BatchCommand&) = delete;
+    BatchCommand(BatchCommand&&) = delete;
+    BatchCommand& operator=(BatchCommand&&) = delete;
+
+    // Returns pair<statusCode, output>
+    pair<int, string> execute(const string& args) const override;
+
+    // stops running new items when the token says so
+    pair<int, string> execute(const string& args, const CancellationToken& token) const override;
+
+    int lane(const string& args) const override;
+};
+
+#endif // BatchCommand_H
@@ -0,0 +1,58 @@
+#include "CommandRegistry.h"
+#include "AddCommand.h"
+#include "GetCommand.h"
+#include "SearchCommand.h"
+#include "DeleteCommand.h"
+#include "ListCommand.h"
+#include "ExistsCommand.h"
+#include "BatchCommand.h"
+#include "StatsCommand.h"
+#include "RLEcompressor.h"
+#include "StreamScanner.h"
+
+CommandRegistry::CommandRegistry(IdataBaseHandler* database, IExecutor* requestExecutor, AdmissionController* admission)
+{
+    // Initialize compressors map
+    compressors["RLE"] = new RLEcompressor();
+
+    // Initialize commands map
+    commands["post"] = new AddCommand(database, compressors["RLE"]);
+    commands["get"] = new GetCommand(database, compressors["RLE"]);
+    commands["search"] = new SearchCommand(database, compressors["RLE"], StreamScanner::DEFAULT_CHUNK_SIZE, requestExecutor);
+    commands["delete"] = new DeleteCommand(database);
+    commands["list"] = new ListCommand(database);
+    // batch commands - many names in one request, run in parallel on the request executor.
+    // a large mdelete is a cleanup nobody waits for urgently - it runs in the background lane
+    commands["mget"] = new BatchCommand(new GetCommand(database, compressors["RLE"]), requestExecutor);
+    commands["mexists"] = new BatchCommand(new ExistsCommand(database), requestExecutor);
+    commands["mdelete"] = new BatchCommand(new DeleteCommand(database), requestExecutor, 8, TaskLane::BACKGROUND);
+    if (admission != nullptr) {
+        commands["stats"] = new StatsCommand(admission);
+    }
+}
+
+CommandRegistry::~CommandRegistry() {
+    // Clean up dynamically allocated commands
+    for (auto& pair : commands) {
+        delete pair.second;
+    }
+    // Clean up dynamically allocated compressors
+    for (auto& pair : compressors) {
+        delete pair.second;
+    }
+}
+
+ICommands* CommandRegistry::findCommand(const string& name) const {
+    // find, not operator[] - the map is shared and never written
+    map<string, ICommands*>::const_iterator command = commands.find(name);
+    return command != commands.end() ? command->second : nullptr;
+}
+
+Icompressor* CommandRegistry::findCompressor(const string& name) const {
+    map<string, Icompressor*>::const_iterator compressor = compressors.find(name);
+    return compressor != compressors.end() ? compressor->second : nullptr;
+}
+
+const map<string, ICommands*>& CommandRegistry::allCommands() const {
+    return commands;
+}
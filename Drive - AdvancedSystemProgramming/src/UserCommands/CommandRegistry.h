@@ -0,0 +1,50 @@
+#ifndef CommandRegistry_H
+#define CommandRegistry_H
+
+#include <map>
+#include <string>
+#include "Icommand.h"
+#include "Icompressor.h"
+#include "IdataBaseHandler.h"
+#include "IExecutor.h"
+#include "AdmissionController.h"
+
+using namespace std;
+
+/*
+* The commands of the server and the compressors they use, by name. built once and never changed after the
+* constructor, so one registry is shared by every connection (the commands are const and hold no state of a
+* request) - a new connection finds its commands here instead of building and freeing its own.
+*/
+class CommandRegistry {
+private:
+    // a map of all possible commands
+    map<string, ICommands*> commands;
+
+    // a map of all compressors
+    map<string, Icompressor*> compressors;
+
+public:
+    // the commands of the database. requestExecutor - where searches and batches run their parts (nullptr - in
+    // the request), admission - the gauges of the stats command (nullptr - no stats command)
+    CommandRegistry(IdataBaseHandler* database, IExecutor* requestExecutor = nullptr,
+                    AdmissionController* admission = nullptr);
+    ~CommandRegistry();
+
+    // because of the rule of 5
+    CommandRegistry(const CommandRegistry&) = delete;
+    CommandRegistry& operator=(const CommandRegistry&) = delete;
+    CommandRegistry(CommandRegistry&&) = delete;
+    CommandRegistry& operator=(CommandRegistry&&) = delete;
+
+    // the command with the (lower case) name, nullptr if there is none
+    ICommands* findCommand(const string& name) const;
+
+    // the compressor with the name, nullptr if there is none
+    Icompressor* findCompressor(const string& name) const;
+
+    // every command, by name
+    const map<string, ICommands*>& allCommands() const;
+};
+
+#endif // CommandRegistry_H
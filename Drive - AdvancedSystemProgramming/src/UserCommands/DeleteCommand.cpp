@@ -23,21 +23,45 @@ bool DeleteCommand::isValid(string fileName) const
     return true;
 }
 
-// Execute the command
-pair<int, string> DeleteCommand::execute(const string& fileName) const
+pair<int, string> DeleteCommand::answer(bool valid, bool exists, bool deleted)
 {
-    if (!isValid(fileName)) {
+    if (!valid) {
         return {400, ""};      // 400 - bad request
     }
-    
-    if (!dataBase->isExists(fileName)) {
+    if (!exists) {
         return {404, ""};      // 404 - file not found
     }
-    
-    bool success = dataBase->deleteFile(fileName);
-    if (!success) {
+    if (!deleted) {
         return {500, ""}; // 500 - Internal Server Error
     }
-
     return {204, ""}; // 204 - No Content (success, no output)
-}
\ No newline at end of file
+}
+
+// Execute the command
+pair<int, string> DeleteCommand::execute(const string& fileName) const
+{
+    bool valid = isValid(fileName);
+    bool exists = false;
+    bool deleted = false;
+    if (valid) {
+        exists = dataBase->isExists(fileName);
+    }
+    if (exists) {
+        deleted = dataBase->deleteFile(fileName);
+    }
+    return answer(valid, exists, deleted);
+}
+
+AsyncTask<pair<int, string>> DeleteCommand::executeAsync(const string& fileName, AsyncStorage& storage) const
+{
+    bool valid = isValid(fileName);
+    bool exists = false;
+    bool deleted = false;
+    if (valid) {
+        exists = co_await storage.isExists(fileName);
+    }
+    if (exists) {
+        deleted = co_await storage.deleteFile(fileName);
+    }
+    co_return answer(valid, exists, deleted);
+}
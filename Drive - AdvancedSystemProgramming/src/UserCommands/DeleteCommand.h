@@ -19,12 +19,19 @@ private:
     // Returns true if the given arguments are valid (used for error handling).
     bool isValid(string fileName) const;
 
+    // the answer of a delete once the checks and the database are done: 400 if the file name was not valid,
+    // 404 if the file does not exist, 500 if deleting it failed, else 204
+    static pair<int, string> answer(bool valid, bool exists, bool deleted);
+
 public:
     DeleteCommand(IdataBaseHandler* dataBase); // constructor
 
     // the actual execution of the command "delete"
     // Returns pair<statusCode, output>
     pair<int, string> execute(const string& args) const override;
+
+    // the same steps as execute, awaiting the storage (see ICommands::executeAsync)
+    AsyncTask<pair<int, string>> executeAsync(const string& args, AsyncStorage& storage) const override;
 };
 
 #endif // DeleteCommand_H
\ No newline at end of file
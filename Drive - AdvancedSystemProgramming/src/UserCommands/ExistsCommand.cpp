@@ -0,0 +1,31 @@
+#include "ExistsCommand.h"
+
+// Constructor
+ExistsCommand::ExistsCommand(IdataBaseHandler* dataBase)
+    : dataBase(dataBase)
+{
+}
+
+// Validate file name
+bool ExistsCommand::isValid(string fileName) const
+{
+    if (fileName.empty()) {
+        return false;
+    }
+    if (fileName.find(' ') != string::npos) {
+        return false;
+    }
+    return true;
+}
+
+// Execute the command
+pair<int, string> ExistsCommand::execute(const string& fileName) const
+{
+    if (!isValid(fileName)) {
+        return {400, ""};      // 400 - bad request
+    }
+    if (!dataBase->isExists(fileName)) {
+        return {404, ""};      // 404 - file not found
+    }
+    return {200, ""};          // 200 - OK
+}
@@ -0,0 +1,29 @@
+#ifndef ExistsCommand_H
+#define ExistsCommand_H
+
+#include "Icommand.h"
+#include "IdataBaseHandler.h"
+#include <string>
+#include <utility>
+
+using namespace std;
+
+class IdataBaseHandler; // forward declaration
+
+// tells if a file exists: 200 if it does, 404 if it does not (no output). used by mexists
+class ExistsCommand : public ICommands
+{
+private:
+    IdataBaseHandler* dataBase; // pointer to data base handler
+
+    // Returns true if the given arguments are valid (used for error handling).
+    bool isValid(string fileName) const;
+
+public:
+    ExistsCommand(IdataBaseHandler* dataBase); // constructor
+
+    // Returns pair<statusCode, output>
+    pair<int, string> execute(const string& fileName) const override;
+};
+
+#endif // ExistsCommand_H
@@ -21,26 +21,70 @@ bool GetCommand::isValid(string fileName) const
     return true;
 }
 
-// Execute the command
-pair<int, string> GetCommand::execute(const string& fileName) const
+pair<int, string> GetCommand::answer(bool valid, bool exists, bool read, const string& fileContent) const
 {
-    // Validate arguments
-    if (!isValid(fileName)) {
+    if (!valid) {
         return {400, ""};      // 400 - bad request
     }
-    
-    // Check if file exists in database
-    if (!dataBase->isExists(fileName)) {
+    if (!exists) {
         return {404, ""};      // 404 - file not found
     }
-    
+    if (!read) {
+        return {500, ""};      // 500 - Internal Server Error
+    }
     try {
-        // Retrieve file content from database
-        string fileContent = dataBase->getContent(fileName);
         // Decompress file content before returning it
-        string decompressedContent = compressor->decompressFile(fileContent);
-        return {200, decompressedContent};      // 200 - OK with content
+        return {200, compressor->decompressFile(fileContent)};      // 200 - OK with content
     } catch (...) {
         return {500, ""};      // 500 - Internal Server Error
     }
-}
\ No newline at end of file
+}
+
+// Execute the command
+pair<int, string> GetCommand::execute(const string& fileName) const
+{
+    bool valid = isValid(fileName);
+    bool exists = false;
+    bool read = false;
+    string fileContent;
+
+    // Check if file exists in database
+    if (valid) {
+        exists = dataBase->isExists(fileName);
+    }
+
+    // Retrieve file content from database
+    if (exists) {
+        try {
+            fileContent = dataBase->getContent(fileName);
+            read = true;
+        } catch (...) {
+        }
+    }
+
+    return answer(valid, exists, read, fileContent);
+}
+
+AsyncTask<pair<int, string>> GetCommand::executeAsync(const string& fileName, AsyncStorage& storage) const
+{
+    bool valid = isValid(fileName);
+    bool exists = false;
+    bool read = false;
+    string fileContent;
+
+    // Check if file exists in database
+    if (valid) {
+        exists = co_await storage.isExists(fileName);
+    }
+
+    // Retrieve file content from database
+    if (exists) {
+        try {
+            fileContent = co_await storage.getContent(fileName);
+            read = true;
+        } catch (...) {
+        }
+    }
+
+    co_return answer(valid, exists, read, fileContent);
+}
@@ -22,12 +22,19 @@ private:
     // Returns true if the given arguments are valid (used for error handling).
     bool isValid(string fileName) const;
 
+    // the answer of a get once the checks and the database are done: 400 if the file name was not valid, 404 if
+    // the file does not exist, 500 if its content could not be read or decompressed, else 200 with the content
+    pair<int, string> answer(bool valid, bool exists, bool read, const string& fileContent) const;
+
 public:
     GetCommand(IdataBaseHandler* dataBase, Icompressor* compressor); // constructor
 
     // the actual execution of the command "get"
     // Returns pair<statusCode, output>
     pair<int, string> execute(const string& args) const override;
+
+    // the same steps as execute, awaiting the storage (see ICommands::executeAsync)
+    AsyncTask<pair<int, string>> executeAsync(const string& args, AsyncStorage& storage) const override;
 };
 
 #endif // GetCommand_H
\ No newline at end of file
@@ -3,6 +3,11 @@
 
 #include <string>
 #include <utility>
+#include "IresultSink.h"
+#include "CancellationToken.h"
+#include "TaskLane.h"
+#include "AsyncTask.h"
+#include "AsyncStorage.h"
 
 using namespace std;
 
@@ -16,6 +21,38 @@ public:
     // Execute command and return pair of (status code, output string)
     // Output can be empty for commands like ADD/DELETE
     virtual pair<int, string> execute(const string& args) const = 0;
+
+    // Same as execute(args), but long running commands stop when the token says so
+    // (e.g. returning what they found so far). the default ignores the token.
+    virtual pair<int, string> execute(const string& args, const CancellationToken& token) const {
+        return execute(args);
+    }
+
+    // The coroutine form of execute (see AsyncTask): it suspends while it waits for the storage instead of blocking
+    // its thread. the default runs execute() on the blocking executor of the storage. args must outlive the coroutine
+    virtual AsyncTask<pair<int, string>> executeAsync(const string& args, AsyncStorage& storage) const {
+        co_return co_await storage.offload([this, &args]() { return execute(args); });
+    }
+
+    // Returns true if the output for these arguments should be streamed with executeStreamed instead of returned at once
+    virtual bool isStreamed(const string& args) const {
+        return false;
+    }
+
+    // Returns the lane (see TaskLane) a concurrent request with these arguments runs in. the default is interactive
+    virtual int lane(const string& args) const {
+        return TaskLane::INTERACTIVE;
+    }
+
+    // Execute command and hand every output item to the sink as soon as it is produced.
+    // Returns the status code. the default runs execute() and writes its whole output as one item.
+    virtual int executeStreamed(const string& args, IresultSink& sink, const CancellationToken& token) const {
+        pair<int, string> result = execute(args, token);
+        if (!result.second.empty()) {
+            sink.write(result.second);
+        }
+        return result.first;
+    }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,22 @@
+#ifndef IRESULTSINK_H
+#define IRESULTSINK_H
+
+#include <string>
+
+using namespace std;
+
+// Interface declaration
+// Receives the output items of a streamed command one by one, as soon as the command produces them.
+class IresultSink {
+public:
+
+    // Hands one output item to the receiver.
+    // Returns false if the receiver can not take more items (e.g. the client is gone), the command should stop then.
+    virtual bool write(const string& item) = 0;
+
+    // no need for constructor in Interfaces.
+    // virtual destructor (every Interface should have a virtual destructor)
+    virtual ~IresultSink() = default;
+};
+
+#endif // IRESULTSINK_H
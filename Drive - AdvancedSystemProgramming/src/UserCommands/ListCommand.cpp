@@ -0,0 +1,46 @@
+#include "ListCommand.h"
+#include <algorithm>
+
+// Define the static constants
+const size_t ListCommand::DEFAULT_PAGE_SIZE;
+const size_t ListCommand::MAX_PAGE_SIZE;
+
+// Constructor
+ListCommand::ListCommand(IdataBaseHandler* dataBase)
+    : dataBase(dataBase)
+{
+}
+
+// Validate prefix
+bool ListCommand::isValid(string prefix) const
+{
+    // file names have no spaces, so a prefix with spaces can not match anything
+    if (prefix.find(' ') != string::npos || prefix.find('\t') != string::npos || prefix.find('\n') != string::npos) {
+        return false;
+    }
+    return true;
+}
+
+// Execute the command
+pair<int, string> ListCommand::execute(const string& args) const
+{
+    PagingOptions options;
+    if (!options.parse(args) || !isValid(options.rest)) {
+        return {400, ""};      // 400 - bad request
+    }
+    size_t limit = options.limit == 0 ? DEFAULT_PAGE_SIZE : min(options.limit, MAX_PAGE_SIZE);
+
+    try {
+        vector<string> page = dataBase->getFileNames(options.rest, options.cursor, limit);
+        string result;
+        for (const string& fileName : page) {
+            if (!result.empty()) {
+                result += " ";
+            }
+            result += fileName;
+        }
+        return {200, result};  // 200 - OK with the names of the page
+    } catch (...) {
+        return {500, ""};      // 500 - Internal Server Error
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef ListCommand_H
+#define ListCommand_H
+
+#include "Icommand.h"
+#include "IdataBaseHandler.h"
+#include "PagingOptions.h"
+#include <string>
+#include <utility>
+
+using namespace std;
+
+class IdataBaseHandler; // forward declaration
+
+/*
+* list arguments: [limit=<n>] [cursor=<file name>] <prefix>
+* returns one page of the file names that start with prefix, in name order, separated by spaces.
+* the prefix may be empty ("list " lists everything). the next page starts after cursor=<last name of this page>.
+* a page has at most MAX_PAGE_SIZE names (DEFAULT_PAGE_SIZE when no limit is given), so a listing never costs more than one page.
+*/
+class ListCommand : public ICommands
+{
+private:
+    IdataBaseHandler* dataBase; // pointer to data base handler
+
+    // Returns true if the given prefix is valid (used for error handling).
+    bool isValid(string prefix) const;
+
+public:
+    static const size_t DEFAULT_PAGE_SIZE = 1000;
+    static const size_t MAX_PAGE_SIZE = 10000;
+
+    ListCommand(IdataBaseHandler* dataBase); // constructor
+
+    // the actual execution of the command "list"
+    // Returns pair<statusCode, output>
+    pair<int, string> execute(const string& args) const override;
+};
+
+#endif // ListCommand_H
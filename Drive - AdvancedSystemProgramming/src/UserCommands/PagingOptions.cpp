@@ -0,0 +1,37 @@
+#include "PagingOptions.h"
+#include <algorithm>
+#include <cctype>
+
+bool PagingOptions::parse(const string& args)
+{
+    size_t position = 0;
+    while (position < args.size()) {
+        size_t end = args.find(' ', position);
+        if (end == string::npos) {
+            break; // the last word is never an option
+        }
+        string word = args.substr(position, end - position);
+        if (word.rfind("limit=", 0) == 0) {
+            string value = word.substr(6);
+            if (value.empty() || !all_of(value.begin(), value.end(), ::isdigit)) {
+                return false;
+            }
+            try {
+                limit = stoul(value);
+            } catch (...) {
+                return false; // out of range
+            }
+            if (limit == 0) {
+                return false;
+            }
+        } else if (word.rfind("cursor=", 0) == 0) {
+            cursor = word.substr(7);
+        } else {
+            break; // not an option - the rest starts here
+        }
+        hasOptions = true;
+        position = end + 1;
+    }
+    rest = args.substr(min(position, args.size()));
+    return true;
+}
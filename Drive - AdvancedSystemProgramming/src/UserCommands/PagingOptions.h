@@ -0,0 +1,25 @@
+#ifndef PagingOptions_H
+#define PagingOptions_H
+
+#include <string>
+
+using namespace std;
+
+/*
+* The paging options of commands that return file names: [limit=<n>] [cursor=<file name>] <last word>
+* options are only recognized as leading words, the last word always belongs to the command
+* (e.g. the searched substring), even if it looks like an option.
+* names are returned in name order, so the cursor of the next page is the last name of the previous one.
+*/
+class PagingOptions {
+public:
+    size_t limit = 0;        // 0 - no limit was given
+    string cursor;           // empty - start from the first name
+    string rest;             // the arguments left after the options
+    bool hasOptions = false; // true if at least one option was given
+
+    // Parses the arguments. returns false on a bad option value
+    bool parse(const string& args);
+};
+
+#endif // PagingOptions_H
@@ -1,8 +1,29 @@
 #include "SearchCommand.h"
+#include "SubstringSearch.h"
+#include "ParallelRunner.h"
+#include <algorithm>
+
+// collects the streamed names into one space separated string, for the non streamed execute()
+class JoinedResultSink : public IresultSink {
+public:
+    string result;
+
+    bool write(const string& item) override {
+        if (!result.empty()) {
+            result += " ";
+        }
+        result += item;
+        return true;
+    }
+};
 
 // Constructor
-SearchCommand::SearchCommand(IdataBaseHandler* dataBase, Icompressor* compressor)
-    : dataBase(dataBase), compressor(compressor)
+const size_t SearchCommand::SCOPE_BATCH_SIZE;
+const size_t SearchCommand::MAX_HELPERS;
+const size_t SearchCommand::MAX_SCOPE_SIZE;
+
+SearchCommand::SearchCommand(IdataBaseHandler* dataBase, Icompressor* compressor, size_t chunkSize, IExecutor* executor)
+    : dataBase(dataBase), compressor(compressor), scanner(chunkSize), executor(executor)
 {
 }
 
@@ -17,32 +38,177 @@ bool SearchCommand::isValid(string substr) const
     return true;
 }
 
+int SearchCommand::search(const PagingOptions& options, IresultSink& sink, const CancellationToken& token) const
+{
+    const string& substr = options.rest;
+    size_t found = 0;
+    // names come in name order one page at a time, starting right after the cursor
+    string after = options.cursor;
+    while (true) {
+        vector<string> page = dataBase->getFileNames("", after, NAMES_PAGE_SIZE);
+        for (const string& fileName : page) {
+            if (token.shouldStop()) {
+                return 206;            // 206 - Partial Content, out of time (or the client is gone)
+            }
+            // Check if the file name or the file content contains the search string.
+            // the name is checked first so matching files are never read
+            bool isMatch = SubstringSearch::find(fileName, substr) != string::npos;
+            if (!isMatch) {
+                isMatch = contentContains(fileName, substr, token);
+                if (!isMatch && token.shouldStop()) {
+                    return 206;        // the scan of this file was interrupted
+                }
+            }
+            if (isMatch) {
+                found++;
+                if (!sink.write(fileName)) {
+                    return 200;        // nobody is listening anymore
+                }
+                if (options.limit != 0 && found == options.limit) {
+                    return 200;
+                }
+            }
+        }
+        if (page.size() < NAMES_PAGE_SIZE) {
+            return 200;                // 200 - OK with matching file names
+        }
+        after = page.back();
+    }
+}
+
+bool SearchCommand::contentContains(const string& fileName, const string& substr, const CancellationToken& token) const
+{
+    // read and decompress the content in chunks, stops at the first match
+    unique_ptr<IdecompressStream> content = compressor->openDecompressStream(dataBase->openContentStream(fileName));
+    return scanner.contains(*content, substr, &token);
+}
+
+int SearchCommand::searchIn(const vector<string>& candidates, const string& substr, size_t limit, IresultSink& sink,
+                            const CancellationToken& token) const
+{
+    size_t found = 0;
+    // the files are checked in parallel a batch at a time, so the matches can be written in order
+    // (and a limit does not check much more than it needs)
+    for (size_t start = 0; start < candidates.size(); start += SCOPE_BATCH_SIZE) {
+        size_t count = min(SCOPE_BATCH_SIZE, candidates.size() - start);
+        vector<char> matched(count, false);
+        vector<char> checked(count, false);
+        ParallelRunner::forEach(executor, count, [&](size_t i) {
+            if (token.shouldStop()) {
+                return;
+            }
+            const string& fileName = candidates[start + i];
+            try {
+                matched[i] = dataBase->isExists(fileName) && contentContains(fileName, substr, token);
+            } catch (...) {
+                matched[i] = false; // e.g. deleted while it was read, it does not match
+            }
+            checked[i] = matched[i] || !token.shouldStop();
+        }, MAX_HELPERS, TaskLane::BULK);
+
+        for (size_t i = 0; i < count; i++) {
+            if (matched[i]) {
+                found++;
+                if (!sink.write(candidates[start + i])) {
+                    return 200;        // nobody is listening anymore
+                }
+                if (limit != 0 && found == limit) {
+                    return 200;
+                }
+            }
+        }
+        if (find(checked.begin(), checked.end(), false) != checked.end()) {
+            return 206;                // 206 - Partial Content, out of time (or the client is gone)
+        }
+    }
+    return 200;
+}
+
+bool SearchCommand::parseScope(const string& args, vector<string>& candidates, string& substr)
+{
+    const string prefix = "in=";
+    size_t countEnd = args.find(' ');
+    if (args.compare(0, prefix.size(), prefix) != 0 || countEnd == string::npos || countEnd == prefix.size()) {
+        return false;
+    }
+    string countText = args.substr(prefix.size(), countEnd - prefix.size());
+    if (countText.size() > 5 || !all_of(countText.begin(), countText.end(), ::isdigit)) {
+        return false;
+    }
+    size_t count = stoul(countText);
+    if (count == 0 || count > MAX_SCOPE_SIZE) {
+        return false;
+    }
+    // the names are separated by single spaces, whatever comes after the last one is the substring
+    size_t position = countEnd + 1;
+    for (size_t i = 0; i < count; i++) {
+        size_t nameEnd = args.find(' ', position);
+        if (nameEnd == string::npos || nameEnd == position) {
+            return false;              // missing names, or no substring after them
+        }
+        candidates.push_back(args.substr(position, nameEnd - position));
+        position = nameEnd + 1;
+    }
+    substr = args.substr(position);
+    return true;
+}
+
+int SearchCommand::run(const PagingOptions& options, IresultSink& sink, const CancellationToken& token) const
+{
+    if (options.rest.compare(0, 3, "in=") != 0) {
+        return search(options, sink, token);
+    }
+    vector<string> candidates;
+    string substr;
+    if (!options.cursor.empty() || !parseScope(options.rest, candidates, substr) || !isValid(substr)) {
+        return 400;                    // 400 - bad request
+    }
+    return searchIn(candidates, substr, options.limit, sink, token);
+}
+
 // Execute the command
-pair<int, string> SearchCommand::execute(const string& substr) const
+pair<int, string> SearchCommand::execute(const string& args) const
+{
+    return execute(args, CancellationToken());
+}
+
+pair<int, string> SearchCommand::execute(const string& args, const CancellationToken& token) const
 {
+    PagingOptions options;
     // Validate file content
-    if (!isValid(substr)) {
+    if (!options.parse(args) || !isValid(options.rest)) {
         return {400, ""};          // 400 - bad request
     }
     
     try {
-        // Search for files containing the given content
-        vector<string> allFiles = dataBase->getAllFileNames();
-        string result = "";
-        
-        for (const string& fileName : allFiles) {
-            string fileContent = compressor->decompressFile(dataBase->getContent(fileName));
-            // Check if the file content or file name contains the search string
-            if (fileContent.find(substr) != string::npos || fileName.find(substr) != string::npos) {
-                if (!result.empty()) {
-                    result += " ";
-                }
-                result += fileName;
-            }
-        }
-        
-        return {200, result};              // 200 - OK with matching file names
+        JoinedResultSink names;
+        int status = run(options, names, token);
+        return {status, status == 400 ? "" : names.result};
     } catch (...) {
         return {500, ""};              // 500 - Internal Server Error
     }
 }
+
+bool SearchCommand::isStreamed(const string& args) const
+{
+    PagingOptions options;
+    return options.parse(args) && options.hasOptions;
+}
+
+int SearchCommand::lane(const string& args) const
+{
+    return TaskLane::BULK;
+}
+
+int SearchCommand::executeStreamed(const string& args, IresultSink& sink, const CancellationToken& token) const
+{
+    PagingOptions options;
+    if (!options.parse(args) || !isValid(options.rest)) {
+        return 400;                    // 400 - bad request
+    }
+    try {
+        return run(options, sink, token);
+    } catch (...) {
+        return 500;                    // 500 - Internal Server Error (names sent so far are still valid)
+    }
+}
@@ -2,9 +2,13 @@
 #define SearchCommand_H
 
 #include "Icommand.h"
+#include "IresultSink.h"
 #include "IdataBaseHandler.h"
 #include "Icompressor.h"
 #include "GetCommand.h"
+#include "StreamScanner.h"
+#include "PagingOptions.h"
+#include "IExecutor.h"
 #include <string>
 #include <vector>
 #include <utility>
@@ -14,21 +18,79 @@ using namespace std;
 class IdataBaseHandler; // forward declaration
 class Icompressor; // forward declaration
 
+/*
+* search arguments: [limit=<n>] [cursor=<file name>] <substring>
+* limit - stop after n matching files.
+* cursor - resume a previous search, only files whose name comes after the cursor are checked.
+*          files are visited in name order, so the cursor is simply the last name the client received.
+* when an option is given the matches are streamed to the client as they are found (see CommandWrapper).
+* the search checks its CancellationToken between files and chunks: when the time budget runs out it returns
+* the matches found so far with 206 (Partial Content), when the client is gone it stops right away.
+*
+* scoped search: [limit=<n>] in=<count> <name1> ... <nameN> <substring>
+* only the content of the given files is searched (the caller picked them, their names are not matched), in parallel.
+* matches come in the order of the list, names that do not exist never match. cursor can not be used with in=,
+* a client resumes by sending the rest of its list.
+*/
 class SearchCommand :  public ICommands
 {
 private:
     IdataBaseHandler* dataBase; // pointer to data base handler
     Icompressor* compressor; // pointer to compression handler
+    StreamScanner scanner; // scans file content chunk by chunk, so big files are never fully in memory
+    IExecutor* executor; // checks the files of a scoped search in parallel (nullptr - one by one)
+
+    // how many names are taken from the database at once, the catalog is never copied whole
+    static const size_t NAMES_PAGE_SIZE = 1024;
 
     // Returns true if the given file content is valid (used for error handling).
     bool isValid(string fileContent) const;
 
+    // how many files of a scoped search are checked together, their matches are written before the next ones start
+    static const size_t SCOPE_BATCH_SIZE = 64;
+
+    // the most extra tasks of one scoped search
+    static const size_t MAX_HELPERS = 8;
+
+    // Writes every matching file name to the sink in name order. returns the status code
+    int search(const PagingOptions& options, IresultSink& sink, const CancellationToken& token) const;
+
+    // Writes the candidates whose content matches to the sink, in candidate order. returns the status code
+    int searchIn(const vector<string>& candidates, const string& substr, size_t limit, IresultSink& sink,
+                 const CancellationToken& token) const;
+
+    // true if the content of the file contains substr (false if it does not exist or the token stopped the scan)
+    bool contentContains(const string& fileName, const string& substr, const CancellationToken& token) const;
+
+    // splits "in=<count> <name1> ... <nameN> <substring>". returns false if it is not a valid scope
+    static bool parseScope(const string& args, vector<string>& candidates, string& substr);
+
+    // runs the search the options describe (scoped or over every file)
+    int run(const PagingOptions& options, IresultSink& sink, const CancellationToken& token) const;
+
 public:
-    SearchCommand(IdataBaseHandler* dataBase, Icompressor* compressor); // constructor
+    // the most names a scoped search takes
+    static const size_t MAX_SCOPE_SIZE = 10000;
+
+    // constructor. chunkSize is how many decompressed bytes are scanned at once
+    SearchCommand(IdataBaseHandler* dataBase, Icompressor* compressor, size_t chunkSize = StreamScanner::DEFAULT_CHUNK_SIZE,
+                  IExecutor* executor = nullptr);
 
     // the actual execution of the command "search"
-    // Returns pair<statusCode, output>
+    // Returns pair<statusCode, output> with the matching names separated by spaces
     pair<int, string> execute(const string& args) const override;
+
+    // search until the token says stop
+    pair<int, string> execute(const string& args, const CancellationToken& token) const override;
+
+    // a search with limit/cursor options streams its matches
+    bool isStreamed(const string& args) const override;
+
+    // a search reads every file it checks - always bulk
+    int lane(const string& args) const override;
+
+    // search and write each matching file name to the sink as soon as it is found
+    int executeStreamed(const string& args, IresultSink& sink, const CancellationToken& token) const override;
 };
 
 #endif // SearchCommand_H
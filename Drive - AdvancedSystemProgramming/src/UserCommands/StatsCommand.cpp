@@ -0,0 +1,56 @@
+#include "StatsCommand.h"
+
+// Constructor
+StatsCommand::StatsCommand(const AdmissionController* admission)
+    : admission(admission)
+{
+}
+
+// Execute the command
+pair<int, string> StatsCommand::execute(const string& args) const
+{
+    string result;
+    result += "connections " + to_string(admission->connectionCount()) + "\n";
+    result += "queued_requests " + to_string(admission->queuedRequestCount()) + "\n";
+    result += "in_flight_bytes " + to_string(admission->inFlightByteCount()) + "\n";
+    result += "rejected " + to_string(admission->rejectedCount()) + "\n";
+    result += "reaped " + to_string(admission->reapedCount());
+    const ElasticExecutor* pool = admission->connectionPool();
+    if (pool != nullptr) {
+        PoolStats stats = pool->stats();
+        result += "\npool_threads " + to_string(stats.threads) + "\n";
+        result += "pool_idle_threads " + to_string(stats.idleThreads) + "\n";
+        result += "pool_queued " + to_string(stats.queuedTasks) + "\n";
+        result += "pool_queue_wait_us " + to_string(stats.queueWait.count()) + "\n";
+        result += "pool_max_queue_wait_us " + to_string(stats.maxQueueWait.count()) + "\n";
+        result += "pool_grown " + to_string(stats.grown) + "\n";
+        result += "pool_shrunk " + to_string(stats.shrunk);
+    }
+    // where the requests spent their time: waiting for a worker or running. then the same per worker
+    const TaskMetrics* metrics = admission->requestMetrics();
+    if (metrics != nullptr) {
+        HistogramSnapshot runTime = metrics->runTime();
+        result += "\nrequest_tasks " + to_string(runTime.count);
+        result += histogramLines("request_queue_wait", metrics->queueWait());
+        result += histogramLines("request_run", runTime);
+        for (size_t worker = 0; worker < metrics->workerCount(); worker++) {
+            string prefix = "\nrequest_worker_" + to_string(worker);
+            HistogramSnapshot workerRunTime = metrics->runTime(worker);
+            result += prefix + "_tasks " + to_string(workerRunTime.count);
+            result += prefix + "_queue_wait_p99_us " + to_string(metrics->queueWait(worker).percentile(99) / 1000);
+            result += prefix + "_run_p99_us " + to_string(workerRunTime.percentile(99) / 1000);
+        }
+    }
+    return {200, result};      // 200 - OK
+}
+
+string StatsCommand::histogramLines(const string& name, const HistogramSnapshot& histogram)
+{
+    // recorded in nanoseconds
+    string result;
+    result += "\n" + name + "_p50_us " + to_string(histogram.percentile(50) / 1000);
+    result += "\n" + name + "_p99_us " + to_string(histogram.percentile(99) / 1000);
+    result += "\n" + name + "_p999_us " + to_string(histogram.percentile(99.9) / 1000);
+    result += "\n" + name + "_max_us " + to_string(histogram.max / 1000);
+    return result;
+}
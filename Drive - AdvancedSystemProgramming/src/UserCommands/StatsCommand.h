@@ -0,0 +1,28 @@
+#ifndef StatsCommand_H
+#define StatsCommand_H
+
+#include "Icommand.h"
+#include "AdmissionController.h"
+#include <string>
+#include <utility>
+
+using namespace std;
+
+// reports the load of the server, one "name value" line per gauge (and the connection pool and the request
+// metrics, if they are watched). the arguments are ignored
+class StatsCommand : public ICommands
+{
+private:
+    const AdmissionController* admission; // the gauges of the server
+
+    // the lines of one histogram of the request metrics: name_p50_us, name_p99_us, name_p999_us, name_max_us
+    static string histogramLines(const string& name, const HistogramSnapshot& histogram);
+
+public:
+    StatsCommand(const AdmissionController* admission); // constructor
+
+    // Returns pair<statusCode, output>
+    pair<int, string> execute(const string& args) const override;
+};
+
+#endif // StatsCommand_H
@@ -0,0 +1,202 @@
+#include <gtest/gtest.h>
+#include "App.h"
+#include "CSIO.h"
+#include "ProtocolV2.h"
+#include "ThreadPoolExecutor.h"
+#include <sys/socket.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+
+using namespace std;
+
+// Mock database, files whose name starts with "slow" take a while to read
+class MockDataBaseHandlerApp : public IdataBaseHandler {
+public:
+    map<string, string> storedFiles; // RLE compressed content
+
+    bool isExists(const string fileName) override { return storedFiles.count(fileName) > 0; }
+    bool insertFile(const string fileName, const string content, const filesystem::path filePath) override {
+        storedFiles[fileName] = content;
+        return true;
+    }
+    vector<string> getAllFileNames() override {
+        vector<string> names;
+        for (const auto& file : storedFiles) {
+            names.push_back(file.first);
+        }
+        return names;
+    }
+    string getContent(const string fileName) override {
+        if (fileName.rfind("slow", 0) == 0) {
+            this_thread::sleep_for(chrono::milliseconds(100));
+        }
+        return storedFiles[fileName];
+    }
+    bool deleteFile(const string fileName) override { return storedFiles.erase(fileName) > 0; }
+};
+
+// --- Fixture Class ---
+// the app runs on its own thread and talks to the test through a socket pair, like a connected client
+class AppTest : public ::testing::Test {
+protected:
+    int socks[2]; // socks[0] used by the app (server side), socks[1] used by test (client side)
+    MockDataBaseHandlerApp database;
+    CommandWrapper* wrapper;
+    CSIO* csio;
+    ThreadPoolExecutor* requestExecutor;
+    App* app;
+    thread appThread;
+    AdmissionController* admission = nullptr; // set by fixtures that test the limits
+
+    void SetUp() override {
+        ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, socks), 0);
+        database.storedFiles["slow.txt"] = "4/s";
+        database.storedFiles["fast.txt"] = "4/f";
+        wrapper = new CommandWrapper();
+        csio = new CSIO(socks[0], wrapper);
+        csio->setAdmission(admission); // the bodies of v2 requests are admitted before they are received
+        requestExecutor = new ThreadPoolExecutor(2);
+        app = new App(&database, csio, csio, chrono::milliseconds(0), requestExecutor, admission);
+        appThread = thread([this]() { app->run(); });
+    }
+
+    void TearDown() override {
+        // the client leaves, the app loop ends after its requests are done
+        shutdown(socks[1], SHUT_RDWR);
+        appThread.join();
+        close(socks[1]);
+        delete app;
+        delete requestExecutor;
+        delete csio;
+        delete wrapper;
+    }
+
+    void SendRequest(uint8_t opcode, uint32_t requestId, uint8_t flags, const string& body) {
+        ProtocolV2::FrameHeader header;
+        header.opcode = opcode;
+        header.flags = flags;
+        header.requestId = requestId;
+        header.bodyLength = body.size();
+        string frame = ProtocolV2::encodeHeader(header) + body;
+        ASSERT_EQ(write(socks[1], frame.data(), frame.size()), (ssize_t)frame.size());
+    }
+
+    string ReadBytes(size_t bytes) {
+        string data(bytes, '\0');
+        size_t totalRead = 0;
+        while (totalRead < bytes) {
+            ssize_t r = read(socks[1], &data[totalRead], bytes - totalRead);
+            if (r <= 0) break;
+            totalRead += r;
+        }
+        return data.substr(0, totalRead);
+    }
+
+    // reads a response frame, returns its request id and body
+    pair<uint32_t, string> ReadResponse() {
+        ProtocolV2::FrameHeader header;
+        return ReadResponse(header);
+    }
+
+    // reads a response frame and its header
+    pair<uint32_t, string> ReadResponse(ProtocolV2::FrameHeader& header) {
+        EXPECT_TRUE(ProtocolV2::parseHeader(ReadBytes(ProtocolV2::HEADER_SIZE), header));
+        return {header.requestId, ReadBytes(header.bodyLength)};
+    }
+};
+
+// the app of a server that takes at most 10 bytes of requests at a time
+class AppAdmissionTest : public AppTest {
+protected:
+    AdmissionController limits{0, 0, 10};
+
+    void SetUp() override {
+        admission = &limits;
+        AppTest::SetUp();
+    }
+};
+
+// --- Test Cases ---
+
+// a slow concurrent request does not hold back the requests after it
+TEST_F(AppTest, ConcurrentRequestsCompleteOutOfOrder) {
+    SendRequest(ProtocolV2::OPCODE_GET, 1, ProtocolV2::FLAG_CONCURRENT, "slow.txt");
+    SendRequest(ProtocolV2::OPCODE_GET, 2, ProtocolV2::FLAG_CONCURRENT, "fast.txt");
+
+    EXPECT_EQ(ReadResponse(), make_pair(2u, string("ffff")));
+    EXPECT_EQ(ReadResponse(), make_pair(1u, string("ssss")));
+}
+
+// a client that sends its request and then half-closes the connection still gets the answer
+TEST_F(AppTest, HalfClosedClientIsAnswered) {
+    SendRequest(ProtocolV2::OPCODE_GET, 1, 0, "slow.txt");
+    ASSERT_EQ(shutdown(socks[1], SHUT_WR), 0);
+
+    EXPECT_EQ(ReadResponse(), make_pair(1u, string("ssss")));
+}
+
+// without the flag the requests of a connection are answered in order
+TEST_F(AppTest, OrderedRequestsKeepTheirOrder) {
+    SendRequest(ProtocolV2::OPCODE_GET, 1, 0, "slow.txt");
+    SendRequest(ProtocolV2::OPCODE_GET, 2, 0, "fast.txt");
+
+    EXPECT_EQ(ReadResponse(), make_pair(1u, string("ssss")));
+    EXPECT_EQ(ReadResponse(), make_pair(2u, string("ffff")));
+}
+
+// a request beyond the limit is answered with 503 from its header (its body is never received, so the
+// connection ends), while the admitted one still runs and is answered
+TEST_F(AppAdmissionTest, OverloadIsAnsweredWithServiceUnavailable) {
+    SendRequest(ProtocolV2::OPCODE_GET, 1, ProtocolV2::FLAG_CONCURRENT, "slow.txt");
+    SendRequest(ProtocolV2::OPCODE_GET, 2, ProtocolV2::FLAG_CONCURRENT, "fast.txt");
+
+    ProtocolV2::FrameHeader header;
+    EXPECT_EQ(ReadResponse(header), make_pair(2u, string("")));
+    EXPECT_EQ(header.status, CommandWrapper::STATUS_SERVICE_UNAVAILABLE);
+    EXPECT_EQ(ReadResponse(header), make_pair(1u, string("ssss")));
+    EXPECT_EQ(header.status, CommandWrapper::STATUS_OK);
+    EXPECT_EQ(limits.rejectedCount(), 1u);
+
+    // the answered request gives its bytes back
+    for (int waited = 0; limits.inFlightByteCount() > 0 && waited < 1000; waited++) {
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    EXPECT_EQ(limits.inFlightByteCount(), 0u);
+}
+
+// the limit bounds the memory of the requests: a header that claims more than fits is refused before
+// anything is allocated for its body
+TEST_F(AppAdmissionTest, BodyIsAdmittedBeforeItIsReceived) {
+    ProtocolV2::FrameHeader request;
+    request.opcode = ProtocolV2::OPCODE_POST;
+    request.requestId = 4;
+    request.bodyLength = 1 << 20; // within the largest body, beyond the bytes the server takes
+    string encoded = ProtocolV2::encodeHeader(request);
+    ASSERT_EQ(write(socks[1], encoded.data(), encoded.size()), (ssize_t)encoded.size());
+
+    ProtocolV2::FrameHeader header;
+    EXPECT_EQ(ReadResponse(header), make_pair(4u, string("")));
+    EXPECT_EQ(header.status, CommandWrapper::STATUS_SERVICE_UNAVAILABLE);
+    EXPECT_EQ(limits.inFlightByteCount(), 0u);
+}
+
+// a request that is refused after its body was admitted gives the bytes back
+TEST_F(AppAdmissionTest, RefusedRequestGivesItsBytesBack) {
+    SendRequest(99, 1, 0, "unknown"); // no such opcode - 400
+    ProtocolV2::FrameHeader header;
+    EXPECT_EQ(ReadResponse(header), make_pair(1u, string("")));
+    EXPECT_EQ(header.status, CommandWrapper::STATUS_BAD_REQUEST);
+    EXPECT_EQ(limits.inFlightByteCount(), 0u);
+
+    SendRequest(ProtocolV2::OPCODE_GET, 2, 0, "fast.txt");
+    EXPECT_EQ(ReadResponse(header), make_pair(2u, string("ffff")));
+}
+
+TEST_F(AppAdmissionTest, StatsReportsTheGauges) {
+    SendRequest(ProtocolV2::OPCODE_STATS, 1, 0, "");
+    // the stats request has no body, it adds nothing to the bytes in flight
+    EXPECT_EQ(ReadResponse().second, "connections 0\nqueued_requests 0\nin_flight_bytes 0\nrejected 0\nreaped 0");
+}
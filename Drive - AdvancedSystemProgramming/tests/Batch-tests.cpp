@@ -0,0 +1,124 @@
+#include "gtest/gtest.h"
+#include "BatchCommand.h"
+#include "GetCommand.h"
+#include "DeleteCommand.h"
+#include "ExistsCommand.h"
+#include "RLEcompressor.h"
+#include "ThreadPoolExecutor.h"
+#include "CancellationToken.h"
+#include "IdataBaseHandler.h"
+#include <string>
+#include <map>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+// --- Mocks ---
+
+// the items of a batch run on several threads, so the mock locks its map
+class MockDataBaseHandlerBatch : public IdataBaseHandler {
+public:
+    map<string, string> storedFiles; // RLE compressed content
+    mutex lock;
+    chrono::milliseconds readDelay{0};
+
+    bool isExists(const string fileName) override {
+        lock_guard<mutex> guard(lock);
+        return storedFiles.find(fileName) != storedFiles.end();
+    }
+    bool deleteFile(const string fileName) override {
+        lock_guard<mutex> guard(lock);
+        return storedFiles.erase(fileName) > 0;
+    }
+    string getContent(const string fileName) override {
+        this_thread::sleep_for(readDelay);
+        lock_guard<mutex> guard(lock);
+        return storedFiles[fileName];
+    }
+
+    // Unused
+    bool insertFile(const string, const string, const filesystem::path) override { return true; }
+    vector<string> getAllFileNames() override { return {}; }
+};
+
+// --- Fixture ---
+
+class BatchCommandTest : public ::testing::Test {
+protected:
+    MockDataBaseHandlerBatch database;
+    RLEcompressor compressor;
+    ThreadPoolExecutor* executor;
+
+    void SetUp() override {
+        executor = new ThreadPoolExecutor(4);
+        database.storedFiles["a.txt"] = compressor.compressFile("hello");
+        database.storedFiles["b.txt"] = compressor.compressFile("two\nlines");
+    }
+
+    void TearDown() override {
+        delete executor;
+    }
+};
+
+// --- Tests ---
+
+TEST_F(BatchCommandTest, MgetReturnsEveryItemInOrder) {
+    BatchCommand mget(new GetCommand(&database, &compressor), executor);
+
+    pair<int, string> result = mget.execute("a.txt missing.txt b.txt");
+    EXPECT_EQ(result.first, 200);
+    EXPECT_EQ(result.second,
+              "200 a.txt 5\nhello\n"
+              "404 missing.txt 0\n\n"
+              "200 b.txt 9\ntwo\nlines\n");
+}
+
+TEST_F(BatchCommandTest, MexistsAndMdelete) {
+    BatchCommand mexists(new ExistsCommand(&database), executor);
+    BatchCommand mdelete(new DeleteCommand(&database), executor);
+
+    EXPECT_EQ(mexists.execute("a.txt c.txt").second, "200 a.txt 0\n\n404 c.txt 0\n\n");
+    EXPECT_EQ(mdelete.execute("a.txt  b.txt c.txt").second, "204 a.txt 0\n\n204 b.txt 0\n\n404 c.txt 0\n\n");
+    EXPECT_TRUE(database.storedFiles.empty());
+}
+
+TEST_F(BatchCommandTest, BadArguments) {
+    BatchCommand mget(new GetCommand(&database, &compressor), executor);
+    EXPECT_EQ(mget.execute("").first, 400);
+    EXPECT_EQ(mget.execute("   ").first, 400);
+
+    string tooMany;
+    for (size_t i = 0; i <= BatchCommand::MAX_ITEMS; i++) {
+        tooMany += "f" + to_string(i) + " ";
+    }
+    EXPECT_EQ(mget.execute(tooMany).first, 400);
+}
+
+TEST_F(BatchCommandTest, ItemsRunInParallel) {
+    string names;
+    for (int i = 0; i < 8; i++) {
+        names += "a.txt ";
+    }
+    database.readDelay = chrono::milliseconds(50);
+    BatchCommand mget(new GetCommand(&database, &compressor), executor);
+
+    auto start = chrono::steady_clock::now();
+    EXPECT_EQ(mget.execute(names).first, 200);
+    // 8 reads of 50ms on the caller and 4 pool threads take 100ms, one by one they would take 400ms
+    EXPECT_LT(chrono::steady_clock::now() - start, chrono::milliseconds(300));
+}
+
+TEST_F(BatchCommandTest, WithoutExecutorRunsOnCaller) {
+    BatchCommand mget(new GetCommand(&database, &compressor), nullptr);
+    EXPECT_EQ(mget.execute("b.txt").second, "200 b.txt 9\ntwo\nlines\n");
+}
+
+TEST_F(BatchCommandTest, StopsWhenBudgetRunsOut) {
+    database.readDelay = chrono::milliseconds(30);
+    BatchCommand mget(new GetCommand(&database, &compressor), nullptr);
+
+    // the first item runs, the token expires during it and the rest are skipped
+    CancellationToken token(chrono::milliseconds(10));
+    EXPECT_EQ(mget.execute("a.txt b.txt a.txt", token), make_pair(206, string("200 a.txt 5\nhello\n")));
+}
@@ -4,6 +4,7 @@
 #include <string>
 #include <iostream>
 #include <sstream>
+#include <vector>
 
 using namespace std;
 
@@ -30,6 +31,34 @@ public:
     }
 };
 
+// Mock command that streams a fixed list of items
+class MockStreamedCommand : public ICommands {
+public:
+    vector<string> items;
+
+    pair<int, string> execute(const string& args) const override { return {CommandWrapper::STATUS_OK, ""}; }
+    bool isStreamed(const string& args) const override { return true; }
+    int executeStreamed(const string& args, IresultSink& sink, const CancellationToken& token) const override {
+        for (const string& item : items) {
+            if (!sink.write(item)) {
+                break;
+            }
+        }
+        return CommandWrapper::STATUS_OK;
+    }
+};
+
+// Mock output that records every frame sent to the client
+class MockOutput : public Ioutput {
+public:
+    mutable vector<string> frames;
+
+    void displayCommands(map<string, ICommands*> commands) const override {}
+    void displayOutput(string output) const override { frames.push_back(output); }
+    void displayResponse(int statusCode, const string& data) const override { frames.push_back(to_string(statusCode) + " " + data); }
+    void displayPartialResponse(const string& data) const override { frames.push_back(data); }
+};
+
 // --- Fixture Class ---
 class CommandWrapperTest : public ::testing::Test {
 protected:
@@ -144,4 +173,39 @@ TEST_F(CommandWrapperTest, EdgeCases) {
     result = wrapper->executeCommand(cmd, "");
     EXPECT_EQ(result, "200 Ok\n\nOutput with newline\n");
     delete cmd;
-}
\ No newline at end of file
+}
+
+// Test streamed commands: data frames first, the status line closes the response
+TEST_F(CommandWrapperTest, StreamedCommand) {
+    MockStreamedCommand command;
+    command.items = {"a.txt", "b.txt", "c.txt"};
+    MockOutput output;
+
+    string status = wrapper->executeStreamedCommand(&command, "args", &output, CancellationToken());
+
+    EXPECT_EQ(status, "200 Ok\n\n");
+    // the first item is sent right away, the rest is batched until the end
+    ASSERT_EQ(output.frames.size(), 2);
+    EXPECT_EQ(output.frames[0], "a.txt\n");
+    EXPECT_EQ(output.frames[1], "b.txt\nc.txt\n");
+
+    // no data frames when nothing is produced
+    MockStreamedCommand emptyCommand;
+    MockOutput emptyOutput;
+    EXPECT_EQ(wrapper->executeStreamedCommand(&emptyCommand, "args", &emptyOutput, CancellationToken()), "200 Ok\n\n");
+    EXPECT_TRUE(emptyOutput.frames.empty());
+}
+
+// Test partial content keeps the data like 200
+TEST_F(CommandWrapperTest, PartialContent) {
+    string result = wrapper->formatOutput(CommandWrapper::STATUS_PARTIAL_CONTENT, "a.txt b.txt");
+    EXPECT_EQ(result, "206 Partial Content\n\na.txt b.txt\n");
+}
+
+// the status map is shared and never written, an unknown code has no status line
+TEST_F(CommandWrapperTest, UnknownStatusCode) {
+    EXPECT_EQ(wrapper->statusMessage(299), "");
+    EXPECT_EQ(wrapper->formatOutput(299, "data"), "\n");
+    CommandWrapper other;
+    EXPECT_EQ(&other.statusMessage(CommandWrapper::STATUS_OK), &wrapper->statusMessage(CommandWrapper::STATUS_OK));
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include "ListCommand.h"
+#include "IdataBaseHandler.h"
+#include <string>
+#include <vector>
+#include <map>
+
+using namespace std;
+
+// --- Mocks ---
+
+// Mock Database that only implements getAllFileNames, so ListCommand goes through the default getFileNames
+class MockDataBaseHandlerList : public IdataBaseHandler {
+public:
+    map<string, string> storedFiles;
+    size_t lastLimit = 0;
+
+    vector<string> getAllFileNames() override {
+        vector<string> names;
+        for (auto const& [key, val] : storedFiles) {
+            names.push_back(key);
+        }
+        return names;
+    }
+
+    vector<string> getFileNames(const string& prefix, const string& startAfter, size_t limit) override {
+        lastLimit = limit;
+        return IdataBaseHandler::getFileNames(prefix, startAfter, limit);
+    }
+
+    // Unused
+    string getContent(const string) override { return ""; }
+    bool isExists(const string) override { return false; }
+    bool insertFile(const string, const string, const filesystem::path) override { return true; }
+    bool deleteFile(const string) override { return false; }
+};
+
+// --- Fixture ---
+
+class ListCommandTest : public ::testing::Test {
+protected:
+    MockDataBaseHandlerList* mockDB;
+    ListCommand* listCmd;
+
+    void SetUp() override {
+        mockDB = new MockDataBaseHandlerList();
+        listCmd = new ListCommand(mockDB);
+        for (const char* name : {"a.txt", "docs_1", "docs_2", "docs_3", "e.txt"}) {
+            mockDB->storedFiles[name] = "content";
+        }
+    }
+
+    void TearDown() override {
+        delete listCmd;
+        delete mockDB;
+    }
+};
+
+// --- Tests ---
+
+TEST_F(ListCommandTest, ListByPrefix) {
+    EXPECT_EQ(listCmd->execute("docs_"), make_pair(200, string("docs_1 docs_2 docs_3")));
+    EXPECT_EQ(listCmd->execute("zzz"), make_pair(200, string("")));
+    // empty prefix lists everything
+    EXPECT_EQ(listCmd->execute(""), make_pair(200, string("a.txt docs_1 docs_2 docs_3 e.txt")));
+}
+
+TEST_F(ListCommandTest, Paging) {
+    EXPECT_EQ(listCmd->execute("limit=2 docs_"), make_pair(200, string("docs_1 docs_2")));
+    EXPECT_EQ(listCmd->execute("limit=2 cursor=docs_2 docs_"), make_pair(200, string("docs_3")));
+    // options with an empty prefix (note the trailing space)
+    EXPECT_EQ(listCmd->execute("limit=1 cursor=docs_3 "), make_pair(200, string("e.txt")));
+}
+
+TEST_F(ListCommandTest, PageSizeIsBounded) {
+    listCmd->execute("");
+    EXPECT_EQ(mockDB->lastLimit, ListCommand::DEFAULT_PAGE_SIZE);
+    listCmd->execute("limit=99999999 ");
+    EXPECT_EQ(mockDB->lastLimit, ListCommand::MAX_PAGE_SIZE);
+}
+
+TEST_F(ListCommandTest, InvalidArgs) {
+    EXPECT_EQ(listCmd->execute("limit=0 docs_").first, 400);
+    EXPECT_EQ(listCmd->execute("limit=x docs_").first, 400);
+    EXPECT_EQ(listCmd->execute("docs_ more").first, 400); // a prefix can not have spaces
+}
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include "Server.h"
+#include "ClientThreadExecutor.h"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <string>
+#include <thread>
+#include <chrono>
+
+using namespace std;
+
+// the database of the listener tests is never used for more than looking up a missing file
+class MockDataBaseHandlerListener : public IdataBaseHandler {
+public:
+    bool isExists(const string fileName) override { return false; }
+    bool insertFile(const string fileName, const string content, const filesystem::path filePath) override { return false; }
+    vector<string> getAllFileNames() override { return {}; }
+    string getContent(const string fileName) override { return ""; }
+    bool deleteFile(const string fileName) override { return false; }
+};
+
+static int testPort(int offset) {
+    return 20000 + getpid() % 10000 + offset;
+}
+
+// connects to the port on this host, -1 if it can not
+static int connectTo(int port) {
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+    if (connect(sock, (sockaddr*)&address, sizeof(address)) == -1) {
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+TEST(ListenerTest, ReusePortListenersShareThePort) {
+    int port = testPort(0);
+    int first = Server::openListener(port, true);
+    int second = Server::openListener(port, true);
+    EXPECT_NE(first, second);
+    close(first);
+    close(second);
+}
+
+TEST(ListenerTest, PlainListenerOwnsThePort) {
+    int port = testPort(1);
+    int first = Server::openListener(port, false);
+    EXPECT_THROW(Server::openListener(port, false), exception);
+    close(first);
+}
+
+// every connection gets answered, whichever acceptor thread the kernel gave it to
+TEST(ListenerTest, AcceptorThreadsServeConnections) {
+    int port = testPort(2);
+    // run() never returns, so the server and what it uses live until the tests end
+    MockDataBaseHandlerListener* database = new MockDataBaseHandlerListener();
+    ClientThreadExecutor* executor = new ClientThreadExecutor();
+    Server* server = new Server(port, database, executor, chrono::milliseconds(0), nullptr, TcpPolicy::NO_DELAY, 3);
+    thread([server]() { server->run(); }).detach();
+
+    for (int i = 0; i < 20; i++) {
+        int sock = connectTo(port);
+        for (int attempt = 0; sock == -1 && attempt < 100; attempt++) {
+            this_thread::sleep_for(chrono::milliseconds(10)); // not listening yet
+            sock = connectTo(port);
+        }
+        ASSERT_NE(sock, -1);
+
+        string request = "get missing.txt\n";
+        ASSERT_EQ(send(sock, request.data(), request.size(), 0), (ssize_t)request.size());
+        string response;
+        char buffer[256];
+        ssize_t received;
+        while (response.find("404") == string::npos && (received = recv(sock, buffer, sizeof(buffer), 0)) > 0) {
+            response.append(buffer, received);
+        }
+        EXPECT_NE(response.find("404 Not Found"), string::npos);
+        close(sock);
+    }
+}
+
+// clients on the same host can connect to the unix socket, TCP is off
+TEST(ListenerTest, UnixSocketServesConnections) {
+    string path = (filesystem::temp_directory_path() / ("listener-test-" + to_string(getpid()) + ".sock")).string();
+    // a socket left by an old server does not stop a new one
+    close(Server::openUnixListener(path));
+
+    MockDataBaseHandlerListener* database = new MockDataBaseHandlerListener();
+    ClientThreadExecutor* executor = new ClientThreadExecutor();
+    Server* server = new Server(testPort(3), database, executor);
+    server->listenOnUnixSocket(path, false);
+    thread([server]() { server->run(); }).detach();
+
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    path.copy(address.sun_path, path.size());
+    int sock = -1;
+    for (int attempt = 0; sock == -1 && attempt < 100; attempt++) {
+        // the old socket file stays until the server replaced it, connecting to it is refused
+        sock = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (connect(sock, (sockaddr*)&address, sizeof(address)) == -1) {
+            close(sock);
+            sock = -1;
+            this_thread::sleep_for(chrono::milliseconds(10));
+        }
+    }
+    ASSERT_NE(sock, -1);
+
+    string request = "get missing.txt\n";
+    ASSERT_EQ(send(sock, request.data(), request.size(), 0), (ssize_t)request.size());
+    char buffer[256];
+    ssize_t received = recv(sock, buffer, sizeof(buffer), 0);
+    ASSERT_GT(received, 0);
+    EXPECT_NE(string(buffer, received).find("404 Not Found"), string::npos);
+    close(sock);
+    EXPECT_EQ(connectTo(testPort(3)), -1); // no TCP
+    unlink(path.c_str());
+}
@@ -2,9 +2,12 @@
 #include "SearchCommand.h"
 #include "IdataBaseHandler.h"
 #include "Icompressor.h"
+#include "ThreadPoolExecutor.h"
 #include <string>
 #include <vector>
 #include <map>
+#include <chrono>
+#include <thread>
 
 using namespace std;
 
@@ -110,4 +113,185 @@ TEST_F(SearchCommandTest, NotFound) {
 TEST_F(SearchCommandTest, InvalidArgs) {
     pair<int, string> result = searchCmd->execute("");
     EXPECT_EQ(result.first, 400);
-}
\ No newline at end of file
+}
+
+TEST_F(SearchCommandTest, FoundAcrossChunkBoundary) {
+    // scan 4 bytes at a time, the match starts in one chunk and ends in the next
+    SearchCommand smallChunks(mockDB, mockCompressor, 4);
+    mockDB->storedFiles["big.txt"] = "xxxabcdefxxx";
+    mockDB->storedFiles["other.txt"] = "abc def";
+
+    pair<int, string> result = smallChunks.execute("abcdef");
+
+    EXPECT_EQ(result.first, 200);
+    EXPECT_EQ(result.second, "big.txt");
+}
+
+// --- Paging and streaming ---
+
+// Mock sink that records every streamed item
+class RecordingSink : public IresultSink {
+public:
+    vector<string> items;
+    size_t acceptUntil = SIZE_MAX; // pretend the client leaves after this many items
+
+    bool write(const string& item) override {
+        items.push_back(item);
+        return items.size() < acceptUntil;
+    }
+};
+
+TEST_F(SearchCommandTest, LimitAndCursor) {
+    mockDB->storedFiles["a.txt"] = "common";
+    mockDB->storedFiles["b.txt"] = "common";
+    mockDB->storedFiles["c.txt"] = "nothing";
+    mockDB->storedFiles["d.txt"] = "common";
+
+    EXPECT_EQ(searchCmd->execute("limit=2 common"), make_pair(200, string("a.txt b.txt")));
+    // resume after the last name of the previous page
+    EXPECT_EQ(searchCmd->execute("limit=2 cursor=b.txt common"), make_pair(200, string("d.txt")));
+    EXPECT_EQ(searchCmd->execute("cursor=d.txt common"), make_pair(200, string("")));
+}
+
+TEST_F(SearchCommandTest, OptionsAreOnlyLeadingWords) {
+    mockDB->storedFiles["a.txt"] = "find limit=2 here";
+
+    // the last word is always the substring, even if it looks like an option
+    EXPECT_EQ(searchCmd->execute("limit=2"), make_pair(200, string("a.txt")));
+    EXPECT_EQ(searchCmd->execute("find limit=2"), make_pair(200, string("a.txt")));
+    EXPECT_FALSE(searchCmd->isStreamed("find limit=2"));
+    EXPECT_TRUE(searchCmd->isStreamed("limit=2 find"));
+    EXPECT_TRUE(searchCmd->isStreamed("cursor=a.txt find"));
+}
+
+TEST_F(SearchCommandTest, BadOptions) {
+    EXPECT_EQ(searchCmd->execute("limit=0 x").first, 400);
+    EXPECT_EQ(searchCmd->execute("limit=abc x").first, 400);
+    EXPECT_EQ(searchCmd->execute("limit=-1 x").first, 400);
+    EXPECT_EQ(searchCmd->execute("limit=5 ").first, 400); // no substring left
+}
+
+TEST_F(SearchCommandTest, StreamedMatchesGoToSink) {
+    mockDB->storedFiles["a.txt"] = "common";
+    mockDB->storedFiles["b.txt"] = "other";
+    mockDB->storedFiles["c.txt"] = "common";
+
+    RecordingSink sink;
+    EXPECT_EQ(searchCmd->executeStreamed("limit=10 common", sink, CancellationToken()), 200);
+    EXPECT_EQ(sink.items, vector<string>({"a.txt", "c.txt"}));
+
+    // the search stops as soon as the sink refuses more items
+    RecordingSink leavingSink;
+    leavingSink.acceptUntil = 1;
+    EXPECT_EQ(searchCmd->executeStreamed("limit=10 common", leavingSink, CancellationToken()), 200);
+    EXPECT_EQ(leavingSink.items.size(), 1);
+}
+
+// --- Time budget and cancellation ---
+
+TEST_F(SearchCommandTest, StopsWhenTokenSaysSo) {
+    mockDB->storedFiles["a.txt"] = "common";
+    mockDB->storedFiles["b.txt"] = "common";
+
+    // an already cancelled token returns partial (here: no) results with 206
+    CancellationToken token;
+    token.cancel();
+    EXPECT_EQ(searchCmd->execute("common", token), make_pair(206, string("")));
+
+    RecordingSink sink;
+    EXPECT_EQ(searchCmd->executeStreamed("limit=5 common", sink, token), 206);
+    EXPECT_TRUE(sink.items.empty());
+
+    // a token that does not stop gives the full result
+    EXPECT_EQ(searchCmd->execute("common", CancellationToken()), make_pair(200, string("a.txt b.txt")));
+}
+
+TEST_F(SearchCommandTest, ExpiresBetweenFiles) {
+    // reading a file takes 20ms, the budget runs out while the second file is read
+    class SlowDataBase : public MockDataBaseHandlerSearch {
+    public:
+        string getContent(const string fileName) override {
+            this_thread::sleep_for(chrono::milliseconds(20));
+            return MockDataBaseHandlerSearch::getContent(fileName);
+        }
+    };
+    SlowDataBase slowDB;
+    slowDB.storedFiles["a.txt"] = "common";
+    slowDB.storedFiles["b.txt"] = "common";
+    SearchCommand slowSearch(&slowDB, mockCompressor);
+
+    CancellationToken token(chrono::milliseconds(30));
+    EXPECT_EQ(slowSearch.execute("common", token), make_pair(206, string("a.txt")));
+}
+
+// --- Scoped search ---
+
+// the scoped search skips names that do not exist, so the mock has to know which do
+class ScopedDataBase : public MockDataBaseHandlerSearch {
+public:
+    bool isExists(const string fileName) override { return storedFiles.count(fileName) > 0; }
+};
+
+TEST(ScopedSearchTest, OnlyContentOfGivenFiles) {
+    ScopedDataBase db;
+    MockCompressorSearch compressor;
+    db.storedFiles["a.txt"] = "needle here";
+    db.storedFiles["b.txt"] = "nothing";
+    db.storedFiles["c.txt"] = "another needle";
+    db.storedFiles["needle.txt"] = "no match in content";
+    ThreadPoolExecutor executor(2);
+    SearchCommand search(&db, &compressor, StreamScanner::DEFAULT_CHUNK_SIZE, &executor);
+
+    // matches in the order of the list, a file is never matched by its name, missing files never match
+    EXPECT_EQ(search.execute("in=5 c.txt b.txt needle.txt missing.txt a.txt needle"),
+              make_pair(200, string("c.txt a.txt")));
+    // the substring may have spaces
+    EXPECT_EQ(search.execute("in=2 a.txt c.txt another needle"), make_pair(200, string("c.txt")));
+    EXPECT_EQ(search.execute("limit=1 in=3 b.txt c.txt a.txt needle"), make_pair(200, string("c.txt")));
+}
+
+TEST(ScopedSearchTest, ManyFilesKeepTheirOrder) {
+    ScopedDataBase db;
+    MockCompressorSearch compressor;
+    string args;
+    string expected;
+    // more than one batch of candidates, listed in reverse name order
+    for (int i = 299; i >= 0; i--) {
+        string name = "f" + to_string(i);
+        db.storedFiles[name] = (i % 3 == 0) ? "xx match xx" : "xx";
+        args += name + " ";
+        if (i % 3 == 0) {
+            expected += (expected.empty() ? "" : " ") + name;
+        }
+    }
+    ThreadPoolExecutor executor(3);
+    SearchCommand search(&db, &compressor, StreamScanner::DEFAULT_CHUNK_SIZE, &executor);
+    EXPECT_EQ(search.execute("in=300 " + args + "match"), make_pair(200, expected));
+}
+
+TEST(ScopedSearchTest, BadScopes) {
+    ScopedDataBase db;
+    MockCompressorSearch compressor;
+    SearchCommand search(&db, &compressor);
+
+    EXPECT_EQ(search.execute("in=2 a.txt b.txt").first, 400);         // no substring after the names
+    EXPECT_EQ(search.execute("in=0 text").first, 400);
+    EXPECT_EQ(search.execute("in=x a.txt text").first, 400);
+    EXPECT_EQ(search.execute("in=1  a.txt text").first, 400);         // empty name
+    EXPECT_EQ(search.execute("in=10001 a.txt text").first, 400);      // more than MAX_SCOPE_SIZE
+    EXPECT_EQ(search.execute("cursor=a in=1 a.txt text").first, 400); // cursor does not work with a scope
+}
+
+TEST(ScopedSearchTest, StreamedWithLimit) {
+    ScopedDataBase db;
+    MockCompressorSearch compressor;
+    db.storedFiles["a.txt"] = "match";
+    db.storedFiles["b.txt"] = "match";
+    SearchCommand search(&db, &compressor);
+
+    string args = "limit=5 in=2 b.txt a.txt match";
+    ASSERT_TRUE(search.isStreamed(args));
+    RecordingSink sink;
+    EXPECT_EQ(search.executeStreamed(args, sink, CancellationToken()), 200);
+    EXPECT_EQ(sink.items, vector<string>({"b.txt", "a.txt"}));
+}
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include "AdmissionController.h"
+#include "StatsCommand.h"
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+TEST(AdmissionControllerTest, NoLimitsAdmitEverything) {
+    AdmissionController admission;
+    for (int i = 0; i < 1000; i++) {
+        EXPECT_TRUE(admission.admitConnection());
+        EXPECT_TRUE(admission.admitRequest(1 << 20, true));
+    }
+    EXPECT_EQ(admission.connectionCount(), 1000u);
+    EXPECT_EQ(admission.queuedRequestCount(), 1000u);
+    EXPECT_EQ(admission.rejectedCount(), 0u);
+}
+
+TEST(AdmissionControllerTest, ConnectionLimit) {
+    AdmissionController admission(2, 0, 0);
+    EXPECT_TRUE(admission.admitConnection());
+    EXPECT_TRUE(admission.admitConnection());
+    EXPECT_FALSE(admission.admitConnection());
+
+    // a connection that ends frees its slot
+    admission.releaseConnection();
+    EXPECT_TRUE(admission.admitConnection());
+    EXPECT_EQ(admission.connectionCount(), 2u);
+    EXPECT_EQ(admission.rejectedCount(), 1u);
+}
+
+TEST(AdmissionControllerTest, QueuedRequestLimit) {
+    AdmissionController admission(0, 1, 0);
+    EXPECT_TRUE(admission.admitRequest(5, true));
+    EXPECT_FALSE(admission.admitRequest(5, true));
+    // a request that runs at once on its connection does not wait in the queue
+    EXPECT_TRUE(admission.admitRequest(5, false));
+
+    admission.startRequest();
+    EXPECT_TRUE(admission.admitRequest(5, true));
+}
+
+TEST(AdmissionControllerTest, InFlightBytesLimit) {
+    AdmissionController admission(0, 1, 100);
+    EXPECT_TRUE(admission.admitRequest(60, false));
+    EXPECT_FALSE(admission.admitRequest(50, false));
+    EXPECT_FALSE(admission.admitRequest(1000, true));
+    // a request refused by the queue gives its bytes back
+    EXPECT_TRUE(admission.admitRequest(10, true));
+    EXPECT_FALSE(admission.admitRequest(10, true));
+    EXPECT_EQ(admission.inFlightByteCount(), 70u);
+
+    admission.finishRequest(60);
+    EXPECT_TRUE(admission.admitRequest(90, false));
+    EXPECT_EQ(admission.inFlightByteCount(), 100u);
+}
+
+// a body admitted before it is received, then its request with the rest of its bytes (none)
+TEST(AdmissionControllerTest, BytesAdmittedBeforeTheRequest) {
+    AdmissionController admission(0, 1, 100);
+    EXPECT_TRUE(admission.admitBytes(80));
+    EXPECT_FALSE(admission.admitBytes(30));
+    EXPECT_TRUE(admission.admitRequest(0, true));
+    EXPECT_EQ(admission.inFlightByteCount(), 80u);
+    EXPECT_EQ(admission.rejectedCount(), 1u);
+
+    admission.finishRequest(80);
+    EXPECT_EQ(admission.inFlightByteCount(), 0u);
+}
+
+// the gauges never pass their limit, however many threads race for them
+TEST(AdmissionControllerTest, LimitHoldsUnderContention) {
+    AdmissionController admission(50, 0, 0);
+    vector<thread> threads;
+    atomic<int> admitted(0);
+    for (int t = 0; t < 8; t++) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < 100; i++) {
+                if (admission.admitConnection()) {
+                    admitted++;
+                }
+            }
+        });
+    }
+    for (thread& t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(admitted, 50);
+    EXPECT_EQ(admission.connectionCount(), 50u);
+    EXPECT_EQ(admission.rejectedCount(), 750u);
+}
+
+TEST(StatsCommandTest, ReportsTheGauges) {
+    AdmissionController admission(1, 0, 0);
+    admission.admitConnection();
+    admission.admitConnection();
+    admission.admitRequest(42, true);
+    StatsCommand stats(&admission);
+
+    pair<int, string> result = stats.execute("");
+    EXPECT_EQ(result.first, 200);
+    EXPECT_EQ(result.second, "connections 1\nqueued_requests 1\nin_flight_bytes 42\nrejected 1\nreaped 0");
+}
@@ -1,12 +1,14 @@
 #include <gtest/gtest.h>
 #include "CSIO.h"
 #include "CommandWrapper.h"
+#include "ProtocolV2.h"
 #include <sys/socket.h>
 #include <unistd.h>
 #include <string>
 #include <vector>
 #include <thread>
 #include <chrono>
+#include <atomic>
 
 using namespace std;
 
@@ -87,6 +89,28 @@ TEST_F(CSIOTest, ReceiveFragmentedCommand) {
     EXPECT_EQ(result[1], "my_file.txt");
 }
 
+TEST_F(CSIOTest, ReceivePipelinedCommands) {
+    // several commands arrive in one segment, the last one only partially
+    WriteToSocket("get a.txt\npost b.txt hello\ndelete c");
+
+    vector<string> first = csio->getCommandAndArgs();
+    vector<string> second = csio->getCommandAndArgs();
+    EXPECT_EQ(first, vector<string>({"get", "a.txt"}));
+    EXPECT_EQ(second, vector<string>({"post", "b.txt hello"}));
+
+    // the leftover "delete c" is kept and completed by the next segment
+    WriteToSocket(".txt\n");
+    vector<string> third = csio->getCommandAndArgs();
+    EXPECT_EQ(third, vector<string>({"delete", "c.txt"}));
+}
+
+TEST_F(CSIOTest, BadCommandDoesNotLoseFollowingOnes) {
+    WriteToSocket("JustCommandWithoutArgs\nget a.txt\n");
+
+    EXPECT_THROW(csio->getCommandAndArgs(), std::exception);
+    EXPECT_EQ(csio->getCommandAndArgs(), vector<string>({"get", "a.txt"}));
+}
+
 TEST_F(CSIOTest, ReceiveInvalidFormat) {
     // CSIO.cpp throws exception if no space separator is found
     string cmd = "JustCommandWithoutArgs\n";
@@ -121,4 +145,237 @@ TEST_F(CSIOTest, SendEmptyOutput) {
     // Should only send the length header "0       "
     string lenHeader = ReadFromSocket(8);
     EXPECT_EQ(lenHeader, "0       ");
-}
\ No newline at end of file
+}
+
+TEST_F(CSIOTest, SendLegacyResponse) {
+    csio->displayResponse(CommandWrapper::STATUS_OK, "hello");
+
+    EXPECT_EQ(ReadFromSocket(8), "14      ");
+    EXPECT_EQ(ReadFromSocket(14), "200 Ok\n\nhello\n");
+}
+
+TEST_F(CSIOTest, SendLegacyResponseLikeFormatOutput) {
+    // the parts are sent as they are, the client must get the same bytes formatOutput builds
+    csio->displayResponse(CommandWrapper::STATUS_NOT_FOUND, "ignored");
+    csio->displayResponse(CommandWrapper::STATUS_OK, "ends with newline\n");
+    csio->displayResponse(CommandWrapper::STATUS_OK, "");
+
+    for (const string& data : {string("ignored"), string("ends with newline\n"), string("")}) {
+        int status = data == "ignored" ? CommandWrapper::STATUS_NOT_FOUND : CommandWrapper::STATUS_OK;
+        string expected = mockWrapper->formatOutput(status, data);
+        EXPECT_EQ(stoi(ReadFromSocket(8)), (int)expected.size());
+        EXPECT_EQ(ReadFromSocket(expected.size()), expected);
+    }
+}
+
+// v2 protocol - a binary request frame (its body has newlines and null bytes)
+static string RequestFrame(uint8_t opcode, uint32_t requestId, const string& body, uint8_t flags = 0) {
+    ProtocolV2::FrameHeader header;
+    header.opcode = opcode;
+    header.flags = flags;
+    header.requestId = requestId;
+    header.bodyLength = body.size();
+    return ProtocolV2::encodeHeader(header) + body;
+}
+
+TEST_F(CSIOTest, ReceiveV2Frames) {
+    string content("line1\nline2\0end", 16);
+    // two frames in one segment, the second one split
+    string frames = RequestFrame(ProtocolV2::OPCODE_POST, 7, "a.bin " + content) + RequestFrame(ProtocolV2::OPCODE_GET, 8, "a.bin");
+    WriteToSocket(frames.substr(0, frames.size() - 3));
+
+    vector<string> first = csio->getCommandAndArgs();
+    EXPECT_EQ(first, vector<string>({"post", "a.bin " + content}));
+
+    thread sender([this, frames]() {
+        this_thread::sleep_for(chrono::milliseconds(20));
+        WriteToSocket(frames.substr(frames.size() - 3));
+    });
+    vector<string> second = csio->getCommandAndArgs();
+    sender.join();
+    EXPECT_EQ(second, vector<string>({"get", "a.bin"}));
+}
+
+TEST_F(CSIOTest, ReceiveLargeV2Body) {
+    // larger than the read buffer, most of it is received straight into the body
+    string body = "big.bin " + string(300000, 'x');
+    string frame = RequestFrame(ProtocolV2::OPCODE_POST, 1, body);
+    thread sender([this, frame]() { WriteToSocket(frame); });
+    vector<string> result = csio->getCommandAndArgs();
+    sender.join();
+    EXPECT_EQ(result[0], "post");
+    EXPECT_EQ(result[1], body);
+}
+
+// a header that claims a huge body is answered with 400 before anything is allocated for it, and the
+// connection ends (the body is not read, so the frames after it can not be found)
+TEST_F(CSIOTest, OversizedV2BodyIsRefused) {
+    ProtocolV2::FrameHeader header;
+    header.opcode = ProtocolV2::OPCODE_POST;
+    header.requestId = 9;
+    header.bodyLength = 1ULL << 30;
+    WriteToSocket(ProtocolV2::encodeHeader(header));
+
+    EXPECT_THROW(csio->getCommandAndArgs(), std::exception);
+    EXPECT_TRUE(csio->isClosed());
+    ProtocolV2::FrameHeader response;
+    ASSERT_TRUE(ProtocolV2::parseHeader(ReadFromSocket(ProtocolV2::HEADER_SIZE), response));
+    EXPECT_EQ(response.status, 400);
+    EXPECT_EQ(response.requestId, 9u);
+    EXPECT_EQ(response.bodyLength, 0u);
+}
+
+TEST_F(CSIOTest, MaxBodyLengthIsConfigurable) {
+    csio->setMaxBodyLength(7);
+    WriteToSocket(RequestFrame(ProtocolV2::OPCODE_GET, 1, "a.txt 1") + RequestFrame(ProtocolV2::OPCODE_GET, 2, "a.txt 12"));
+
+    EXPECT_EQ(csio->getCommandAndArgs(), vector<string>({"get", "a.txt 1"})); // at the limit
+    EXPECT_THROW(csio->getCommandAndArgs(), std::exception);
+    ProtocolV2::FrameHeader response;
+    ASSERT_TRUE(ProtocolV2::parseHeader(ReadFromSocket(ProtocolV2::HEADER_SIZE), response));
+    EXPECT_EQ(response.status, 400);
+    EXPECT_EQ(response.requestId, 2u);
+}
+
+TEST_F(CSIOTest, SendV2Response) {
+    WriteToSocket(RequestFrame(ProtocolV2::OPCODE_SEARCH, 42, "limit=2 abc"));
+    csio->getCommandAndArgs();
+
+    csio->displayPartialResponse("a.txt\n");
+    csio->displayResponse(CommandWrapper::STATUS_OK, "");
+
+    // data frame (MORE flag) then the final frame, both answer request 42
+    ProtocolV2::FrameHeader header;
+    ASSERT_TRUE(ProtocolV2::parseHeader(ReadFromSocket(ProtocolV2::HEADER_SIZE), header));
+    EXPECT_EQ(header.opcode, ProtocolV2::OPCODE_SEARCH);
+    EXPECT_EQ(header.flags, ProtocolV2::FLAG_MORE);
+    EXPECT_EQ(header.requestId, 42u);
+    EXPECT_EQ(ReadFromSocket(header.bodyLength), "a.txt\n");
+
+    ASSERT_TRUE(ProtocolV2::parseHeader(ReadFromSocket(ProtocolV2::HEADER_SIZE), header));
+    EXPECT_EQ(header.flags, 0);
+    EXPECT_EQ(header.status, 200);
+    EXPECT_EQ(header.requestId, 42u);
+    EXPECT_EQ(header.bodyLength, 0u);
+}
+
+TEST_F(CSIOTest, UnknownV2Opcode) {
+    WriteToSocket(RequestFrame(99, 1, "x"));
+    // an empty command name, the app answers it as a bad request
+    EXPECT_EQ(csio->getCommandAndArgs(), vector<string>({"", "x"}));
+}
+
+// a refused client gets the status in its own protocol, legacy if it did not send anything yet
+TEST_F(CSIOTest, RefuseLegacyClient) {
+    csio->refuse(CommandWrapper::STATUS_SERVICE_UNAVAILABLE);
+    EXPECT_EQ(ReadFromSocket(8 + 24), "24      503 Service Unavailable\n");
+    EXPECT_TRUE(csio->isClosed());
+}
+
+TEST_F(CSIOTest, RefuseV2Client) {
+    WriteToSocket(RequestFrame(ProtocolV2::OPCODE_GET, 7, "a.txt"));
+    csio->refuse(CommandWrapper::STATUS_SERVICE_UNAVAILABLE);
+
+    ProtocolV2::FrameHeader header;
+    ASSERT_TRUE(ProtocolV2::parseHeader(ReadFromSocket(ProtocolV2::HEADER_SIZE), header));
+    EXPECT_EQ(header.status, 503);
+    EXPECT_EQ(header.requestId, 7u);
+    EXPECT_EQ(header.bodyLength, 0u);
+}
+
+// 3. Connection state
+TEST_F(CSIOTest, DetectsClosedClient) {
+    EXPECT_FALSE(csio->isClosed());
+
+    // data waiting to be read does not mean closed
+    WriteToSocket("get a\n");
+    EXPECT_FALSE(csio->isClosed());
+
+    close(socks[1]);
+    socks[1] = -1;
+    EXPECT_TRUE(csio->isClosed());
+    // sending to a closed client fails without killing the process (no SIGPIPE)
+    EXPECT_THROW(csio->displayOutput("200 Ok\n"), std::exception);
+}
+
+// a client that is done sending (shutdown(SHUT_WR)) still reads the answers
+TEST_F(CSIOTest, HalfClosedClientIsNotClosed) {
+    WriteToSocket("get a\n");
+    ASSERT_EQ(shutdown(socks[1], SHUT_WR), 0);
+    EXPECT_FALSE(csio->isClosed());
+
+    csio->displayOutput("200 Ok\n");
+    EXPECT_EQ(ReadFromSocket(8 + 7), CSIO::legacyLength(7) + "200 Ok\n");
+}
+
+// 4. Timeouts
+static ConnectionTimeouts Timeouts(int idle, int read, int write) {
+    ConnectionTimeouts timeouts;
+    timeouts.idle = chrono::milliseconds(idle);
+    timeouts.read = chrono::milliseconds(read);
+    timeouts.write = chrono::milliseconds(write);
+    return timeouts;
+}
+
+TEST_F(CSIOTest, IdleClientIsReaped) {
+    csio->setTimeouts(Timeouts(50, 0, 0));
+    EXPECT_THROW(csio->getCommandAndArgs(), std::exception);
+    EXPECT_TRUE(csio->wasReaped());
+    EXPECT_TRUE(csio->isClosed());
+    // the client sees the connection closed
+    char byte;
+    EXPECT_EQ(read(socks[1], &byte, 1), 0);
+}
+
+TEST_F(CSIOTest, ActiveClientIsNotReaped) {
+    csio->setTimeouts(Timeouts(200, 200, 0));
+    thread sender([this]() {
+        this_thread::sleep_for(chrono::milliseconds(20));
+        WriteToSocket("get a.txt\n");
+    });
+    EXPECT_EQ(csio->getCommandAndArgs(), vector<string>({"get", "a.txt"}));
+    sender.join();
+    EXPECT_FALSE(csio->wasReaped());
+}
+
+// a request that stalls half way is reaped by the read timeout, even if its bytes trickle in
+TEST_F(CSIOTest, StalledRequestIsReaped) {
+    csio->setTimeouts(Timeouts(0, 100, 0));
+    thread sender([this]() {
+        // stops when the connection is closed (no SIGPIPE)
+        for (int i = 0; i < 10 && send(socks[1], "x", 1, MSG_NOSIGNAL) == 1; i++) {
+            this_thread::sleep_for(chrono::milliseconds(30));
+        }
+    });
+    auto start = chrono::steady_clock::now();
+    EXPECT_THROW(csio->getCommandAndArgs(), std::exception);
+    EXPECT_LT(chrono::steady_clock::now() - start, chrono::milliseconds(250));
+    EXPECT_TRUE(csio->wasReaped());
+    sender.join();
+}
+
+// the client waits for the answer of its concurrent request, it is not idle until it gets it
+TEST_F(CSIOTest, RunningRequestKeepsTheConnection) {
+    csio->setTimeouts(Timeouts(30, 0, 0));
+    WriteToSocket(RequestFrame(ProtocolV2::OPCODE_GET, 1, "a.txt", ProtocolV2::FLAG_CONCURRENT));
+    csio->getCommandAndArgs();
+    RequestContext request = csio->lastRequest();
+
+    atomic<bool> reaped(false);
+    thread reader([this, &reaped]() {
+        EXPECT_THROW(csio->getCommandAndArgs(), std::exception);
+        reaped = true;
+    });
+    this_thread::sleep_for(chrono::milliseconds(100));
+    EXPECT_FALSE(reaped);
+    csio->displayResponseFor(request, 200, "a");
+    reader.join(); // idle from the answer on
+    EXPECT_TRUE(csio->wasReaped());
+}
+
+TEST_F(CSIOTest, ClientThatDoesNotReadIsReaped) {
+    csio->setTimeouts(Timeouts(0, 0, 50));
+    // far more than the socket buffers hold
+    EXPECT_THROW(csio->displayResponse(200, string(64 << 20, 'x')), std::exception);
+    EXPECT_TRUE(csio->wasReaped());
+}
@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+#include "CancellationToken.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace std;
+
+// --- Test Cases ---
+
+TEST(CancellationTokenTest, DefaultNeverStops) {
+    CancellationToken token;
+    EXPECT_FALSE(token.shouldStop());
+    EXPECT_FALSE(token.isExpired());
+
+    token.cancel();
+    EXPECT_TRUE(token.isCancelled());
+    EXPECT_TRUE(token.shouldStop());
+}
+
+TEST(CancellationTokenTest, ExpiresAfterBudget) {
+    CancellationToken token(chrono::milliseconds(20));
+    EXPECT_FALSE(token.shouldStop());
+    this_thread::sleep_for(chrono::milliseconds(30));
+    EXPECT_TRUE(token.isExpired());
+    EXPECT_FALSE(token.isCancelled()); // expired is not cancelled - partial results are still wanted
+    EXPECT_TRUE(token.shouldStop());
+
+    // zero budget means no limit
+    CancellationToken unlimited(chrono::milliseconds(0));
+    EXPECT_FALSE(unlimited.isExpired());
+}
+
+TEST(CancellationTokenTest, PeerProbeIsRateLimited) {
+    atomic<int> probes{0};
+    atomic<bool> peerGone{false};
+    CancellationToken token(chrono::milliseconds(0), [&]() {
+        probes++;
+        return peerGone.load();
+    });
+
+    // many checks in a row probe only once
+    for (int i = 0; i < 1000; i++) {
+        EXPECT_FALSE(token.shouldStop());
+    }
+    EXPECT_EQ(probes, 1);
+
+    // once the peer is gone the token stays cancelled
+    peerGone = true;
+    this_thread::sleep_for(chrono::milliseconds(15));
+    EXPECT_TRUE(token.isCancelled());
+    peerGone = false;
+    EXPECT_TRUE(token.isCancelled());
+}
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include "ConnectionContextPool.h"
+#include "CommandRegistry.h"
+#include "ProtocolV2.h"
+#include <sys/socket.h>
+#include <unistd.h>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+// Mock database with one file
+class MockDataBaseHandlerContexts : public IdataBaseHandler {
+public:
+    bool isExists(const string fileName) override { return fileName == "a.txt"; }
+    bool insertFile(const string fileName, const string content, const filesystem::path filePath) override {
+        return false;
+    }
+    vector<string> getAllFileNames() override { return {"a.txt"}; }
+    string getContent(const string fileName) override { return "4/a"; }
+    bool deleteFile(const string fileName) override { return false; }
+};
+
+TEST(CommandRegistryTest, FindsTheCommandsByName) {
+    MockDataBaseHandlerContexts database;
+    CommandRegistry registry(&database);
+    EXPECT_NE(registry.findCommand("get"), nullptr);
+    EXPECT_NE(registry.findCommand("mget"), nullptr);
+    EXPECT_EQ(registry.findCommand("nope"), nullptr);
+    EXPECT_EQ(registry.findCommand("stats"), nullptr); // no admission controller, no stats
+    EXPECT_NE(registry.findCompressor("RLE"), nullptr);
+    EXPECT_EQ(registry.allCommands().count("get"), 1u);
+
+    AdmissionController admission(0, 0, 0);
+    CommandRegistry withStats(&database, nullptr, &admission);
+    EXPECT_NE(withStats.findCommand("stats"), nullptr);
+}
+
+// the contexts of a pool with no request executor, the client end of each connection is kept by the test
+class ConnectionContextPoolTest : public ::testing::Test {
+protected:
+    MockDataBaseHandlerContexts database;
+    CommandRegistry registry{&database};
+    CommandWrapper wrapper;
+    ConnectionContextPool pool{&registry, &wrapper, chrono::milliseconds(0), nullptr, nullptr, 2};
+
+    // a new connection, its server end in a context of the pool
+    ConnectionContextPool::Context Connect(int& client) {
+        int socks[2];
+        EXPECT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, socks), 0);
+        client = socks[1];
+        return pool.acquire(socks[0]);
+    }
+
+    static string ReadBytes(int client, size_t bytes) {
+        string data(bytes, '\0');
+        size_t totalRead = 0;
+        while (totalRead < bytes) {
+            ssize_t r = read(client, &data[totalRead], bytes - totalRead);
+            if (r <= 0) break;
+            totalRead += r;
+        }
+        return data.substr(0, totalRead);
+    }
+
+    static void Send(int client, const string& bytes) {
+        ASSERT_EQ(write(client, bytes.data(), bytes.size()), (ssize_t)bytes.size());
+    }
+};
+
+// a connection after the first one gets the context of the first one, reset for the new socket
+TEST_F(ConnectionContextPoolTest, ReusesTheContextOfAnEndedConnection) {
+    int client;
+    ConnectionContextPool::Context first = Connect(client);
+    ConnectionContext* firstContext = first.get();
+    thread served([&first]() { first->app.run(); });
+    Send(client, "get a.txt\n");
+    string expected = "200 Ok\n\naaaa\n";
+    EXPECT_EQ(ReadBytes(client, 8 + expected.size()), CSIO::legacyLength(expected.size()) + expected);
+    shutdown(client, SHUT_WR); // the client leaves
+    served.join();
+    first.reset(); // back in the pool, its socket is closed
+    EXPECT_EQ(ReadBytes(client, 1), "");
+    close(client);
+    EXPECT_EQ(pool.idleCount(), 1u);
+
+    // the next client speaks v2, the protocol of the first one is forgotten
+    ConnectionContextPool::Context second = Connect(client);
+    EXPECT_EQ(second.get(), firstContext);
+    EXPECT_EQ(pool.createdCount(), 1u);
+    thread servedAgain([&second]() { second->app.run(); });
+    ProtocolV2::FrameHeader header;
+    header.opcode = ProtocolV2::OPCODE_GET;
+    header.requestId = 7;
+    header.bodyLength = 5;
+    Send(client, ProtocolV2::encodeHeader(header) + "a.txt");
+    ProtocolV2::FrameHeader response;
+    ASSERT_TRUE(ProtocolV2::parseHeader(ReadBytes(client, ProtocolV2::HEADER_SIZE), response));
+    EXPECT_EQ(response.requestId, 7u);
+    EXPECT_EQ(ReadBytes(client, response.bodyLength), "aaaa");
+    shutdown(client, SHUT_WR);
+    servedAgain.join();
+    second.reset();
+    close(client);
+}
+
+// beyond maxIdle the contexts are freed when their connections end
+TEST_F(ConnectionContextPoolTest, KeepsAtMostMaxIdleContexts) {
+    int clients[3];
+    {
+        ConnectionContextPool::Context a = Connect(clients[0]);
+        ConnectionContextPool::Context b = Connect(clients[1]);
+        ConnectionContextPool::Context c = Connect(clients[2]);
+        EXPECT_EQ(pool.createdCount(), 3u);
+        EXPECT_EQ(pool.idleCount(), 0u);
+    }
+    EXPECT_EQ(pool.idleCount(), 2u);
+    for (int client : clients) {
+        EXPECT_EQ(ReadBytes(client, 1), ""); // every connection is closed, kept or not
+        close(client);
+    }
+}
@@ -0,0 +1,349 @@
+#include <gtest/gtest.h>
+#include "AsyncTask.h"
+#include "CoroutineScheduler.h"
+#include "AsyncStorage.h"
+#include "IoReactor.h"
+#include "AsyncSocket.h"
+#include "AsyncCSIO.h"
+#include "CSIO.h"
+#include "App.h"
+#include "GetCommand.h"
+#include "RLEcompressor.h"
+#include "ProtocolV2.h"
+#include "ThreadPoolExecutor.h"
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Mock database, remembers the threads that called it
+class MockDataBaseHandlerCoroutines : public IdataBaseHandler {
+public:
+    map<string, string> storedFiles; // RLE compressed content
+    mutex lock;
+    thread::id lastCaller;
+
+    bool isExists(const string fileName) override {
+        lock_guard<mutex> guard(lock);
+        lastCaller = this_thread::get_id();
+        return storedFiles.count(fileName) > 0;
+    }
+    bool insertFile(const string fileName, const string content, const filesystem::path filePath) override {
+        lock_guard<mutex> guard(lock);
+        storedFiles[fileName] = content;
+        return true;
+    }
+    vector<string> getAllFileNames() override {
+        lock_guard<mutex> guard(lock);
+        vector<string> names;
+        for (const auto& file : storedFiles) {
+            names.push_back(file.first);
+        }
+        return names;
+    }
+    string getContent(const string fileName) override {
+        lock_guard<mutex> guard(lock);
+        lastCaller = this_thread::get_id();
+        if (fileName == "broken.txt") {
+            throw runtime_error("disk error");
+        }
+        return storedFiles[fileName];
+    }
+    bool deleteFile(const string fileName) override {
+        lock_guard<mutex> guard(lock);
+        return storedFiles.erase(fileName) > 0;
+    }
+};
+
+static AsyncTask<int> twice(int value) {
+    co_return value * 2;
+}
+
+static AsyncTask<int> twiceAndOne(int value) {
+    int doubled = co_await twice(value);
+    co_return doubled + 1;
+}
+
+static AsyncTask<void> failing() {
+    throw runtime_error("failed");
+    co_return;
+}
+
+static AsyncTask<string> catching() {
+    try {
+        co_await failing();
+    } catch (const runtime_error& e) {
+        co_return string(e.what());
+    }
+    co_return string("not thrown");
+}
+
+TEST(AsyncTaskTest, ReturnsThroughNestedAwaits) {
+    EXPECT_EQ(twiceAndOne(20).get(), 41);
+}
+
+TEST(AsyncTaskTest, ExceptionsReachTheAwaiter) {
+    EXPECT_EQ(catching().get(), "failed");
+    EXPECT_THROW(failing().get(), runtime_error);
+}
+
+TEST(AsyncTaskTest, ACoroutineNeverAwaitedIsDestroyed) {
+    shared_ptr<int> state = make_shared<int>(1);
+    {
+        AsyncTask<int> task = [](shared_ptr<int> held) -> AsyncTask<int> { co_return *held; }(state);
+        EXPECT_EQ(state.use_count(), 2); // held by the suspended coroutine
+    }
+    EXPECT_EQ(state.use_count(), 1);
+}
+
+static AsyncTask<thread::id> threadAfterSchedule(CoroutineScheduler scheduler) {
+    co_await scheduler.schedule();
+    co_return this_thread::get_id();
+}
+
+TEST(CoroutineSchedulerTest, GoesOnInATaskOfTheExecutor) {
+    ThreadPoolExecutor executor(1);
+    CoroutineScheduler scheduler(&executor);
+    thread::id worker = executor.submit([]() { return this_thread::get_id(); }).get();
+    EXPECT_EQ(threadAfterSchedule(scheduler).get(), worker);
+
+    promise<thread::id> spawned;
+    scheduler.spawn([](promise<thread::id>& result) -> AsyncTask<void> {
+        result.set_value(this_thread::get_id());
+        co_return;
+    }(spawned));
+    EXPECT_EQ(spawned.get_future().get(), worker);
+}
+
+// two ends of a connection, the server end owned by an AsyncSocket
+class IoReactorTest : public ::testing::Test {
+protected:
+    int socks[2];
+    ThreadPoolExecutor executor{2};
+    unique_ptr<IoReactor> reactor;
+    unique_ptr<AsyncSocket> socket;
+
+    void SetUp() override {
+        ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, socks), 0);
+        reactor.reset(new IoReactor(&executor));
+        socket.reset(new AsyncSocket(socks[0], reactor.get()));
+    }
+
+    void TearDown() override {
+        socket.reset();
+        close(socks[1]);
+    }
+};
+
+static AsyncTask<string> readSome(AsyncSocket& socket) {
+    char buffer[64];
+    size_t received = co_await socket.read(buffer, sizeof(buffer));
+    co_return string(buffer, received);
+}
+
+TEST_F(IoReactorTest, ReadSuspendsUntilDataCame) {
+    future<string> received = async(launch::async, [this]() { return readSome(*socket).get(); });
+    EXPECT_EQ(received.wait_for(chrono::milliseconds(50)), future_status::timeout);
+    ASSERT_EQ(write(socks[1], "hello", 5), 5);
+    EXPECT_EQ(received.get(), "hello");
+
+    close(socks[1]);
+    socks[1] = -1;
+    EXPECT_EQ(readSome(*socket).get(), ""); // the peer is gone
+}
+
+TEST_F(IoReactorTest, WriteSuspendsWhileTheSocketIsFull) {
+    string data(4 * 1024 * 1024, 'x'); // far more than the socket buffer
+    data.back() = 'y';
+    future<void> sent = async(launch::async, [this, &data]() { socket->write(data).get(); });
+    EXPECT_EQ(sent.wait_for(chrono::milliseconds(50)), future_status::timeout);
+
+    string received;
+    char buffer[65536];
+    while (received.size() < data.size()) {
+        ssize_t r = read(socks[1], buffer, sizeof(buffer));
+        ASSERT_GT(r, 0);
+        received.append(buffer, r);
+    }
+    sent.get();
+    EXPECT_EQ(received, data);
+}
+
+// GetCommand awaits the storage: the database is called on the blocking executor, the rest runs on the requests one
+TEST(AsyncStorageTest, CommandsAwaitTheDatabaseOnTheBlockingExecutor) {
+    MockDataBaseHandlerCoroutines database;
+    database.storedFiles["a.txt"] = "4/a";
+    ThreadPoolExecutor blocking(1);
+    ThreadPoolExecutor requests(1);
+    AsyncStorage storage(&database, &blocking, &requests);
+    RLEcompressor compressor;
+    GetCommand get(&database, &compressor);
+    thread::id blockingThread = blocking.submit([]() { return this_thread::get_id(); }).get();
+    thread::id requestThread = requests.submit([]() { return this_thread::get_id(); }).get();
+
+    string args = "a.txt";
+    auto getAndWhere = [](const GetCommand& command, const string& args, AsyncStorage& storage)
+        -> AsyncTask<pair<pair<int, string>, thread::id>> {
+        pair<int, string> result = co_await command.executeAsync(args, storage);
+        co_return make_pair(result, this_thread::get_id());
+    };
+    auto result = getAndWhere(get, args, storage).get();
+    EXPECT_EQ(result.first, make_pair(200, string("aaaa")));
+    EXPECT_EQ(result.second, requestThread);
+    EXPECT_EQ(database.lastCaller, blockingThread);
+
+    string missing = "missing.txt";
+    EXPECT_EQ(get.executeAsync(missing, storage).get().first, 404);
+    string broken = "broken.txt";
+    database.storedFiles[broken] = "";
+    EXPECT_EQ(get.executeAsync(broken, storage).get().first, 500);
+}
+
+// connections served by App::runAsync through socket pairs, like the server does with CONNECTION_MODEL=coroutines
+class AppAsyncTest : public ::testing::Test {
+protected:
+    struct Connection {
+        int client;
+        unique_ptr<CommandWrapper> wrapper;
+        unique_ptr<AsyncCSIO> io;
+        unique_ptr<App> app;
+    };
+
+    MockDataBaseHandlerCoroutines database;
+    ThreadPoolExecutor requests{2};
+    ThreadPoolExecutor blocking{2};
+    IoReactor reactor{&requests};
+    AsyncStorage storage{&database, &blocking, &requests};
+    vector<unique_ptr<Connection>> connections;
+    atomic<size_t> finished{0};
+
+    // a new connection, its app runs until the client leaves
+    Connection& Connect() {
+        int socks[2];
+        EXPECT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, socks), 0);
+        unique_ptr<Connection> connection(new Connection());
+        connection->client = socks[1];
+        connection->wrapper.reset(new CommandWrapper());
+        connection->io.reset(new AsyncCSIO(socks[0], &reactor, connection->wrapper.get()));
+        connection->app.reset(new App(&database, nullptr, nullptr, chrono::milliseconds(0), &requests));
+        CoroutineScheduler(&requests).spawn(serve(*connection, storage, finished));
+        connections.push_back(move(connection));
+        return *connections.back();
+    }
+
+    static AsyncTask<void> serve(Connection& connection, AsyncStorage& storage, atomic<size_t>& finished) {
+        co_await connection.app->runAsync(*connection.io, storage);
+        finished++;
+    }
+
+    void TearDown() override {
+        for (unique_ptr<Connection>& connection : connections) {
+            shutdown(connection->client, SHUT_RDWR);
+        }
+        while (finished < connections.size()) {
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+        for (unique_ptr<Connection>& connection : connections) {
+            close(connection->client);
+        }
+        connections.clear();
+        reactor.stop();
+    }
+
+    static void Send(int client, const string& bytes) {
+        ASSERT_EQ(write(client, bytes.data(), bytes.size()), (ssize_t)bytes.size());
+    }
+
+    static string Request(uint8_t opcode, uint32_t requestId, const string& body) {
+        ProtocolV2::FrameHeader header;
+        header.opcode = opcode;
+        header.requestId = requestId;
+        header.bodyLength = body.size();
+        return ProtocolV2::encodeHeader(header) + body;
+    }
+
+    static string ReadBytes(int client, size_t bytes) {
+        string data(bytes, '\0');
+        size_t totalRead = 0;
+        while (totalRead < bytes) {
+            ssize_t r = read(client, &data[totalRead], bytes - totalRead);
+            if (r <= 0) break;
+            totalRead += r;
+        }
+        return data.substr(0, totalRead);
+    }
+
+    // reads a response frame, returns its header and body
+    static pair<ProtocolV2::FrameHeader, string> ReadResponse(int client) {
+        ProtocolV2::FrameHeader header;
+        EXPECT_TRUE(ProtocolV2::parseHeader(ReadBytes(client, ProtocolV2::HEADER_SIZE), header));
+        return {header, ReadBytes(client, header.bodyLength)};
+    }
+};
+
+TEST_F(AppAsyncTest, AnswersV2Requests) {
+    int client = Connect().client;
+    Send(client, Request(ProtocolV2::OPCODE_POST, 1, "a.txt hello") + Request(ProtocolV2::OPCODE_GET, 2, "a.txt") +
+                 Request(ProtocolV2::OPCODE_GET, 3, "missing.txt"));
+
+    pair<ProtocolV2::FrameHeader, string> posted = ReadResponse(client);
+    EXPECT_EQ(posted.first.requestId, 1u);
+    EXPECT_EQ(posted.first.status, 201);
+    pair<ProtocolV2::FrameHeader, string> got = ReadResponse(client);
+    EXPECT_EQ(got.first.requestId, 2u);
+    EXPECT_EQ(got.first.status, 200);
+    EXPECT_EQ(got.second, "hello");
+    EXPECT_EQ(ReadResponse(client).first.status, 404);
+}
+
+// a header that claims more than the largest body is answered with 400, then the connection ends
+TEST_F(AppAsyncTest, OversizedV2BodyIsRefused) {
+    Connection& connection = Connect();
+    connection.io->setMaxBodyLength(4);
+    Send(connection.client, Request(ProtocolV2::OPCODE_POST, 5, "a.txt hello"));
+
+    pair<ProtocolV2::FrameHeader, string> refused = ReadResponse(connection.client);
+    EXPECT_EQ(refused.first.requestId, 5u);
+    EXPECT_EQ(refused.first.status, 400);
+    for (int waited = 0; finished == 0 && waited < 1000; waited++) {
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    EXPECT_EQ(finished, 1u); // the app ended without the client leaving
+}
+
+TEST_F(AppAsyncTest, AnswersLegacyRequests) {
+    database.storedFiles["a.txt"] = "4/a";
+    int client = Connect().client;
+    Send(client, "get a.txt\nbogus\n");
+
+    string expected = "200 Ok\n\naaaa\n";
+    EXPECT_EQ(ReadBytes(client, 8 + expected.size()), CSIO::legacyLength(expected.size()) + expected);
+    string badRequest = "400 Bad Request\n";
+    EXPECT_EQ(ReadBytes(client, 8 + badRequest.size()), CSIO::legacyLength(badRequest.size()) + badRequest);
+}
+
+// every connection has a request in flight at once, two threads serve them all
+TEST_F(AppAsyncTest, ThousandConnectionsShareTwoThreads) {
+    database.storedFiles["a.txt"] = "4/a";
+    const size_t count = 1000;
+    for (size_t i = 0; i < count; i++) {
+        Connect();
+    }
+    for (size_t i = 0; i < count; i++) {
+        Send(connections[i]->client, Request(ProtocolV2::OPCODE_GET, static_cast<uint32_t>(i), "a.txt"));
+    }
+    for (size_t i = 0; i < count; i++) {
+        pair<ProtocolV2::FrameHeader, string> response = ReadResponse(connections[i]->client);
+        ASSERT_EQ(response.first.requestId, i);
+        ASSERT_EQ(response.second, "aaaa");
+    }
+    EXPECT_EQ(finished, 0u); // all the connections are still open, suspended on their sockets
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include "ElasticExecutor.h"
+#include "AdmissionController.h"
+#include "StatsCommand.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// a task that blocks until it is released, like a connection that holds its thread
+class BlockingTask : public IRunnable {
+public:
+    mutex* lock = nullptr;
+    condition_variable* released = nullptr;
+    bool* open = nullptr;
+    atomic<int>* started = nullptr;
+    atomic<int> finished{0};
+
+    void run() override {
+        (*started)++;
+        unique_lock<mutex> guard(*lock);
+        released->wait(guard, [this]() { return *open; });
+        finished++;
+    }
+};
+
+// waits until the condition is true or a second passed
+template <typename Condition>
+static bool eventually(Condition condition) {
+    auto deadline = chrono::steady_clock::now() + chrono::seconds(1);
+    while (!condition()) {
+        if (chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    return true;
+}
+
+class ElasticThreadPoolTest : public ::testing::Test {
+protected:
+    mutex lock;
+    condition_variable released;
+    bool open = false;
+    atomic<int> started{0};
+    vector<BlockingTask> tasks;
+
+    void SetUp() override {
+        tasks = vector<BlockingTask>(8);
+        for (BlockingTask& task : tasks) {
+            task.lock = &lock;
+            task.released = &released;
+            task.open = &open;
+            task.started = &started;
+        }
+    }
+
+    void release() {
+        lock_guard<mutex> guard(lock);
+        open = true;
+        released.notify_all();
+    }
+};
+
+TEST_F(ElasticThreadPoolTest, StartsWithTheMinimum) {
+    ElasticExecutor executor(2, 8);
+    EXPECT_TRUE(eventually([&executor]() { return executor.stats().idleThreads == 2; }));
+    PoolStats stats = executor.stats();
+    EXPECT_EQ(stats.threads, 2u);
+    EXPECT_EQ(stats.grown, 0u);
+}
+
+TEST_F(ElasticThreadPoolTest, GrowsWhenTasksWait) {
+    ElasticExecutor executor(1, 4, chrono::milliseconds(5));
+    for (int i = 0; i < 4; i++) {
+        executor.execute(tasks[i]);
+    }
+    // one worker blocks on the first task, the others are late and get workers of their own
+    EXPECT_TRUE(eventually([this]() { return started.load() == 4; }));
+    PoolStats stats = executor.stats();
+    EXPECT_EQ(stats.threads, 4u);
+    EXPECT_EQ(stats.grown, 3u);
+    EXPECT_GE(stats.maxQueueWait, chrono::milliseconds(5));
+    release();
+}
+
+TEST_F(ElasticThreadPoolTest, NeverGrowsBeyondTheMaximum) {
+    ElasticExecutor executor(1, 3, chrono::milliseconds(1));
+    for (int i = 0; i < 6; i++) {
+        executor.execute(tasks[i]);
+    }
+    EXPECT_TRUE(eventually([this]() { return started.load() == 3; }));
+    this_thread::sleep_for(chrono::milliseconds(30));
+    EXPECT_EQ(started.load(), 3);
+    PoolStats stats = executor.stats();
+    EXPECT_EQ(stats.threads, 3u);
+    EXPECT_EQ(stats.queuedTasks, 3u);
+
+    release(); // the queued tasks run on the same workers
+    EXPECT_TRUE(eventually([this]() { return started.load() == 6; }));
+}
+
+TEST_F(ElasticThreadPoolTest, ShrinksIdleWorkersToTheMinimum) {
+    ElasticExecutor executor(1, 4, chrono::milliseconds(1), chrono::milliseconds(50));
+    for (int i = 0; i < 4; i++) {
+        executor.execute(tasks[i]);
+    }
+    EXPECT_TRUE(eventually([this]() { return started.load() == 4; }));
+    release();
+
+    EXPECT_TRUE(eventually([&executor]() { return executor.stats().threads == 1; }));
+    EXPECT_EQ(executor.stats().shrunk, 3u);
+
+    // the pool still works, and grows again
+    executor.execute(tasks[4]);
+    EXPECT_TRUE(eventually([this]() { return tasks[4].finished.load() == 1; }));
+}
+
+TEST_F(ElasticThreadPoolTest, FixedSizeWhenMinimumIsMaximum) {
+    ElasticExecutor executor(2, 2, chrono::milliseconds(1));
+    for (int i = 0; i < 4; i++) {
+        executor.execute(tasks[i]);
+    }
+    EXPECT_TRUE(eventually([this]() { return started.load() == 2; }));
+    this_thread::sleep_for(chrono::milliseconds(20));
+    EXPECT_EQ(executor.stats().threads, 2u);
+    release();
+    EXPECT_TRUE(eventually([this]() { return started.load() == 4; }));
+}
+
+TEST_F(ElasticThreadPoolTest, StatsReportTheConnectionPool) {
+    ElasticExecutor executor(2, 2);
+    AdmissionController admission;
+    admission.watchConnectionPool(&executor);
+    EXPECT_TRUE(eventually([&executor]() { return executor.stats().idleThreads == 2; }));
+    StatsCommand stats(&admission);
+
+    pair<int, string> result = stats.execute("");
+    EXPECT_EQ(result.first, 200);
+    EXPECT_NE(result.second.find("\npool_threads 2\npool_idle_threads 2\npool_queued 0\n"), string::npos);
+    EXPECT_NE(result.second.find("\npool_shrunk 0"), string::npos);
+}
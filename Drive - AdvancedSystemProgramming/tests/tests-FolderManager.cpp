@@ -73,4 +73,36 @@ TEST_F(FolderManagerTest, GetAllFileNames) {
 TEST_F(FolderManagerTest, GetNonExistentContent) {
     // getContent throws exception if file doesn't exist
     EXPECT_THROW(folderManager->getContent("ghost.txt"), std::exception);
-}
\ No newline at end of file
+}
+
+// Streaming content
+TEST_F(FolderManagerTest, OpenContentStream) {
+    string fileName = "stream.txt";
+    string content = "3/A2/B";
+    ASSERT_TRUE(folderManager->insertFile(fileName, content, testStoragePath));
+
+    unique_ptr<istream> stream = folderManager->openContentStream(fileName);
+    string read((istreambuf_iterator<char>(*stream)), istreambuf_iterator<char>());
+    EXPECT_EQ(read, content);
+
+    // a missing file throws like getContent
+    EXPECT_THROW(folderManager->openContentStream("missing.txt"), std::exception);
+}
+
+// Prefix listing with paging
+TEST_F(FolderManagerTest, GetFileNamesByPrefix) {
+    for (const char* name : {"a.txt", "docs_1", "docs_2", "docs_3", "docz", "e.txt"}) {
+        folderManager->insertFile(name, "content", testStoragePath);
+    }
+
+    EXPECT_EQ(folderManager->getFileNames("docs_", "", 10), vector<string>({"docs_1", "docs_2", "docs_3"}));
+    // paging: start after the last name of the previous page
+    EXPECT_EQ(folderManager->getFileNames("docs_", "", 2), vector<string>({"docs_1", "docs_2"}));
+    EXPECT_EQ(folderManager->getFileNames("docs_", "docs_2", 2), vector<string>({"docs_3"}));
+    EXPECT_EQ(folderManager->getFileNames("docs_", "docs_3", 2), vector<string>());
+    // a cursor before the prefix range starts at the range
+    EXPECT_EQ(folderManager->getFileNames("docs_", "a.txt", 1), vector<string>({"docs_1"}));
+    // empty prefix pages over everything
+    EXPECT_EQ(folderManager->getFileNames("", "docz", 10), vector<string>({"e.txt"}));
+    EXPECT_EQ(folderManager->getFileNames("x", "", 10), vector<string>());
+}
@@ -0,0 +1,212 @@
+#include <gtest/gtest.h>
+#include "IoUring.h"
+#include "UringStorage.h"
+#include "FolderManager.h"
+#include "CoroutineScheduler.h"
+#include "DeleteCommand.h"
+#include "ThreadPoolExecutor.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// the kernel of the test machine may have no io_uring (or forbid it), then these tests are skipped
+static unique_ptr<IoUring> createRing(IExecutor* executor) {
+    try {
+        return make_unique<IoUring>(executor);
+    } catch (const exception&) {
+        return nullptr;
+    }
+}
+
+class IoUringTest : public ::testing::Test {
+protected:
+    ThreadPoolExecutor executor{1};
+    unique_ptr<IoUring> ring;
+    fs::path folder;
+
+    void SetUp() override {
+        ring = createRing(&executor);
+        if (!ring) {
+            GTEST_SKIP() << "io_uring is not available";
+        }
+        folder = fs::temp_directory_path() / ("test_uring_" + to_string(getpid()));
+        fs::remove_all(folder);
+        fs::create_directories(folder);
+    }
+
+    void TearDown() override {
+        ring.reset();
+        fs::remove_all(folder);
+    }
+};
+
+static AsyncTask<string> writeAndReadBack(IoUring& ring, string path, string data) {
+    int file = co_await ring.openAt(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (file < 0) {
+        co_return "open failed";
+    }
+    int written = co_await ring.write(file, data.data(), data.size(), 0);
+    int synced = co_await ring.fsync(file);
+    string back(data.size(), '\0');
+    int received = co_await ring.read(file, &back[0], back.size(), 0);
+    int closed = co_await ring.close(file);
+    if (written != (int)data.size() || synced != 0 || received != (int)data.size() || closed != 0) {
+        co_return "failed";
+    }
+    co_return back;
+}
+
+TEST_F(IoUringTest, WritesAndReadsAFile) {
+    string path = (folder / "a.bin").string();
+    EXPECT_EQ(writeAndReadBack(*ring, path, "hello uring").get(), "hello uring");
+
+    ifstream in(path, ios::binary);
+    stringstream onDisk;
+    onDisk << in.rdbuf();
+    EXPECT_EQ(onDisk.str(), "hello uring");
+}
+
+TEST_F(IoUringTest, ResultsAreNegativeErrnos) {
+    string missing = (folder / "missing").string();
+    auto open = [](IoUring& ring, const string& path) -> AsyncTask<int> {
+        co_return co_await ring.openAt(path.c_str(), O_RDONLY, 0);
+    };
+    auto unlink = [](IoUring& ring, const string& path) -> AsyncTask<int> {
+        co_return co_await ring.unlink(path.c_str());
+    };
+    EXPECT_EQ(open(*ring, missing).get(), -ENOENT);
+    EXPECT_EQ(unlink(*ring, missing).get(), -ENOENT);
+
+    ofstream(folder / "present") << "x";
+    EXPECT_EQ(unlink(*ring, (folder / "present").string()).get(), 0);
+    EXPECT_FALSE(fs::exists(folder / "present"));
+}
+
+// the operations awaited before the flush task runs go to the kernel with one io_uring_enter
+TEST_F(IoUringTest, SubmitsTheWaitingOperationsInOneBatch) {
+    const size_t count = 32;
+    string missing = (folder / "missing").string();
+    promise<void> gate;
+    shared_future<void> opened = gate.get_future().share();
+    executor.post(Task([opened]() { opened.wait(); })); // the single worker waits, the coroutines queue behind it
+
+    atomic<size_t> finished{0};
+    CoroutineScheduler scheduler(&executor);
+    for (size_t i = 0; i < count; i++) {
+        scheduler.spawn([](IoUring& ring, const string& path, atomic<size_t>& finished) -> AsyncTask<void> {
+            co_await ring.openAt(path.c_str(), O_RDONLY, 0);
+            finished++;
+        }(*ring, missing, finished));
+    }
+    gate.set_value();
+    while (finished < count) {
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    EXPECT_EQ(ring->operationCount(), count);
+    EXPECT_EQ(ring->submitCount(), 1u);
+}
+
+// beyond ENTRIES the operations wait for room in the ring
+TEST_F(IoUringTest, MoreOperationsThanEntriesComplete) {
+    const size_t count = IoUring::ENTRIES * 3;
+    string missing = (folder / "missing").string();
+    atomic<size_t> finished{0};
+    CoroutineScheduler scheduler(&executor);
+    for (size_t i = 0; i < count; i++) {
+        scheduler.spawn([](IoUring& ring, const string& path, atomic<size_t>& finished) -> AsyncTask<void> {
+            if (co_await ring.openAt(path.c_str(), O_RDONLY, 0) == -ENOENT) {
+                finished++;
+            }
+        }(*ring, missing, finished));
+    }
+    for (int waited = 0; finished < count && waited < 10000; waited++) {
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    EXPECT_EQ(finished, count);
+    EXPECT_EQ(ring->operationCount(), count);
+}
+
+// UringStorage over a FolderManager, the files it writes are the ones FolderManager reads and the other way around
+class UringStorageTest : public IoUringTest {
+protected:
+    ThreadPoolExecutor blocking{1};
+    unique_ptr<FolderManager> folderManager;
+    unique_ptr<UringStorage> storage;
+
+    void SetUp() override {
+        IoUringTest::SetUp();
+        if (IsSkipped()) {
+            return;
+        }
+        fs::create_directories(folder / "files");
+        fs::create_directories(folder / "names");
+        folderManager = make_unique<FolderManager>(folder / "files", folder / "names");
+        storage = make_unique<UringStorage>(folderManager.get(), ring.get(), &blocking, &executor);
+    }
+
+    void TearDown() override {
+        storage.reset();
+        folderManager.reset();
+        IoUringTest::TearDown();
+    }
+};
+
+TEST_F(UringStorageTest, InsertsReadsAndDeletesFiles) {
+    string content(100000, 'a');
+    content += "end";
+    EXPECT_TRUE(storage->insertFile("a.txt", content, folder / "files").get());
+    EXPECT_FALSE(storage->insertFile("a.txt", "other", folder / "files").get());
+    EXPECT_TRUE(storage->isExists("a.txt").get());
+    EXPECT_EQ(storage->getContent("a.txt").get(), content);
+    EXPECT_EQ(folderManager->getContent("a.txt"), content);
+
+    // a FolderManager that starts over the same folders knows the file
+    FolderManager reloaded(folder / "files", folder / "names");
+    EXPECT_TRUE(reloaded.isExists("a.txt"));
+
+    EXPECT_TRUE(storage->deleteFile("a.txt").get());
+    EXPECT_FALSE(storage->isExists("a.txt").get());
+    EXPECT_FALSE(storage->deleteFile("a.txt").get());
+    EXPECT_THROW(storage->getContent("a.txt").get(), exception);
+    EXPECT_TRUE(fs::is_empty(folder / "files"));
+}
+
+TEST_F(UringStorageTest, ReadsFilesFolderManagerWrote) {
+    ASSERT_TRUE(folderManager->insertFile("b.txt", "", folder / "files"));
+    EXPECT_EQ(storage->getContent("b.txt").get(), "");
+}
+
+// a name being written is neither readable nor insertable until the write finished
+TEST_F(UringStorageTest, BusyNamesAreReserved) {
+    fs::path fullFilePath;
+    ASSERT_TRUE(folderManager->beginInsert("c.txt", folder / "files", fullFilePath));
+    EXPECT_FALSE(folderManager->isExists("c.txt"));
+    EXPECT_FALSE(folderManager->insertFile("c.txt", "other", folder / "files"));
+    EXPECT_FALSE(storage->insertFile("c.txt", "other", folder / "files").get());
+
+    ofstream(fullFilePath) << "partial";
+    EXPECT_FALSE(folderManager->finishInsert("c.txt", fullFilePath, false));
+    EXPECT_FALSE(folderManager->isExists("c.txt"));
+    EXPECT_FALSE(fs::exists(fullFilePath));
+    EXPECT_TRUE(storage->insertFile("c.txt", "data", folder / "files").get());
+}
+
+TEST_F(UringStorageTest, DeleteCommandAwaitsTheRing) {
+    DeleteCommand command(folderManager.get());
+    ASSERT_TRUE(storage->insertFile("d.txt", "data", folder / "files").get());
+    string name = "d.txt";
+    EXPECT_EQ(command.executeAsync(name, *storage).get().first, 204);
+    EXPECT_EQ(command.executeAsync(name, *storage).get().first, 404);
+}
@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include "LaneExecutor.h"
+#include "AddCommand.h"
+#include "SearchCommand.h"
+#include "GetCommand.h"
+#include "BatchCommand.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// a gate the tasks wait on until the test opens it
+class Gate {
+private:
+    promise<void> opened;
+    shared_future<void> waiting = opened.get_future().share();
+
+public:
+    void wait() const {
+        waiting.wait();
+    }
+    void open() {
+        opened.set_value();
+    }
+    shared_future<void> future() const {
+        return waiting;
+    }
+};
+
+TEST(LanePoolTest, InteractiveRunsWhileBulkIsBusy) {
+    LaneExecutor executor(2); // the default limits leave one worker to the interactive lane
+    Gate gate;
+    shared_future<void> opened = gate.future();
+    for (int i = 0; i < 10; i++) {
+        executor.post([opened]() { opened.wait(); }, TaskLane::BULK);
+    }
+    future<int> get = executor.submit([]() { return 1; }); // from outside the pool - interactive
+    EXPECT_EQ(get.wait_for(chrono::seconds(1)), future_status::ready);
+    gate.open();
+}
+
+TEST(LanePoolTest, BackgroundRunsOneAtATime) {
+    LaneExecutor executor(4);
+    atomic<int> running{0};
+    atomic<int> mostRunning{0};
+    vector<future<void>> done;
+    for (int i = 0; i < 8; i++) {
+        promise<void> finished;
+        done.push_back(finished.get_future());
+        executor.post([&running, &mostRunning, finished = move(finished)]() mutable {
+            int now = ++running;
+            int most = mostRunning.load();
+            while (now > most && !mostRunning.compare_exchange_weak(most, now)) {
+            }
+            this_thread::sleep_for(chrono::milliseconds(2));
+            running--;
+            finished.set_value();
+        }, TaskLane::BACKGROUND);
+    }
+    for (future<void>& task : done) {
+        task.get();
+    }
+    EXPECT_EQ(mostRunning.load(), 1);
+}
+
+TEST(LanePoolTest, LanesShareTheWorkersByWeight) {
+    vector<LaneLimits> limits(TaskLane::COUNT);
+    limits[TaskLane::INTERACTIVE] = {2, 0};
+    limits[TaskLane::BULK] = {1, 0};
+    LaneExecutor executor(1, limits);
+
+    // the only worker waits at the gate while both lanes fill up
+    Gate gate;
+    shared_future<void> opened = gate.future();
+    executor.post([opened]() { opened.wait(); });
+    this_thread::sleep_for(chrono::milliseconds(20));
+
+    mutex lock;
+    vector<int> order;
+    for (int i = 0; i < 30; i++) {
+        executor.post([&lock, &order]() { lock_guard<mutex> guard(lock); order.push_back(TaskLane::INTERACTIVE); },
+                      TaskLane::INTERACTIVE);
+        executor.post([&lock, &order]() { lock_guard<mutex> guard(lock); order.push_back(TaskLane::BULK); },
+                      TaskLane::BULK);
+    }
+    gate.open();
+    // the last bulk task - the interactive lane (with twice the weight) is empty before it runs
+    executor.submit([]() {}, TaskLane::BULK).get();
+
+    lock_guard<mutex> guard(lock);
+    ASSERT_EQ(order.size(), 60u);
+    // while both lanes have tasks, two of every three picks are interactive
+    EXPECT_EQ(count(order.begin(), order.begin() + 9, TaskLane::INTERACTIVE), 6);
+    EXPECT_EQ(count(order.begin(), order.begin() + 9, TaskLane::BULK), 3);
+}
+
+TEST(LanePoolTest, TasksPostedFromATaskStayInItsLane) {
+    vector<LaneLimits> limits(TaskLane::COUNT);
+    limits[TaskLane::BULK] = {1, 1}; // one bulk task at a time
+    LaneExecutor executor(3, limits);
+
+    atomic<bool> childStarted{false};
+    future<bool> startedDuringParent = executor.submit([&executor, &childStarted]() {
+        executor.post([&childStarted]() { childStarted = true; }); // the lane of the caller - bulk
+        this_thread::sleep_for(chrono::milliseconds(50));
+        return childStarted.load();
+    }, TaskLane::BULK);
+
+    EXPECT_FALSE(startedDuringParent.get()); // it waited for the bulk slot of its parent
+    auto deadline = chrono::steady_clock::now() + chrono::seconds(1);
+    while (!childStarted && chrono::steady_clock::now() < deadline) {
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    EXPECT_TRUE(childStarted.load());
+}
+
+// the second background task waits for the lane while the other worker sleeps. when that worker takes it,
+// the wait is queue wait, not run time
+TEST(LanePoolTest, WaitForALaneIsQueueWait) {
+    LaneExecutor executor(2, LanePool::defaultLimits(2), nullptr, true); // background runs one at a time
+    promise<void> lastDone;
+    promise<void> childDone;
+    future<void> last = lastDone.get_future();
+    future<void> child = childDone.get_future();
+    executor.post([&executor, &childDone]() {
+        this_thread::sleep_for(chrono::milliseconds(50));
+        // keeps this worker busy when it gives up the lane
+        executor.post([&childDone]() { childDone.set_value(); }, TaskLane::INTERACTIVE);
+    }, TaskLane::BACKGROUND);
+    executor.post([&lastDone]() { lastDone.set_value(); }, TaskLane::BACKGROUND);
+    executor.submit([]() {}).get(); // the other worker finishes it after the second task was queued, then sleeps
+    last.get();
+    child.get();
+    executor.shutdown();
+
+    const TaskMetrics* metrics = executor.metrics();
+    ASSERT_NE(metrics, nullptr);
+    EXPECT_EQ(metrics->queueWait().count, 4u);
+    EXPECT_GE(metrics->queueWait().max, 40000000u); // the second task waited for most of the first one
+    EXPECT_LT(metrics->runTime().percentile(75), 10000000u); // only the first one ran long
+}
+
+TEST(CommandLaneTest, CommandsPickTheirLanes) {
+    AddCommand add(nullptr, nullptr);
+    EXPECT_EQ(add.lane("name small content"), TaskLane::INTERACTIVE);
+    EXPECT_EQ(add.lane("name " + string(AddCommand::LARGE_POST_BYTES, 'x')), TaskLane::BULK);
+
+    SearchCommand search(nullptr, nullptr);
+    EXPECT_EQ(search.lane("text"), TaskLane::BULK);
+
+    BatchCommand batch(new GetCommand(nullptr, nullptr), nullptr, 8, TaskLane::BACKGROUND);
+    EXPECT_EQ(batch.lane("a b c"), TaskLane::INTERACTIVE);
+    string manyNames;
+    for (size_t i = 0; i <= BatchCommand::SMALL_BATCH_ITEMS; i++) {
+        manyNames += "name" + to_string(i) + " ";
+    }
+    EXPECT_EQ(batch.lane(manyNames), TaskLane::BACKGROUND);
+}
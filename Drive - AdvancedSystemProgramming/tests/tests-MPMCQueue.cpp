@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+#include "MPMCQueue.h"
+#include "SafeQueue.h"
+#include "ThreadPoolExecutor.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// a task that only counts its runs
+class QueueItem : public IRunnable {
+public:
+    atomic<int> runs{0};
+    void run() override {
+        runs++;
+    }
+};
+
+// a queued task that runs the item
+static Task taskFor(QueueItem& item) {
+    return Task([&item]() { item.run(); });
+}
+
+TEST(MPMCQueueTest, KeepsFifoOrderForOneThread) {
+    MPMCQueue queue(8);
+    vector<int> order;
+    for (int i = 0; i < 5; i++) {
+        queue.enqueue(Task([&order, i]() { order.push_back(i); }));
+    }
+    EXPECT_FALSE(queue.isEmpty());
+    for (int i = 0; i < 5; i++) {
+        Task task;
+        ASSERT_TRUE(queue.dequeue(task));
+        task();
+    }
+    EXPECT_EQ(order, vector<int>({0, 1, 2, 3, 4}));
+    EXPECT_TRUE(queue.isEmpty());
+}
+
+TEST(MPMCQueueTest, TryEnqueueFailsWhenFull) {
+    MPMCQueue queue(4);
+    QueueItem item;
+    for (int i = 0; i < 4; i++) {
+        Task task = taskFor(item);
+        EXPECT_TRUE(queue.tryEnqueue(task));
+        EXPECT_FALSE(task); // moved into the queue
+    }
+    Task extra = taskFor(item);
+    EXPECT_FALSE(queue.tryEnqueue(extra));
+    EXPECT_TRUE(extra); // still ours
+
+    Task taken;
+    EXPECT_TRUE(queue.tryDequeue(taken));
+    taken();
+    EXPECT_EQ(item.runs.load(), 1);
+    EXPECT_TRUE(queue.tryEnqueue(extra)); // the freed cell is used again in the next round
+}
+
+TEST(MPMCQueueTest, TryDequeueFailsWhenEmpty) {
+    MPMCQueue queue(4);
+    Task taken;
+    EXPECT_FALSE(queue.tryDequeue(taken));
+    EXPECT_FALSE(taken);
+}
+
+TEST(MPMCQueueTest, ShutdownWakesBlockedConsumers) {
+    MPMCQueue queue(4);
+    atomic<int> woken{0};
+    vector<thread> consumers;
+    for (int i = 0; i < 3; i++) {
+        consumers.emplace_back([&queue, &woken]() {
+            Task task;
+            if (!queue.dequeue(task)) {
+                woken++;
+            }
+        });
+    }
+    this_thread::sleep_for(chrono::milliseconds(50)); // long enough for them to sleep on the futex
+    queue.shutdown();
+    for (thread& consumer : consumers) {
+        consumer.join();
+    }
+    EXPECT_EQ(woken.load(), 3);
+}
+
+TEST(MPMCQueueTest, ShutdownWakesBlockedProducers) {
+    MPMCQueue queue(2);
+    QueueItem item;
+    queue.enqueue(taskFor(item));
+    queue.enqueue(taskFor(item));
+    thread producer([&queue, &item]() {
+        queue.enqueue(taskFor(item)); // full - waits until the shutdown drops it
+    });
+    this_thread::sleep_for(chrono::milliseconds(50));
+    queue.shutdown();
+    producer.join();
+}
+
+TEST(MPMCQueueTest, DestroysTheTasksItStillHolds) {
+    shared_ptr<int> state = make_shared<int>(0);
+    {
+        MPMCQueue queue(4);
+        queue.enqueue(Task([state]() {}));
+        EXPECT_EQ(state.use_count(), 2);
+    }
+    EXPECT_EQ(state.use_count(), 1);
+}
+
+// many producers and consumers on a small ring, so both sides keep wrapping around and blocking:
+// every item must come out exactly once
+TEST(MPMCQueueTest, StressEveryItemExactlyOnce) {
+    const int producers = 4;
+    const int consumers = 4;
+    const int perProducer = 20000;
+    MPMCQueue queue(16);
+    vector<QueueItem> items(producers * perProducer);
+
+    vector<thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&queue, &items, p, perProducer]() {
+            for (int i = 0; i < perProducer; i++) {
+                queue.enqueue(taskFor(items[p * perProducer + i]));
+            }
+        });
+    }
+    for (int c = 0; c < consumers; c++) {
+        threads.emplace_back([&queue, &items, consumers]() {
+            for (size_t i = 0; i < items.size() / consumers; i++) {
+                Task task;
+                queue.dequeue(task);
+                task();
+            }
+        });
+    }
+    for (thread& t : threads) {
+        t.join();
+    }
+
+    EXPECT_TRUE(queue.isEmpty());
+    for (QueueItem& item : items) {
+        ASSERT_EQ(item.runs.load(), 1);
+    }
+}
+
+TEST(MPMCQueueTest, ThreadPoolRunsTasksFromLockFreeQueue) {
+    vector<QueueItem> items(5000);
+    {
+        ThreadPoolExecutor executor(4, new MPMCQueue(64));
+        for (QueueItem& item : items) {
+            executor.execute(item);
+        }
+        // shutdown drops the tasks that are still queued (like SafeQueue), so wait until the last one was taken -
+        // the queue is FIFO, so every other task was taken before it and finishes before the workers join
+        auto deadline = chrono::steady_clock::now() + chrono::seconds(10);
+        while (items.back().runs.load() == 0 && chrono::steady_clock::now() < deadline) {
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+    }
+    int ran = 0;
+    for (QueueItem& item : items) {
+        ran += item.runs.load();
+    }
+    EXPECT_EQ(ran, 5000);
+}
+
+// a worker that fills the queue of its own pool does not wait for room (only it could make room):
+// the tasks beyond the capacity run on it at once
+TEST(MPMCQueueTest, WorkerPostingPastTheCapacityDoesNotDeadlock) {
+    vector<QueueItem> items(10);
+    atomic<bool> posted(false);
+    {
+        ThreadPoolExecutor executor(1, new MPMCQueue(2));
+        executor.post(Task([&executor, &items, &posted]() {
+            for (QueueItem& item : items) {
+                executor.post(taskFor(item));
+            }
+            posted = true;
+        }));
+        // the first ones wait in the queue until the posting task is done, shutdown would drop them
+        auto deadline = chrono::steady_clock::now() + chrono::seconds(10);
+        while ((items.front().runs.load() == 0 || items.back().runs.load() == 0) &&
+               chrono::steady_clock::now() < deadline) {
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+    }
+    EXPECT_TRUE(posted);
+    for (QueueItem& item : items) {
+        EXPECT_EQ(item.runs.load(), 1);
+    }
+}
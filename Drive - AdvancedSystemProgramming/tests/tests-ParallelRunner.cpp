@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+#include "ParallelRunner.h"
+#include "ThreadPoolExecutor.h"
+#include <atomic>
+#include <vector>
+
+using namespace std;
+
+TEST(ParallelRunnerTest, RunsEveryItemOnce) {
+    ThreadPoolExecutor executor(3);
+    vector<atomic<int>> calls(1000);
+    ParallelRunner::forEach(&executor, calls.size(), [&calls](size_t i) { calls[i]++; }, 3);
+    for (auto& count : calls) {
+        EXPECT_EQ(count.load(), 1);
+    }
+}
+
+TEST(ParallelRunnerTest, FinishesWhenExecutorIsBusy) {
+    // the only pool thread is blocked, the helpers never start before the loop is over
+    ThreadPoolExecutor executor(1);
+    atomic<bool> release(false);
+    class BlockingTask : public IRunnable {
+    public:
+        atomic<bool>& release;
+        BlockingTask(atomic<bool>& release) : release(release) {}
+        void run() override {
+            while (!release) {
+                this_thread::yield();
+            }
+        }
+    } blocker(release);
+    executor.execute(blocker);
+
+    atomic<int> total(0);
+    ParallelRunner::forEach(&executor, 100, [&total](size_t i) { total += (int)i; }, 4);
+    EXPECT_EQ(total.load(), 4950);
+    release = true;
+    executor.shutdown(); // the blocker lives on this stack, wait for it before leaving
+}
+
+TEST(ParallelRunnerTest, NoExecutorAndNoItems) {
+    int calls = 0;
+    ParallelRunner::forEach(nullptr, 5, [&calls](size_t) { calls++; }, 4);
+    EXPECT_EQ(calls, 5);
+    ParallelRunner::forEach(nullptr, 0, [&calls](size_t) { calls++; }, 4);
+    EXPECT_EQ(calls, 5);
+}
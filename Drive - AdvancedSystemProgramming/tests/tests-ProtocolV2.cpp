@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+#include "ProtocolV2.h"
+#include <string>
+
+using namespace std;
+
+TEST(ProtocolV2Test, HeaderRoundTrip) {
+    ProtocolV2::FrameHeader header;
+    header.opcode = ProtocolV2::OPCODE_GET;
+    header.flags = ProtocolV2::FLAG_MORE;
+    header.status = 404;
+    header.requestId = 0x01020304;
+    header.bodyLength = 0x0000000500000006ULL; // more than 32 bits
+
+    string encoded = ProtocolV2::encodeHeader(header);
+    ASSERT_EQ(encoded.size(), ProtocolV2::HEADER_SIZE);
+    EXPECT_EQ(encoded.substr(0, 4), "DRV2");
+    // big endian on the wire
+    EXPECT_EQ(encoded.substr(8, 4), string("\x01\x02\x03\x04", 4));
+
+    ProtocolV2::FrameHeader parsed;
+    ASSERT_TRUE(ProtocolV2::parseHeader(encoded, parsed));
+    EXPECT_EQ(parsed.opcode, header.opcode);
+    EXPECT_EQ(parsed.flags, header.flags);
+    EXPECT_EQ(parsed.status, header.status);
+    EXPECT_EQ(parsed.requestId, header.requestId);
+    EXPECT_EQ(parsed.bodyLength, header.bodyLength);
+}
+
+TEST(ProtocolV2Test, IncompleteAndBadHeaders) {
+    ProtocolV2::FrameHeader header;
+    string encoded = ProtocolV2::encodeHeader(header);
+
+    // not enough bytes yet
+    EXPECT_FALSE(ProtocolV2::parseHeader(string_view(encoded).substr(0, ProtocolV2::HEADER_SIZE - 1), header));
+    // legacy commands do not start with the magic
+    EXPECT_FALSE(ProtocolV2::hasMagic("get a.txt\n"));
+    EXPECT_FALSE(ProtocolV2::hasMagic("DRV"));
+    EXPECT_TRUE(ProtocolV2::hasMagic(encoded));
+    EXPECT_THROW(ProtocolV2::parseHeader("post a.txt 0123456789012345\n", header), std::exception);
+}
+
+TEST(ProtocolV2Test, Opcodes) {
+    EXPECT_EQ(ProtocolV2::commandName(ProtocolV2::OPCODE_POST), "post");
+    EXPECT_EQ(ProtocolV2::commandName(ProtocolV2::OPCODE_LIST), "list");
+    EXPECT_EQ(ProtocolV2::commandName(0), "");
+    EXPECT_EQ(ProtocolV2::opcodeOf("search"), ProtocolV2::OPCODE_SEARCH);
+    EXPECT_EQ(ProtocolV2::opcodeOf("nothing"), 0);
+}
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+#include "StreamScanner.h"
+#include "StringDecompressStream.h"
+#include <string>
+
+using namespace std;
+
+// Mock stream that counts how many bytes were requested from it
+class CountingStream : public IdecompressStream {
+public:
+    StringDecompressStream inner;
+    size_t bytesRead = 0;
+
+    CountingStream(const string& content) : inner(content) {}
+
+    size_t read(char* buffer, size_t maxBytes) override {
+        size_t received = inner.read(buffer, maxBytes);
+        bytesRead += received;
+        return received;
+    }
+};
+
+// --- Test Cases ---
+
+TEST(StreamScannerTest, FindsPatternInsideOneChunk) {
+    StreamScanner scanner(16);
+    StringDecompressStream stream("hidden treasure inside");
+    EXPECT_TRUE(scanner.contains(stream, "treasure"));
+}
+
+TEST(StreamScannerTest, FindsPatternAcrossChunkBoundary) {
+    // with chunks of 4 bytes "abcdef" is split as "xxab" "cdef" - only the overlap finds it
+    StreamScanner scanner(4);
+    StringDecompressStream stream("xxabcdefyy");
+    EXPECT_TRUE(scanner.contains(stream, "abcdef"));
+
+    // pattern longer than a chunk, split over three chunks
+    StreamScanner tinyScanner(2);
+    StringDecompressStream otherStream("0123456789");
+    EXPECT_TRUE(tinyScanner.contains(otherStream, "234567"));
+}
+
+TEST(StreamScannerTest, NoMatch) {
+    StreamScanner scanner(4);
+    StringDecompressStream stream("aaaaaaaaaaaaab");
+    EXPECT_FALSE(scanner.contains(stream, "ba"));
+
+    StringDecompressStream empty("");
+    EXPECT_FALSE(scanner.contains(empty, "a"));
+}
+
+TEST(StreamScannerTest, StopsAtFirstMatch) {
+    StreamScanner scanner(8);
+    CountingStream stream("match" + string(1000, '-'));
+    EXPECT_TRUE(scanner.contains(stream, "match"));
+    // only the first chunk was read
+    EXPECT_EQ(stream.bytesRead, 8);
+}
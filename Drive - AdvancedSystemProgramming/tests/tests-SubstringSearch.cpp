@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+#include "SubstringSearch.h"
+#include <string>
+#include <random>
+
+using namespace std;
+
+// --- Test Cases ---
+
+TEST(SubstringSearchTest, BasicMatches) {
+    EXPECT_EQ(SubstringSearch::find("hidden treasure inside", "treasure"), 7);
+    EXPECT_EQ(SubstringSearch::find("abc", "abc"), 0);
+    EXPECT_EQ(SubstringSearch::find("abc", "c"), 2);
+    EXPECT_EQ(SubstringSearch::find("abc", "ab"), 0);
+    EXPECT_EQ(SubstringSearch::find("abc", ""), 0);
+}
+
+TEST(SubstringSearchTest, NoMatch) {
+    EXPECT_EQ(SubstringSearch::find("abc", "abcd"), string_view::npos);
+    EXPECT_EQ(SubstringSearch::find("", "a"), string_view::npos);
+    // first and last byte match but the middle does not
+    EXPECT_EQ(SubstringSearch::find(string(100, 'a') + "axxb", "ayyb"), string_view::npos);
+}
+
+TEST(SubstringSearchTest, MatchAtEveryBlockPosition) {
+    // the match must be found wherever it lands relative to the SIMD blocks, including the tail
+    string needle = "needle";
+    for (size_t position = 0; position < 100; position++) {
+        string haystack = string(position, '.') + needle + string(7, '.');
+        EXPECT_EQ(SubstringSearch::find(haystack, needle), position);
+        EXPECT_EQ(SubstringSearch::findScalar(haystack, needle), position);
+        // match that ends exactly at the end of the haystack
+        EXPECT_EQ(SubstringSearch::find(string(position, '.') + needle, needle), position);
+    }
+}
+
+TEST(SubstringSearchTest, BinaryContent) {
+    string haystack(64, '\0');
+    haystack[40] = '\x01';
+    haystack[41] = '\xff';
+    EXPECT_EQ(SubstringSearch::find(haystack, string("\0\x01\xff", 3)), 39);
+}
+
+TEST(SubstringSearchTest, MatchesStdFindOnRandomInput) {
+    // small alphabet so candidates (first+last byte matches) are frequent
+    mt19937 random(42);
+    uniform_int_distribution<int> letter('a', 'c');
+    for (int round = 0; round < 2000; round++) {
+        string haystack(random() % 200, ' ');
+        for (char& c : haystack) c = letter(random);
+        string needle(1 + random() % 8, ' ');
+        for (char& c : needle) c = letter(random);
+
+        EXPECT_EQ(SubstringSearch::find(haystack, needle), haystack.find(needle));
+        EXPECT_EQ(SubstringSearch::findScalar(haystack, needle), haystack.find(needle));
+    }
+}
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include "Task.h"
+#include "ThreadPoolExecutor.h"
+#include "WorkStealingExecutor.h"
+#include "ElasticExecutor.h"
+#include "LaneExecutor.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+using namespace std;
+
+TEST(TaskTest, RunsASmallCallable) {
+    int calls = 0;
+    Task task([&calls]() { calls++; });
+    ASSERT_TRUE(task);
+    task();
+    task();
+    EXPECT_EQ(calls, 2);
+}
+
+TEST(TaskTest, RunsACallableTooBigToStoreInside) {
+    array<char, Task::INLINE_SIZE * 2> big{};
+    big[0] = 'x';
+    char seen = 0;
+    Task task([big, &seen]() { seen = big[0]; });
+    Task moved(move(task));
+    moved();
+    EXPECT_EQ(seen, 'x');
+}
+
+TEST(TaskTest, HoldsMoveOnlyState) {
+    unique_ptr<int> value(new int(42));
+    int seen = 0;
+    Task task([value = move(value), &seen]() { seen = *value; });
+    Task other;
+    other = move(task);
+    EXPECT_FALSE(task); // moved from - empty
+    other();
+    EXPECT_EQ(seen, 42);
+}
+
+TEST(TaskTest, DestroysItsStateEvenIfItNeverRan) {
+    shared_ptr<int> small = make_shared<int>(0);
+    shared_ptr<int> big = make_shared<int>(0);
+    {
+        Task inside([small]() {});
+        array<char, Task::INLINE_SIZE * 2> padding{};
+        Task onHeap([big, padding]() { (void)padding; });
+        EXPECT_EQ(small.use_count(), 2);
+        EXPECT_EQ(big.use_count(), 2);
+    }
+    EXPECT_EQ(small.use_count(), 1);
+    EXPECT_EQ(big.use_count(), 1);
+}
+
+TEST(TaskTest, RunAndReportCatchesTheException) {
+    Task failing([]() { throw runtime_error("boom"); });
+    EXPECT_FALSE(failing.runAndReport());
+    Task working([]() {});
+    EXPECT_TRUE(working.runAndReport());
+}
+
+// the same owned-task contract for every executor
+template <typename Executor>
+class ExecutorContractTest : public ::testing::Test {
+protected:
+    Executor executor{2};
+};
+
+// ElasticExecutor has no single size argument, this is its fixed size form
+class FixedElasticExecutor : public ElasticExecutor {
+public:
+    FixedElasticExecutor(size_t threads) : ElasticExecutor(threads, threads) {}
+};
+
+using Executors = ::testing::Types<ThreadPoolExecutor, WorkStealingExecutor, FixedElasticExecutor, LaneExecutor>;
+TYPED_TEST_SUITE(ExecutorContractTest, Executors);
+
+TYPED_TEST(ExecutorContractTest, SubmitReturnsTheResult) {
+    future<int> answer = this->executor.submit([]() { return 6 * 7; });
+    EXPECT_EQ(answer.get(), 42);
+}
+
+TYPED_TEST(ExecutorContractTest, SubmitPropagatesTheException) {
+    future<void> failed = this->executor.submit([]() { throw runtime_error("boom"); });
+    EXPECT_THROW(failed.get(), runtime_error);
+    // the worker is still alive
+    EXPECT_EQ(this->executor.submit([]() { return 1; }).get(), 1);
+}
+
+TYPED_TEST(ExecutorContractTest, SubmitTakesMoveOnlyWork) {
+    unique_ptr<string> text(new string("owned"));
+    future<size_t> length = this->executor.submit([text = move(text)]() { return text->size(); });
+    EXPECT_EQ(length.get(), 5u);
+}
+
+TYPED_TEST(ExecutorContractTest, PostedTaskIsDestroyedAfterItRan) {
+    shared_ptr<int> state = make_shared<int>(0);
+    promise<void> ran;
+    future<void> done = ran.get_future();
+    this->executor.post([state, ran = move(ran)]() mutable { ran.set_value(); });
+    done.get();
+    // the worker frees the task right after it ran
+    auto deadline = chrono::steady_clock::now() + chrono::seconds(1);
+    while (state.use_count() > 1 && chrono::steady_clock::now() < deadline) {
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    EXPECT_EQ(state.use_count(), 1);
+}
+
+TEST(ExecutorShutdownTest, DroppedTaskBreaksItsFuture) {
+    ThreadPoolExecutor executor(1);
+    promise<void> release;
+    shared_future<void> released = release.get_future().share();
+    future<void> blocker = executor.submit([released]() { released.wait(); });
+    this_thread::sleep_for(chrono::milliseconds(20)); // the only worker is busy now
+    future<int> queued = executor.submit([]() { return 1; });
+
+    thread stopper([&executor]() { executor.shutdown(); });
+    this_thread::sleep_for(chrono::milliseconds(20));
+    release.set_value();
+    stopper.join();
+
+    blocker.get();
+    try {
+        queued.get();
+        FAIL() << "the queued task should not run after shutdown";
+    } catch (const future_error& e) {
+        EXPECT_EQ(e.code(), make_error_code(future_errc::broken_promise));
+    }
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include "LatencyHistogram.h"
+#include "TaskMetrics.h"
+#include "ThreadPoolExecutor.h"
+#include "WorkStealingExecutor.h"
+#include "LaneExecutor.h"
+#include "AdmissionController.h"
+#include "StatsCommand.h"
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+TEST(LatencyHistogramTest, BucketsKeepValuesWithinASixteenth) {
+    for (uint64_t value : {0ull, 1ull, 15ull, 16ull, 17ull, 100ull, 1000ull, 123456ull, 1ull << 40, ~0ull}) {
+        size_t bucket = LatencyHistogram::bucketOf(value);
+        ASSERT_LT(bucket, LatencyHistogram::BUCKET_COUNT);
+        uint64_t highest = LatencyHistogram::highestValueOf(bucket);
+        EXPECT_GE(highest, value);
+        EXPECT_LE(highest - value, value / LatencyHistogram::SUB_BUCKETS) << value;
+        if (bucket > 0) {
+            EXPECT_LT(LatencyHistogram::highestValueOf(bucket - 1), value) << value;
+        }
+    }
+}
+
+TEST(LatencyHistogramTest, Percentiles) {
+    LatencyHistogram histogram;
+    for (uint64_t value = 1; value <= 1000; value++) {
+        histogram.record(value * 1000); // 1us..1ms
+    }
+    HistogramSnapshot snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count, 1000u);
+    EXPECT_EQ(snapshot.max, 1000000u);
+    EXPECT_EQ(snapshot.mean(), 500500u);
+    EXPECT_NEAR(snapshot.percentile(50), 500000.0, 500000.0 / 16);
+    EXPECT_NEAR(snapshot.percentile(99), 990000.0, 990000.0 / 16);
+    EXPECT_EQ(snapshot.percentile(100), 1000000u); // capped at the max, not the end of its bucket
+    EXPECT_EQ(HistogramSnapshot().percentile(99), 0u);
+}
+
+TEST(LatencyHistogramTest, SnapshotsMerge) {
+    LatencyHistogram fast;
+    LatencyHistogram slow;
+    for (int i = 0; i < 90; i++) {
+        fast.record(10);
+    }
+    for (int i = 0; i < 10; i++) {
+        slow.record(5000);
+    }
+    HistogramSnapshot all = fast.snapshot();
+    all.merge(slow.snapshot());
+    EXPECT_EQ(all.count, 100u);
+    EXPECT_EQ(all.percentile(90), 10u);
+    EXPECT_GE(all.percentile(95), 5000u);
+    EXPECT_EQ(all.max, 5000u);
+}
+
+// a busy worker: the second task waits for the first one to run, and both run for the time they sleep
+TEST(TaskMetricsTest, SeparatesQueueWaitFromRunTime) {
+    ThreadPoolExecutor executor(1, nullptr, nullptr, true);
+    ASSERT_NE(executor.metrics(), nullptr);
+    future<void> first = executor.submit([]() { this_thread::sleep_for(chrono::milliseconds(20)); });
+    future<void> second = executor.submit([]() { this_thread::sleep_for(chrono::milliseconds(5)); });
+    first.get();
+    second.get();
+    executor.shutdown(); // the records are written after the tasks ran
+
+    const TaskMetrics* metrics = executor.metrics();
+    ASSERT_EQ(metrics->workerCount(), 1u);
+    HistogramSnapshot runTime = metrics->runTime(0);
+    HistogramSnapshot queueWait = metrics->queueWait();
+    EXPECT_EQ(runTime.count, 2u);
+    EXPECT_EQ(queueWait.count, 2u);
+    EXPECT_GE(runTime.max, 20000000u);
+    EXPECT_GE(runTime.percentile(0), 5000000u);
+    EXPECT_GE(queueWait.max, 15000000u); // the second task waited for most of the first one
+}
+
+// a worker that slept before its next task: the sleep is queue wait of that task, not run time
+TEST(TaskMetricsTest, IdleWorkerReadsTheClockAgain) {
+    TaskMetrics metrics(1);
+    Task first([]() {});
+    Task second([]() {});
+    first.setEnqueuedAt(TaskMetrics::now());
+    second.setEnqueuedAt(TaskMetrics::now());
+    metrics.run(0, first);
+    metrics.idle(0);
+    this_thread::sleep_for(chrono::milliseconds(20));
+    metrics.run(0, second);
+
+    EXPECT_EQ(metrics.runTime(0).count, 2u);
+    EXPECT_LT(metrics.runTime(0).max, 10000000u);
+    EXPECT_GE(metrics.queueWait(0).max, 20000000u);
+}
+
+TEST(TaskMetricsTest, OffByDefault) {
+    ThreadPoolExecutor executor(1);
+    EXPECT_EQ(executor.metrics(), nullptr);
+    WorkStealingExecutor stealing(1);
+    EXPECT_EQ(stealing.metrics(), nullptr);
+}
+
+TEST(TaskMetricsTest, EveryPoolCountsItsTasks) {
+    WorkStealingExecutor stealing(2, nullptr, true);
+    LaneExecutor lanes(2, LanePool::defaultLimits(2), nullptr, true);
+    vector<IExecutor*> executors = {&stealing, &lanes};
+    for (IExecutor* executor : executors) {
+        vector<future<void>> done;
+        for (int i = 0; i < 50; i++) {
+            done.push_back(executor->submit([]() {}, i % TaskLane::COUNT));
+        }
+        for (future<void>& task : done) {
+            task.get();
+        }
+    }
+    stealing.shutdown();
+    lanes.shutdown();
+    for (IExecutor* executor : executors) {
+        const TaskMetrics* metrics = executor->metrics();
+        ASSERT_NE(metrics, nullptr);
+        EXPECT_EQ(metrics->workerCount(), 2u);
+        EXPECT_EQ(metrics->runTime().count, 50u);
+        EXPECT_EQ(metrics->queueWait().count, 50u);
+        EXPECT_EQ(metrics->runTime(0).count + metrics->runTime(1).count, 50u);
+    }
+}
+
+TEST(TaskMetricsTest, StatsReportTheRequests) {
+    ThreadPoolExecutor executor(2, nullptr, nullptr, true);
+    executor.submit([]() {}).get();
+    executor.shutdown();
+    AdmissionController admission;
+    admission.watchRequestMetrics(executor.metrics());
+    StatsCommand stats(&admission);
+
+    string output = stats.execute("").second;
+    EXPECT_NE(output.find("\nrequest_tasks 1\nrequest_queue_wait_p50_us "), string::npos);
+    EXPECT_NE(output.find("\nrequest_run_p999_us "), string::npos);
+    EXPECT_NE(output.find("\nrequest_worker_1_tasks "), string::npos);
+
+    AdmissionController unwatched;
+    EXPECT_EQ(StatsCommand(&unwatched).execute("").second.find("request_"), string::npos);
+}
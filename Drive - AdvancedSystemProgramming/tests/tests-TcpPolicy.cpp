@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+#include "TcpPolicy.h"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <unistd.h>
+
+TEST(TcpPolicyTest, FromName) {
+    EXPECT_EQ(TcpPolicy::fromName("nagle"), TcpPolicy::NAGLE);
+    EXPECT_EQ(TcpPolicy::fromName("cork"), TcpPolicy::CORK);
+    EXPECT_EQ(TcpPolicy::fromName("nodelay"), TcpPolicy::NO_DELAY);
+    // unknown or missing names use the default
+    EXPECT_EQ(TcpPolicy::fromName(""), TcpPolicy::NO_DELAY);
+    EXPECT_EQ(TcpPolicy::fromName("fast"), TcpPolicy::NO_DELAY);
+}
+
+TEST(TcpPolicyTest, AppliesSocketOptions) {
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_NE(sock, -1);
+    int value = 0;
+    socklen_t length = sizeof(value);
+
+    ASSERT_TRUE(TcpPolicy::apply(sock, TcpPolicy::NO_DELAY));
+    getsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &value, &length);
+    EXPECT_NE(value, 0);
+
+    ASSERT_TRUE(TcpPolicy::apply(sock, TcpPolicy::CORK));
+    getsockopt(sock, IPPROTO_TCP, TCP_CORK, &value, &length);
+    EXPECT_NE(value, 0);
+    // a flush keeps the socket corked for the next response
+    TcpPolicy::flush(sock);
+    getsockopt(sock, IPPROTO_TCP, TCP_CORK, &value, &length);
+    EXPECT_NE(value, 0);
+    close(sock);
+
+    // not a TCP socket
+    int pair[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, pair), 0);
+    EXPECT_FALSE(TcpPolicy::apply(pair[0], TcpPolicy::NO_DELAY));
+    close(pair[0]);
+    close(pair[1]);
+}
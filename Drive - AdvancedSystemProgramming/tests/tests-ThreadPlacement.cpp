@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include "ThreadPlacement.h"
+#include "ThreadPoolExecutor.h"
+#include "LaneExecutor.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+using namespace std;
+
+// a fake sysfs node directory: node0 with CPUs 0-3, node1 with 4-7, node2 with memory only, node10 with 8
+class FakeSysfsTest : public ::testing::Test {
+protected:
+    filesystem::path root;
+
+    void writeNode(const string& name, const string& cpulist) {
+        filesystem::create_directories(root / name);
+        ofstream(root / name / "cpulist") << cpulist << "\n";
+    }
+
+    void SetUp() override {
+        root = filesystem::temp_directory_path() / ("fake-sysfs-" + to_string(::getpid()));
+        filesystem::remove_all(root);
+        writeNode("node0", "0-3");
+        writeNode("node1", "4-7");
+        writeNode("node2", "");
+        writeNode("node10", "8");
+        filesystem::create_directories(root / "power"); // not a node
+    }
+
+    void TearDown() override {
+        filesystem::remove_all(root);
+    }
+};
+
+TEST(CpuTopologyTest, ParsesCpuLists) {
+    EXPECT_EQ(CpuTopology::parseCpuList("0-3,8,10-11"), vector<int>({0, 1, 2, 3, 8, 10, 11}));
+    EXPECT_EQ(CpuTopology::parseCpuList("5"), vector<int>({5}));
+    EXPECT_TRUE(CpuTopology::parseCpuList("").empty());
+}
+
+TEST_F(FakeSysfsTest, ReadsTheNodesInOrder) {
+    CpuTopology topology = CpuTopology::fromSysfs(root.string());
+    ASSERT_EQ(topology.nodeCount(), 3u); // node2 has no CPUs
+    EXPECT_EQ(topology.cpusOf(0), vector<int>({0, 1, 2, 3}));
+    EXPECT_EQ(topology.cpusOf(1), vector<int>({4, 5, 6, 7}));
+    EXPECT_EQ(topology.cpusOf(2), vector<int>({8})); // node10 after node1, not before
+    EXPECT_EQ(topology.nodeOf(5), 1);
+    EXPECT_EQ(topology.nodeOf(42), -1);
+    EXPECT_EQ(topology.allCpus().size(), 9u);
+}
+
+TEST(CpuTopologyTest, NoSysfsIsOneNode) {
+    CpuTopology topology = CpuTopology::fromSysfs("/no/such/directory");
+    EXPECT_EQ(topology.nodeCount(), 1u);
+
+    CpuTopology machine = CpuTopology::detect();
+    EXPECT_GE(machine.nodeCount(), 1u);
+    EXPECT_FALSE(machine.allCpus().empty());
+}
+
+TEST_F(FakeSysfsTest, CoresSpreadTheWorkersOverTheNodes) {
+    CpuTopology topology = CpuTopology::fromSysfs(root.string());
+    ThreadPlacement cores(ThreadPlacement::CORES, topology);
+    EXPECT_EQ(cores.cpusForWorker(0), vector<int>({0}));
+    EXPECT_EQ(cores.cpusForWorker(1), vector<int>({4}));
+    EXPECT_EQ(cores.cpusForWorker(2), vector<int>({8}));
+    EXPECT_EQ(cores.cpusForWorker(3), vector<int>({1}));
+    EXPECT_EQ(cores.nodeForWorker(4), 1);
+
+    ThreadPlacement nodes(ThreadPlacement::NODES, topology);
+    EXPECT_EQ(nodes.cpusForWorker(1), vector<int>({4, 5, 6, 7}));
+
+    ThreadPlacement none(ThreadPlacement::NONE, topology);
+    EXPECT_TRUE(none.cpusForWorker(0).empty());
+    EXPECT_EQ(none.nodeForWorker(0), -1);
+    EXPECT_FALSE(none.placeWorker(0));
+}
+
+TEST(ThreadPlacementTest, PolicyByName) {
+    EXPECT_EQ(ThreadPlacement::fromName("cores"), ThreadPlacement::CORES);
+    EXPECT_EQ(ThreadPlacement::fromName("nodes"), ThreadPlacement::NODES);
+    EXPECT_EQ(ThreadPlacement::fromName(""), ThreadPlacement::NONE);
+    EXPECT_EQ(ThreadPlacement::fromName("bogus"), ThreadPlacement::NONE);
+}
+
+TEST(ThreadPlacementTest, PinsAndReleasesTheCallingThread) {
+    ThreadPlacement placement(ThreadPlacement::NODES);
+    thread worker([&placement]() {
+        int cpu = placement.getTopology().allCpus().front();
+        ASSERT_TRUE(ThreadPlacement::pinCurrentThread({cpu}));
+        EXPECT_EQ(ThreadPlacement::currentAffinity(), vector<int>({cpu}));
+        EXPECT_EQ(CpuTopology::currentCpu(), cpu);
+
+        EXPECT_TRUE(placement.placeOnNode(-1)); // back to every CPU of the topology
+        EXPECT_EQ(ThreadPlacement::currentAffinity(), placement.getTopology().allCpus());
+    });
+    worker.join();
+}
+
+TEST(ThreadPlacementTest, PoolWorkersRunWherePlaced) {
+    ThreadPlacement placement(ThreadPlacement::CORES);
+    {
+        ThreadPoolExecutor executor(2, nullptr, &placement);
+        vector<int> affinity = executor.submit([]() { return ThreadPlacement::currentAffinity(); }).get();
+        EXPECT_TRUE(affinity == placement.cpusForWorker(0) || affinity == placement.cpusForWorker(1));
+    }
+    {
+        LaneExecutor executor(1, LanePool::defaultLimits(1), &placement);
+        EXPECT_EQ(executor.submit([]() { return ThreadPlacement::currentAffinity(); }).get(), placement.cpusForWorker(0));
+    }
+}
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include "WorkStealingExecutor.h"
+#include "ParallelRunner.h"
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <stdexcept>
+
+using namespace std;
+
+// counts its runs, optionally adding more tasks from inside the pool
+class CountingTask : public IRunnable {
+public:
+    atomic<int> runs{0};
+    void run() override {
+        runs++;
+    }
+};
+
+TEST(WorkStealingPoolTest, RunsEveryTaskOnce) {
+    vector<CountingTask> tasks(10000);
+    {
+        WorkStealingExecutor executor(4);
+        for (CountingTask& task : tasks) {
+            executor.execute(task);
+        }
+        executor.shutdown(); // the queued tasks still run
+    }
+    for (CountingTask& task : tasks) {
+        EXPECT_EQ(task.runs.load(), 1);
+    }
+}
+
+TEST(WorkStealingPoolTest, ManyProducers) {
+    vector<CountingTask> tasks(8000);
+    WorkStealingExecutor executor(3);
+    vector<thread> producers;
+    for (size_t p = 0; p < 4; p++) {
+        producers.emplace_back([&tasks, &executor, p]() {
+            for (size_t i = p; i < tasks.size(); i += 4) {
+                executor.execute(tasks[i]);
+            }
+        });
+    }
+    for (thread& producer : producers) {
+        producer.join();
+    }
+    executor.shutdown();
+    for (CountingTask& task : tasks) {
+        EXPECT_EQ(task.runs.load(), 1);
+    }
+}
+
+// tasks added by a worker go to its own queue, the other workers must steal them to run them at the same time
+TEST(WorkStealingPoolTest, IdleWorkersStealQueuedTasks) {
+    const int workers = 4;
+    WorkStealingExecutor executor(workers);
+    atomic<int> started(0);
+    atomic<int> finished(0);
+
+    // every child waits until all of them started - only possible if each one runs on its own worker
+    class BarrierTask : public IRunnable {
+    public:
+        atomic<int>& started;
+        atomic<int>& finished;
+        BarrierTask(atomic<int>& started, atomic<int>& finished) : started(started), finished(finished) {}
+        void run() override {
+            started++;
+            auto deadline = chrono::steady_clock::now() + chrono::seconds(5);
+            while (started < workers && chrono::steady_clock::now() < deadline) {
+                this_thread::yield();
+            }
+            if (started == workers) {
+                finished++;
+            }
+        }
+    };
+    vector<BarrierTask> children(workers, BarrierTask(started, finished));
+
+    class ParentTask : public IRunnable {
+    public:
+        IExecutor& executor;
+        vector<BarrierTask>& children;
+        ParentTask(IExecutor& executor, vector<BarrierTask>& children) : executor(executor), children(children) {}
+        void run() override {
+            for (BarrierTask& child : children) {
+                executor.execute(child);
+            }
+        }
+    } parent(executor, children);
+
+    executor.execute(parent);
+    // tasks added after shutdown are not run, so wait for the children first
+    auto deadline = chrono::steady_clock::now() + chrono::seconds(10);
+    while (finished < workers && chrono::steady_clock::now() < deadline) {
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    executor.shutdown();
+    EXPECT_EQ(finished.load(), workers);
+}
+
+TEST(WorkStealingPoolTest, ThrowingTaskDoesNotStopTheWorker) {
+    class ThrowingTask : public IRunnable {
+    public:
+        void run() override {
+            throw runtime_error("task failed");
+        }
+    } failing;
+    CountingTask after;
+    WorkStealingExecutor executor(1);
+    executor.execute(failing);
+    executor.execute(after);
+    executor.shutdown();
+    EXPECT_EQ(after.runs.load(), 1);
+}
+
+TEST(WorkStealingPoolTest, NoTasksAfterShutdown) {
+    CountingTask task;
+    WorkStealingExecutor executor(2);
+    executor.shutdown();
+    executor.execute(task);
+    executor.shutdown();
+    EXPECT_EQ(task.runs.load(), 0);
+}
+
+// nested parallel loops: the helpers of a loop run on the pool while a pool worker waits for them
+TEST(WorkStealingPoolTest, RunsParallelLoopsOfItsWorkers) {
+    WorkStealingExecutor executor(3);
+    atomic<int> total(0);
+    ParallelRunner::forEach(&executor, 8, [&executor, &total](size_t) {
+        ParallelRunner::forEach(&executor, 100, [&total](size_t i) { total += (int)i; }, 3);
+    }, 3);
+    EXPECT_EQ(total.load(), 8 * 4950);
+}
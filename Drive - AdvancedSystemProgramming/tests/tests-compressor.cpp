@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 #include "RLEcompressor.h"
 #include <string>
+#include <sstream>
+#include <vector>
+#include <memory>
 
 using namespace std;
 
@@ -76,4 +79,45 @@ TEST_F(RLECompressorTest, RoundTripIntegrity) {
     string decompressed = compressor->decompressFile(compressed);
     
     EXPECT_EQ(decompressed, heavyString);
-}
\ No newline at end of file
+}
+
+// 5. Streaming decompression
+// Helper: read a decompress stream to the end using reads of the given size
+static string readAll(IdecompressStream& stream, size_t readSize) {
+    string result;
+    vector<char> buffer(readSize);
+    size_t received;
+    while ((received = stream.read(buffer.data(), readSize)) > 0) {
+        result.append(buffer.data(), received);
+    }
+    return result;
+}
+
+TEST_F(RLECompressorTest, StreamMatchesWholeDecompression) {
+    string original = "WWWWBBBWWB1212///   " + string(1000, 'x') + "\n\t12";
+    string compressed = compressor->compressFile(original);
+
+    // any read size must give the same content, including reads that split a run
+    for (size_t readSize : {1, 3, 7, 64, 4096}) {
+        unique_ptr<IdecompressStream> stream = compressor->openDecompressStream(make_unique<istringstream>(compressed));
+        EXPECT_EQ(readAll(*stream, readSize), original);
+    }
+}
+
+TEST_F(RLECompressorTest, StreamLongRunAndEmptyContent) {
+    // one run that is much bigger than a single read
+    unique_ptr<IdecompressStream> stream = compressor->openDecompressStream(make_unique<istringstream>("100000/A1/B"));
+    string result = readAll(*stream, 1024);
+    EXPECT_EQ(result.size(), 100001);
+    EXPECT_EQ(result.back(), 'B');
+
+    unique_ptr<IdecompressStream> empty = compressor->openDecompressStream(make_unique<istringstream>(""));
+    char buffer[16];
+    EXPECT_EQ(empty->read(buffer, sizeof(buffer)), 0);
+}
+
+TEST_F(RLECompressorTest, StreamCorruptedContent) {
+    // a count without a character after the delimiter
+    unique_ptr<IdecompressStream> stream = compressor->openDecompressStream(make_unique<istringstream>("3/A5/"));
+    EXPECT_THROW(readAll(*stream, 16), std::exception);
+}
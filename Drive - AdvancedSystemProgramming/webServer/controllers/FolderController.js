@@ -3,9 +3,9 @@ const dataBase = require('../models/DataBase');
 const WebClient = require('../models/webClient');
 const permissionObject = require('../models/Permission');
 
-// Helper functions to encode/decode content (preserves newlines and special chars)
-const encodeContent = (content) => Buffer.from(content || '').toString('base64');
-const decodeContent = (encoded) => Buffer.from(encoded || '', 'base64').toString('utf8');
+// Content is stored as is - the binary protocol of WebClient carries newlines and special chars,
+// and the C++ server can search it (see SearchController)
+const contentText = (content) => String(content || '');
 
 exports.getPermissionsByFileID = (req, res) => {
     const fileID = parseInt(req.params.fileID);
@@ -37,11 +37,9 @@ exports.createFile = async (req, res) => {
     const storageNameOfFile = `${ownerOfFileID}_${Date.now()}_${nameOfFile}`;
     
     try {
-        // Encode content to Base64 to preserve newlines and special characters
-        const encodedContent = encodeContent(content);
-        const sendResponse = await WebClient.send('POST ' + storageNameOfFile + ' ' + encodedContent);
+        const sendResponse = await WebClient.request('POST', storageNameOfFile + ' ' + contentText(content));
         
-        if (sendResponse && sendResponse.includes('201')) {
+        if (sendResponse.status === 201) {
             const newFile = fileInfo.create(nameOfFile, storageNameOfFile, ownerOfFileID, isDir, parentID);
             permissionObject.create(newFile.FID, ownerOfFileID, 'edit');
             // only return relevant info: name, FID, isDir, ownerID
@@ -84,19 +82,17 @@ exports.updateFile = (req, res) => {
 
     // Update file content if provided (check for undefined, not falsy, to allow empty content)
     if (newContent !== undefined) {
-        // Encode content to Base64 to preserve newlines and special characters
-        const encodedContent = encodeContent(newContent);
         // delete the old file, and create a new one with the same everything except content
         WebClient.send('DELETE ' + updatedFile.storageNameOfFile)
         .then((deleteResponse) => {
             if (deleteResponse && deleteResponse.includes('204')) {
-                return WebClient.send('POST ' + updatedFile.storageNameOfFile + ' ' + encodedContent);
+                return WebClient.request('POST', updatedFile.storageNameOfFile + ' ' + contentText(newContent));
             } else {
                 throw new Error('Delete failed');
             }
         })
         .then((postResponse) => {
-            if (postResponse && postResponse.includes('201')) {
+            if (postResponse.status === 201) {
                 res.status(200).json({
                     FID: updatedFile.FID,
                     name: updatedFile.name,
@@ -174,13 +170,11 @@ exports.getFileContentByID = async (req, res) => {
     }
 
     try {
-        const fileContentResponse = await WebClient.send('GET ' + file.storageNameOfFile);
+        // the raw response data is the content, exactly as it was stored
+        const fileContentResponse = await WebClient.request('GET', file.storageNameOfFile);
 
-        if (fileContentResponse && fileContentResponse.includes("200")) {
-            // remove the status line from the response
-            const encodedContent = fileContentResponse.split('\n').slice(1).join('');
-            // Decode from Base64 to restore original content with newlines
-            const content = decodeContent(encodedContent);
+        if (fileContentResponse.status === 200) {
+            const content = fileContentResponse.data.toString('utf8');
             res.status(200).json({ content });
         } else {
             res.status(500).json({ message: 'Error retrieving file content from WebClient' });
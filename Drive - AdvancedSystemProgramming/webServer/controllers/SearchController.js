@@ -11,6 +11,8 @@ exports.searchFiles = async (req, res) => {
     }
 
     const resultFiles = [];
+    // accessible files whose name does not match - their content is checked
+    const filesToCheck = [];
     
     try {
         // Iterate over ALL files to find ones the user has access to
@@ -36,18 +38,17 @@ exports.searchFiles = async (req, res) => {
                     resultFiles.push(file);
                     continue; // Already found, skip content check
                 }
-                
-                // Check file content using WebClient
-                const fileContentResponse = await WebClient.send('GET ' + file.storageNameOfFile);
-                
-                if (fileContentResponse && fileContentResponse.includes('200')) { 
-                    const content = fileContentResponse.split('\n').slice(1).join(''); 
-                    
-                    if (content.includes(query)) {
-                        if (!resultFiles.some(f => f.FID === file.FID)) { // avoid duplicates
-                            resultFiles.push(file);
-                        }
-                    }
+                filesToCheck.push(file);
+            }
+        }
+
+        // Check file content using WebClient - the C++ server searches the content of exactly these files
+        // and sends back only the names that match
+        if (filesToCheck.length > 0) {
+            const matches = new Set(await WebClient.searchIn(filesToCheck.map(file => file.storageNameOfFile), query));
+            for (const file of filesToCheck) {
+                if (matches.has(file.storageNameOfFile)) {
+                    resultFiles.push(file);
                 }
             }
         }
@@ -1,127 +1,275 @@
 const net = require('net');
 
+// v2 protocol of the C++ server: every request and response is a 20 bytes header and a raw body.
+// header (big endian): magic u32 | opcode u8 | flags u8 | status u16 | requestId u32 | bodyLength u64
+const HEADER_SIZE = 20;
+const MAGIC = 0x44525632; // "DRV2"
+const FLAG_MORE = 0x01;       // response: more frames of this response follow
+const FLAG_CONCURRENT = 0x02; // request: may run concurrently, its response may come out of order
+const OPCODES = { post: 1, get: 2, search: 3, delete: 4, list: 5, mget: 6, mexists: 7, mdelete: 8, stats: 9 };
+const MAX_BATCH_ITEMS = 10000; // names the server takes in one batch request (or one scoped search)
+const STATUS_LINES = {
+    200: '200 Ok',
+    201: '201 Created',
+    204: '204 No Content',
+    206: '206 Partial Content',
+    400: '400 Bad Request',
+    404: '404 Not Found',
+    500: '500 Internal Server Error',
+};
+
 class WebClient {
     constructor() {
         this.serverHost = 'server';  // Docker service name for C++ server
         this.serverPort = 8080;      // Port where C++ server listens
+        // Unix domain socket of the C++ server, when both servers run on the same host (skips the TCP stack)
+        this.serverSocketPath = process.env.UNIX_SOCKET_PATH;
 
         this.client = new net.Socket();
         this.isConnected = false;
+        this.isConnecting = false;
+
+        // Frames of requests made while the connection is (re)opened, sent once it is up.
+        // e.g. the server closes an idle connection (IDLE_TIMEOUT_MS), the next user action reconnects
+        this.unsent = [];
 
-        // Request queue to prevent concurrent requests from interfering with each other
-        this.requestQueue = [];
-        this.isProcessing = false;
+        // Requests that were sent to the server and wait for their response, by request id.
+        // Every request carries its id and the server answers them as they finish (not in order),
+        // so many users can have requests in flight on the one connection.
+        this.pending = new Map();
+        this.nextRequestId = 1;
+
+        // Bytes received that do not form a full frame yet
+        this.buffer = Buffer.alloc(0);
 
         this.connect();
     }
 
     connect() {
-        this.client.connect(this.serverPort, this.serverHost, () => {
-            this.isConnected = true;
+        this.open();
+
+        // ON DATA: TCP streams may split (or join) frames, so we accumulate chunks
+        // and hand out every full response to the request it belongs to.
+        this.client.on('data', (chunk) => {
+            this.buffer = Buffer.concat([this.buffer, chunk]);
+            this.processResponses();
         });
 
         this.client.on('error', (err) => {
             console.error('Connection error:', err.message); // DEBUG
             this.isConnected = false;
+            this.isConnecting = false;
+            this.failPending(err);
         });
 
         this.client.on('close', () => {
             this.isConnected = false;
+            this.isConnecting = false;
+            // e.g. the server closed an idle connection, a part of a frame will never be completed
+            this.buffer = Buffer.alloc(0);
+            this.failPending(new Error("500 Internal Server Error: C++ Server disconnected"));
         });
     }
 
+    /**
+     * Opens the connection to the C++ server (again, after it was closed), unless it is being opened already
+     */
+    open() {
+        if (this.isConnecting) {
+            return;
+        }
+        this.isConnecting = true;
+        const onConnect = () => {
+            this.isConnected = true;
+            this.isConnecting = false;
+            // SEND: the requests that waited for the connection, in the order they were made
+            const unsent = this.unsent;
+            this.unsent = [];
+            for (const frame of unsent) {
+                this.client.write(frame);
+            }
+        };
+        if (this.serverSocketPath) {
+            this.client.connect(this.serverSocketPath, onConnect);
+        } else {
+            this.client.connect(this.serverPort, this.serverHost, onConnect);
+        }
+    }
+
     /**
      * Sends a command to the C++ server and returns the response as a Promise.
-     * Requests are queued to prevent responses from getting mixed up between users.
-     * @param {string} command
+     * The response has the same shape as in the text protocol (status line, then the data).
+     * @param {string} command - e.g. 'GET <name>', 'POST <name> <content>'
      * @returns {Promise<string>}
      */
     send(command) {
-        return new Promise((resolve, reject) => {
-            // Add request to queue
-            this.requestQueue.push({ command, resolve, reject });
-
-            // Process queue if not already processing
-            this.processQueue();
-        });
+        // the first word is the command, the rest is sent as the body
+        const space = command.indexOf(' ');
+        const name = space === -1 ? command : command.substring(0, space);
+        const body = space === -1 ? '' : command.substring(space + 1);
+        return this.request(name, body).then(({ status, data }) => formatResponse(status, data.toString('utf8')));
     }
 
     /**
-     * Processes requests one at a time to prevent response mixing
+     * Runs a batch command ('mget', 'mexists' or 'mdelete') over many names with one round trip per
+     * MAX_BATCH_ITEMS names. The server runs the items in parallel.
+     * @param {string} command
+     * @param {string[]} names
+     * @returns {Promise<{status: number, name: string, data: string}[]>} one item per name, in order
      */
-    processQueue() {
-        // If already processing or queue is empty, do nothing
-        if (this.isProcessing || this.requestQueue.length === 0) {
-            return;
+    async batch(command, names) {
+        const requests = [];
+        for (let i = 0; i < names.length; i += MAX_BATCH_ITEMS) {
+            requests.push(this.request(command, names.slice(i, i + MAX_BATCH_ITEMS).join(' ')));
         }
+        const items = [];
+        for (const { status, data } of await Promise.all(requests)) {
+            if (status !== 200) {
+                throw new Error(formatResponse(status, ''));
+            }
+            items.push(...parseBatchItems(data));
+        }
+        return items;
+    }
 
-        this.isProcessing = true;
-        const { command, resolve, reject } = this.requestQueue.shift();
-
-        if (!this.isConnected) {
-            this.client.connect(this.serverPort, this.serverHost);
-            this.isProcessing = false;
-            reject(new Error("500 Internal Server Error: C++ Server disconnected"));
-            // Try next request in queue
-            this.processQueue();
-            return;
+    /**
+     * Searches the content of the given files only, on the C++ server.
+     * @param {string[]} names - storage names of the files to check
+     * @param {string} query - the substring to find
+     * @returns {Promise<string[]>} the names whose content contains the query, in the order of names
+     */
+    async searchIn(names, query) {
+        const requests = [];
+        for (let i = 0; i < names.length; i += MAX_BATCH_ITEMS) {
+            const scope = names.slice(i, i + MAX_BATCH_ITEMS);
+            requests.push(this.request('search', `in=${scope.length} ${scope.join(' ')} ${query}`));
         }
+        const matches = [];
+        for (const { status, data } of await Promise.all(requests)) {
+            // 206 - the time budget of the search ran out, the matches found so far are still right
+            if (status !== 200 && status !== 206) {
+                throw new Error(formatResponse(status, ''));
+            }
+            matches.push(...data.toString('utf8').split(' ').filter(name => name.length > 0));
+        }
+        return matches;
+    }
+
+    /**
+     * Sends a request and resolves with its status and raw data
+     * @param {string} command - the command name (not case sensitive)
+     * @param {string} body - the arguments of the command
+     * @returns {Promise<{status: number, data: Buffer}>}
+     */
+    request(command, body) {
+        return new Promise((resolve, reject) => {
+            const opcode = OPCODES[command.toLowerCase()];
+            if (opcode === undefined) {
+                resolve({ status: 400, data: Buffer.alloc(0) });
+                return;
+            }
+            const bodyBuffer = Buffer.from(body, 'utf8');
 
-        let buffer = Buffer.alloc(0);
-        let expectedLength = 0;
+            const requestId = this.nextRequestId;
+            this.nextRequestId = (this.nextRequestId % 0xFFFFFFFF) + 1;
+            this.pending.set(requestId, { resolve, reject, data: [] });
 
-        // ON DATA: This is the callback function that handles incoming data chunks.
-        // TCP streams may split data, so we accumulate chunks until we have the full message.
-        const onData = (chunk) => {
-            buffer = Buffer.concat([buffer, chunk]);
+            const header = Buffer.alloc(HEADER_SIZE);
+            header.writeUInt32BE(MAGIC, 0);
+            header.writeUInt8(opcode, 4);
+            header.writeUInt8(FLAG_CONCURRENT, 5);
+            header.writeUInt16BE(0, 6);
+            header.writeUInt32BE(requestId, 8);
+            header.writeBigUInt64BE(BigInt(bodyBuffer.length), 12);
 
-            // Parse Header: First 8 bytes indicate the total message length.
-            if (expectedLength === 0 && buffer.length >= 8) {
-                const header = buffer.toString('utf8', 0, 8);
-                expectedLength = parseInt(header.trim());
+            const frame = Buffer.concat([header, bodyBuffer]);
+            if (!this.isConnected) {
+                // the connection is closed (e.g. the server reaped it while idle) - reconnect, then send it
+                this.unsent.push(frame);
+                this.open();
+                return;
             }
 
-            // Full Message Received: If buffer contains header + content, we are done.
-            if (expectedLength !== 0 && buffer.length >= 8 + expectedLength) {
-                const response = buffer.toString('utf8', 8, 8 + expectedLength);
-
-                cleanup();
+            // WRITE: Physically sends the request to the C++ server.
+            this.client.write(frame);
+        });
+    }
 
-                // RESOLVE: Fulfills the Promise and sends the response back to the Controller.
-                resolve(response);
+    /**
+     * Takes every complete frame out of the buffer and resolves the request it answers
+     */
+    processResponses() {
+        while (this.buffer.length >= HEADER_SIZE) {
+            const bodyLength = Number(this.buffer.readBigUInt64BE(12));
+            if (this.buffer.length < HEADER_SIZE + bodyLength) {
+                return; // wait for the rest of this frame
+            }
+            const flags = this.buffer.readUInt8(5);
+            const status = this.buffer.readUInt16BE(6);
+            const requestId = this.buffer.readUInt32BE(8);
+            const body = this.buffer.subarray(HEADER_SIZE, HEADER_SIZE + bodyLength);
+            this.buffer = this.buffer.subarray(HEADER_SIZE + bodyLength);
 
-                // Process next request in queue
-                this.isProcessing = false;
-                this.processQueue();
+            const request = this.pending.get(requestId);
+            if (!request) {
+                continue;
             }
-        };
+            // data of a streamed command comes in frames before the final one
+            request.data.push(body);
+            if (flags & FLAG_MORE) {
+                continue;
+            }
+            this.pending.delete(requestId);
 
-        const onError = (err) => {
-            cleanup();
-            reject(err);
+            // RESOLVE: Fulfills the Promise and sends the response back to the Controller.
+            request.resolve({ status, data: Buffer.concat(request.data) });
+        }
+    }
 
-            // Process next request in queue
-            this.isProcessing = false;
-            this.processQueue();
-        };
+    /**
+     * Rejects every request that is still waiting for a response or for the connection (the connection is gone,
+     * or could not be opened)
+     */
+    failPending(err) {
+        const pending = this.pending;
+        this.pending = new Map();
+        this.buffer = Buffer.alloc(0);
+        this.unsent = []; // their requests are rejected below, they must not be sent later
+        for (const request of pending.values()) {
+            request.reject(err);
+        }
+    }
+}
 
-        const cleanup = () => {
-            this.client.removeListener('data', onData);
-            this.client.removeListener('error', onError);
-        };
+/**
+ * Builds the response the way the text protocol shows it, so the controllers do not depend on the framing
+ */
+function formatResponse(status, data) {
+    let response = STATUS_LINES[status] || String(status);
+    if (status === 200 || status === 206) {
+        response += '\n\n' + data;
+    }
+    if (!response.endsWith('\n')) {
+        response += '\n';
+    }
+    return response;
+}
 
-        // EVENT REGISTRATION:
-        // We MUST register the listeners BEFORE writing data.
-        // 'on' keeps listening for chunks. 'once' listens for a single error event.
-        this.client.on('data', onData);
-        this.client.once('error', onError);
-
-        // WRITE: Physically sends the command string to the C++ server.
-        // Why is this at the end?
-        // Because code runs synchronously. We must set up the listeners ("this.client.on('data', ...)")
-        // before we send data.
-        this.client.write(command + '\n');
+/**
+ * Splits the data of a batch command into its items. every item is "<status> <name> <length>\n<data>\n"
+ */
+function parseBatchItems(data) {
+    const items = [];
+    let position = 0;
+    while (position < data.length) {
+        const lineEnd = data.indexOf('\n', position);
+        const [status, name, length] = data.toString('utf8', position, lineEnd).split(' ');
+        const start = lineEnd + 1;
+        const end = start + parseInt(length);
+        items.push({ status: parseInt(status), name, data: data.toString('utf8', start, end) });
+        position = end + 1;
     }
+    return items;
 }
 
 module.exports = new WebClient();